@@ -0,0 +1,217 @@
+// bench/AllocationCheck.cpp
+// 分配计数模式: 重载全局operator new(glibc下同时拦截malloc系列,
+// 因为Qt的容器直接调用malloc).在offscreen平台上创建真实的WeatherService与
+// WeatherWidget,预热后反复把解码好的快照交给服务,走完
+// "快照 -> 天气数据 -> 标签文本 -> 趋势图增量重画"的整条刷新路径,
+// 每次刷新后都在计数期间处理事件,完整走一遍"刷新 -> 事件循环 -> 绘制".
+// 从计数中扣除、单独统计的只有下面两类Qt内部分配:
+//  1. UpdateRequest/LayoutRequest事件对象本身: QWidget::update()与布局失效
+//     经QCoreApplication::postEvent投递,事件必须在堆上,每次投递都新分配;
+//  2. 分发这两类事件期间的分配: 后备存储同步、每个paintEvent里QPainter的
+//     私有数据与状态、脏区域QRegion,以及布局激活.
+// 刷新槽、趋势图的增量重画(在addSample里完成)和事件循环的其余部分
+// 只要出现一次堆分配就以非零值退出;计数期间趋势图没有收到绘制事件也算失败.
+#include <QApplication>
+#include <QDateTime>
+#include <QStringList>
+#include <QTextStream>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "core/WeatherSnapshot.h"
+#include "services/WeatherService.h"
+#include "ui/SparklineWidget.h"
+#include "ui/WeatherWidget.h"
+
+namespace {
+std::atomic<bool> g_counting(false);
+std::atomic<long> g_allocations(0);
+// 扣除的Qt内部分配: 投递的事件对象 / 分发这些事件期间的分配
+std::atomic<long> g_excludedEvents(0);
+std::atomic<long> g_excludedDispatch(0);
+std::atomic<int> g_excludedDepth(0);
+std::atomic<long> g_sparklinePaints(0);
+
+// 计数期间最近的几次分配,用来认出随后分发的事件对象
+const int kRecentCount = 64;
+void* g_recent[kRecentCount];
+int g_recentNext = 0;
+
+inline void countAllocation(void* p) {
+  if (!g_counting.load(std::memory_order_relaxed)) return;
+  if (g_excludedDepth.load(std::memory_order_relaxed) > 0) {
+    g_excludedDispatch.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  g_recent[g_recentNext] = p;
+  g_recentNext = (g_recentNext + 1) % kRecentCount;
+}
+
+bool takeRecent(const void* p) {
+  for (void*& recent : g_recent) {
+    if (recent == p) {
+      recent = nullptr;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool isExcludedEvent(QEvent::Type type) {
+  return type == QEvent::UpdateRequest || type == QEvent::LayoutRequest;
+}
+
+// 按上面列出的两类扣除Qt内部分配,并统计趋势图收到的绘制事件
+class CountingApplication : public QApplication {
+ public:
+  CountingApplication(int& argc, char** argv) : QApplication(argc, argv) {}
+
+  bool notify(QObject* receiver, QEvent* event) override {
+    if (!g_counting.load(std::memory_order_relaxed))
+      return QApplication::notify(receiver, event);
+    if (event->type() == QEvent::Paint &&
+        qobject_cast<SparklineWidget*>(receiver))
+      g_sparklinePaints.fetch_add(1, std::memory_order_relaxed);
+    if (!isExcludedEvent(event->type()))
+      return QApplication::notify(receiver, event);
+
+    if (g_excludedDepth.load() == 0 && takeRecent(event)) {
+      g_allocations.fetch_sub(1, std::memory_order_relaxed);
+      g_excludedEvents.fetch_add(1, std::memory_order_relaxed);
+    }
+    g_excludedDepth.fetch_add(1);
+    const bool handled = QApplication::notify(receiver, event);
+    g_excludedDepth.fetch_sub(1);
+    return handled;
+  }
+};
+}  // namespace
+
+#if defined(__GLIBC__)
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+
+void* malloc(size_t size) {
+  void* p = __libc_malloc(size);
+  countAllocation(p);
+  return p;
+}
+void* calloc(size_t count, size_t size) {
+  void* p = __libc_calloc(count, size);
+  countAllocation(p);
+  return p;
+}
+void* realloc(void* ptr, size_t size) {
+  void* p = __libc_realloc(ptr, size);
+  countAllocation(p);
+  return p;
+}
+}
+#endif
+
+void* operator new(std::size_t size) {
+  void* p = std::malloc(size ? size : 1);
+  if (!p) throw std::bad_alloc();
+#if !defined(__GLIBC__)
+  countAllocation(p);
+#endif
+  return p;
+}
+void* operator new[](std::size_t size) { return ::operator new(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+int main(int argc, char* argv[]) {
+  // 没有显示服务器时也能创建控件
+  if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+  CountingApplication app(argc, argv);
+  QTextStream out(stdout);
+
+  const int refreshCount = argc > 1 ? QString(argv[1]).toInt() : 100000;
+
+  // 快照按解码端的形态准备好,城市名/天气文本与缓存共享.
+  // 当前城市(北京)的天气都属于"雨"类,样式表保持不变;
+  // 温度与风速在0.5以内波动,趋势图始终落在纵轴范围内,一直走增量重画
+  const QStringList cities = {"北京", "上海", "广州", "深圳"};
+  const QStringList rainy = {"小雨", "中雨", "大雨", "雷阵雨"};
+  const QStringList conditions = {"晴朗", "小雨", "阵雪", "多云"};
+  const qint64 now = QDateTime::currentSecsSinceEpoch();
+  QVector<WeatherSnapshot> snapshots;
+  for (int i = 0; i < 64; ++i) {
+    WeatherSnapshot s;
+    s.cityName = cities.at(i % cities.size());
+    if (i % cities.size() == 0) {
+      s.temperature = 20.0 + (i / cities.size() % 8) * 0.05;
+      s.windSpeed = 3.0 + (i / cities.size() % 5) * 0.1;
+      s.weatherCondition = rainy.at(i / cities.size() % rainy.size());
+    } else {
+      s.temperature = -5.0 + i * 0.7;
+      s.windSpeed = 0.5 * (i % 20);
+      s.weatherCondition = conditions.at(i % conditions.size());
+    }
+    s.humidity = 30 + i % 50;
+    s.lastUpdatedSecs = now;
+    snapshots.append(s);
+  }
+
+  WeatherService service;
+  WeatherWidget widget;
+  widget.setWeatherService(&service);
+
+  // 缓存各城市的快照,再像用户选择城市那样命中缓存,确定当前城市
+  for (int i = 0; i < cities.size(); ++i) service.applySnapshot(snapshots.at(i));
+  service.fetchWeather(cities.at(0));
+
+  widget.resize(480, 360);
+  widget.show();
+  QApplication::processEvents();
+  // 强制绘制一次,让当前城市的趋势图建立缓存
+  widget.grab();
+
+  // 每次刷新的快照更新时间都向前推进,趋势图才会追加样本;
+  // 刷新后处理事件,投递的重绘/布局请求在本轮就执行
+  qint64 tick = now;
+  auto refresh = [&](int i) {
+    WeatherSnapshot& snapshot = snapshots[i % snapshots.size()];
+    snapshot.lastUpdatedSecs = ++tick;
+    service.applySnapshot(snapshot);
+    QApplication::processEvents();
+  };
+
+  // 预热: 建表、时区数据、缓冲区与事件队列的容量
+  for (int round = 0; round < 2; ++round)
+    for (int i = 0; i < snapshots.size(); ++i) refresh(i);
+
+  g_counting = true;
+  for (int i = 0; i < refreshCount; ++i) refresh(i);
+  g_counting = false;
+
+  // 当前城市每cities.size()次刷新一次,每次都应重画它的趋势图
+  const long currentCityRefreshes =
+      (refreshCount + cities.size() - 1) / cities.size();
+  const long allocations = g_allocations.load();
+  const long paints = g_sparklinePaints.load();
+  out << QString("刷新 %1 次, 堆分配 %2 次, 趋势图绘制 %3 次\n")
+             .arg(refreshCount)
+             .arg(allocations)
+             .arg(paints);
+  out << QString("扣除的Qt内部分配: 投递的UpdateRequest/LayoutRequest %1 次, "
+                 "分发它们期间 %2 次\n")
+             .arg(g_excludedEvents.load())
+             .arg(g_excludedDispatch.load());
+  if (paints < currentCityRefreshes) {
+    out << QString("当前城市刷新 %1 次, 趋势图只绘制了 %2 次\n")
+               .arg(currentCityRefreshes)
+               .arg(paints);
+    return 1;
+  }
+  return allocations == 0 ? 0 : 1;
+}
@@ -0,0 +1,192 @@
+// bench/WeatherCodecBench.cpp
+// 比较CBOR快照帧与JSON在体积和编解码耗时上的差异.
+// 每一帧的解码结果都与编码时的输入逐城市比较,不一致时以非零值退出
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRandomGenerator>
+#include <QTextStream>
+
+#include "core/WeatherCodec.h"
+
+namespace {
+
+const QStringList kConditions = {"晴朗", "多云", "阴天", "小雨",   "中雨",
+                                 "大雨", "阵雪", "雾",   "雷阵雨", "晴转多云"};
+
+QVector<WeatherSnapshot> makeCities(int count, qint64 now) {
+  QRandomGenerator random(42);
+  QVector<WeatherSnapshot> cities;
+  cities.reserve(count);
+  for (int i = 0; i < count; ++i) {
+    WeatherSnapshot s;
+    s.cityName = QString("城市%1").arg(i);
+    s.temperature = 10 + random.bounded(20);
+    s.humidity = 30 + random.bounded(50);
+    s.windSpeed = 1 + random.bounded(10);
+    s.weatherCondition = kConditions.at(random.bounded(kConditions.size()));
+    s.lastUpdatedSecs = now;
+    cities.append(s);
+  }
+  return cities;
+}
+
+// 模拟一次刷新:约十分之一的城市温度和更新时间发生变化
+void mutate(QVector<WeatherSnapshot>* cities, QRandomGenerator* random,
+            qint64 now) {
+  for (WeatherSnapshot& s : *cities) {
+    if (random->bounded(10) != 0) continue;
+    s.temperature += random->bounded(3) - 1;
+    s.lastUpdatedSecs = now;
+  }
+}
+
+QByteArray encodeJson(const QVector<WeatherSnapshot>& cities) {
+  QJsonArray array;
+  for (const WeatherSnapshot& s : cities) {
+    QJsonObject object;
+    object["city"] = s.cityName;
+    object["temperature"] = s.temperature;
+    object["humidity"] = s.humidity;
+    object["windSpeed"] = s.windSpeed;
+    object["condition"] = s.weatherCondition;
+    object["updated"] = s.lastUpdatedSecs;
+    array.append(object);
+  }
+  return QJsonDocument(array).toJson(QJsonDocument::Compact);
+}
+
+QVector<WeatherSnapshot> decodeJson(const QByteArray& data) {
+  QVector<WeatherSnapshot> cities;
+  const QJsonArray array = QJsonDocument::fromJson(data).array();
+  cities.reserve(array.size());
+  for (const QJsonValue& value : array) {
+    const QJsonObject object = value.toObject();
+    WeatherSnapshot s;
+    s.cityName = object["city"].toString();
+    s.temperature = object["temperature"].toDouble();
+    s.humidity = object["humidity"].toInt();
+    s.windSpeed = object["windSpeed"].toDouble();
+    s.weatherCondition = object["condition"].toString();
+    s.lastUpdatedSecs = qint64(object["updated"].toDouble());
+    cities.append(s);
+  }
+  return cities;
+}
+
+// 解码结果与编码输入逐城市比较;温度、风速按线格式的0.1精度比较
+bool sameSnapshots(const QVector<WeatherSnapshot>& expected,
+                   const QVector<WeatherSnapshot>& actual, QString* error) {
+  if (expected.size() != actual.size()) {
+    *error = QString("城市数 %1, 期望 %2").arg(actual.size()).arg(expected.size());
+    return false;
+  }
+  for (int i = 0; i < expected.size(); ++i) {
+    const WeatherSnapshot& e = expected.at(i);
+    const WeatherSnapshot& a = actual.at(i);
+    if (a.cityName != e.cityName ||
+        qRound64(a.temperature * 10) != qRound64(e.temperature * 10) ||
+        a.humidity != e.humidity ||
+        qRound64(a.windSpeed * 10) != qRound64(e.windSpeed * 10) ||
+        a.weatherCondition != e.weatherCondition ||
+        a.lastUpdatedSecs != e.lastUpdatedSecs) {
+      *error = QString("第%1个城市(%2)与输入不一致").arg(i).arg(e.cityName);
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  QCoreApplication app(argc, argv);
+  QTextStream out(stdout);
+
+  const int cityCount = argc > 1 ? QString(argv[1]).toInt() : 1000;
+  const int frameCount = argc > 2 ? QString(argv[2]).toInt() : 200;
+
+  qint64 now = 1700000000;
+  QRandomGenerator random(7);
+  QVector<WeatherSnapshot> cities = makeCities(cityCount, now);
+
+  // 预先生成全部帧,编码/解码分开计时
+  QVector<QByteArray> jsonFrames, keyFrames, deltaFrames;
+  QVector<QVector<WeatherSnapshot>> inputs;
+  WeatherCodec keyEncoder, deltaEncoder;
+  QElapsedTimer timer;
+  qint64 jsonEncodeNs = 0, keyEncodeNs = 0, deltaEncodeNs = 0;
+  for (int f = 0; f < frameCount; ++f) {
+    timer.start();
+    jsonFrames.append(encodeJson(cities));
+    jsonEncodeNs += timer.nsecsElapsed();
+
+    timer.start();
+    keyFrames.append(keyEncoder.encode(cities, WeatherCodec::KeyFrame));
+    keyEncodeNs += timer.nsecsElapsed();
+
+    timer.start();
+    deltaFrames.append(deltaEncoder.encode(cities, WeatherCodec::DeltaFrame));
+    deltaEncodeNs += timer.nsecsElapsed();
+
+    inputs.append(cities);
+    now += 60;
+    mutate(&cities, &random, now);
+  }
+
+  QVector<WeatherSnapshot> decoded;
+  qint64 jsonDecodeNs = 0, keyDecodeNs = 0, deltaDecodeNs = 0;
+  qint64 jsonBytes = 0, keyBytes = 0, deltaBytes = 0;
+  WeatherCodec keyDecoder, deltaDecoder;
+  QString error;
+  // 计时之外检查往返结果
+  auto check = [&](const char* name, int frame, bool ok,
+                   const WeatherCodec* decoder) {
+    if (!ok) error = decoder->errorString();
+    if (ok && sameSnapshots(inputs.at(frame), decoded, &error)) return true;
+    out << QString("%1 第%2帧往返失败: %3\n").arg(name).arg(frame).arg(error);
+    return false;
+  };
+  for (int f = 0; f < frameCount; ++f) {
+    timer.start();
+    decoded = decodeJson(jsonFrames.at(f));
+    jsonDecodeNs += timer.nsecsElapsed();
+    if (!check("json", f, true, nullptr)) return 1;
+
+    timer.start();
+    bool ok = keyDecoder.decode(keyFrames.at(f), &decoded);
+    keyDecodeNs += timer.nsecsElapsed();
+    if (!check("cbor-key", f, ok, &keyDecoder)) return 1;
+
+    timer.start();
+    ok = deltaDecoder.decode(deltaFrames.at(f), &decoded);
+    deltaDecodeNs += timer.nsecsElapsed();
+    if (!check("cbor-delta", f, ok, &deltaDecoder)) return 1;
+
+    jsonBytes += jsonFrames.at(f).size();
+    keyBytes += keyFrames.at(f).size();
+    deltaBytes += deltaFrames.at(f).size();
+  }
+
+  auto row = [&](const char* name, qint64 bytes, qint64 encNs, qint64 decNs) {
+    out << QString("%1 %2 %3 %4 %5\n")
+               .arg(name, -10)
+               .arg(double(bytes) / frameCount, 12, 'f', 0)
+               .arg(double(jsonBytes) / bytes, 8, 'f', 2)
+               .arg(encNs / 1000.0 / frameCount, 12, 'f', 1)
+               .arg(decNs / 1000.0 / frameCount, 12, 'f', 1);
+  };
+  out << QString("城市数 %1, 帧数 %2\n").arg(cityCount).arg(frameCount);
+  out << QString("%1 %2 %3 %4 %5\n")
+             .arg("format", -10)
+             .arg("bytes/frame", 12)
+             .arg("vs-json", 8)
+             .arg("encode(us)", 12)
+             .arg("decode(us)", 12);
+  row("json", jsonBytes, jsonEncodeNs, jsonDecodeNs);
+  row("cbor-key", keyBytes, keyEncodeNs, keyDecodeNs);
+  row("cbor-delta", deltaBytes, deltaEncodeNs, deltaDecodeNs);
+  return 0;
+}
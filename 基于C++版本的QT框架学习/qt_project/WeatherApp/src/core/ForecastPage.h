@@ -0,0 +1,34 @@
+#ifndef FORECASTPAGE_H
+#define FORECASTPAGE_H
+
+#include <QMetaType>
+#include <QString>
+#include <QVector>
+
+// 逐小时预报中的一个小时
+struct ForecastHour {
+  double temperature = 0.0;
+  int humidity = 0;
+  double windSpeed = 0.0;
+  QString weatherCondition;
+};
+
+// 逐小时预报按天分页: 第page页是预报起点之后第page天的24个小时
+struct ForecastPage {
+  static const int kHoursPerPage = 24;
+  static const int kMaxDays = 15;
+
+  // 预报起点为originSecs时第page页的起始时刻
+  static qint64 pageStart(qint64 originSecs, int page) {
+    return originSecs + qint64(page) * kHoursPerPage * 3600;
+  }
+
+  QString cityName;
+  int page = 0;
+  qint64 startSecs = 0;  // 本页第一个小时,自1970-01-01起的秒数(UTC)
+  QVector<ForecastHour> hours;
+};
+
+Q_DECLARE_METATYPE(ForecastPage)
+
+#endif  // FORECASTPAGE_H
@@ -0,0 +1,239 @@
+#include "WeatherCodec.h"
+
+#include <QCborStreamReader>
+#include <QCborStreamWriter>
+#include <QtMath>
+
+namespace {
+
+const qint64 kFormatVersion = 1;
+
+// 温度/风速按0.1精度量化
+qint64 quantize(double value) { return qRound64(value * 10.0); }
+double dequantize(qint64 value) { return value / 10.0; }
+
+// 把快照规整到线格式精度,保证编码端基线与解码端一致
+WeatherSnapshot normalized(const WeatherSnapshot& snapshot) {
+  WeatherSnapshot s = snapshot;
+  s.temperature = dequantize(quantize(s.temperature));
+  s.windSpeed = dequantize(quantize(s.windSpeed));
+  return s;
+}
+
+// 比较两个快照,返回变化字段的掩码(城市名不参与比较,由槽位确定)
+int changedFields(const WeatherSnapshot& before, const WeatherSnapshot& after) {
+  int mask = 0;
+  if (quantize(before.temperature) != quantize(after.temperature))
+    mask |= WeatherCodec::TemperatureField;
+  if (before.humidity != after.humidity) mask |= WeatherCodec::HumidityField;
+  if (quantize(before.windSpeed) != quantize(after.windSpeed))
+    mask |= WeatherCodec::WindSpeedField;
+  if (before.weatherCondition != after.weatherCondition)
+    mask |= WeatherCodec::ConditionField;
+  if (before.lastUpdatedSecs != after.lastUpdatedSecs)
+    mask |= WeatherCodec::UpdatedField;
+  return mask;
+}
+
+void writeFields(QCborStreamWriter& writer, const WeatherSnapshot& s,
+                 int mask, qint64 baseSecs) {
+  if (mask & WeatherCodec::CityField) writer.append(s.cityName);
+  if (mask & WeatherCodec::TemperatureField)
+    writer.append(quantize(s.temperature));
+  if (mask & WeatherCodec::HumidityField) writer.append(qint64(s.humidity));
+  if (mask & WeatherCodec::WindSpeedField) writer.append(quantize(s.windSpeed));
+  if (mask & WeatherCodec::ConditionField) writer.append(s.weatherCondition);
+  if (mask & WeatherCodec::UpdatedField)
+    writer.append(s.lastUpdatedSecs - baseSecs);
+}
+
+int fieldCount(int mask) {
+  int count = 0;
+  for (; mask; mask &= mask - 1) ++count;
+  return count;
+}
+
+bool readInteger(QCborStreamReader& reader, qint64* value) {
+  if (!reader.isInteger()) return false;
+  *value = reader.toInteger();
+  return reader.next();
+}
+
+bool readText(QCborStreamReader& reader, QString* text) {
+  if (!reader.isString()) return false;
+  text->clear();
+  auto chunk = reader.readString();
+  while (chunk.status == QCborStreamReader::Ok) {
+    text->append(chunk.data);
+    chunk = reader.readString();
+  }
+  return chunk.status == QCborStreamReader::EndOfString;
+}
+
+}  // namespace
+
+WeatherCodec::WeatherCodec() : m_sequence(0), m_hasBaseline(false) {}
+
+QByteArray WeatherCodec::encode(const QVector<WeatherSnapshot>& snapshots,
+                                FrameType type) {
+  // 没有基线时只能发关键帧
+  if (!m_hasBaseline) type = KeyFrame;
+
+  const qint64 baseSecs =
+      snapshots.isEmpty() ? 0 : snapshots.first().lastUpdatedSecs;
+
+  QByteArray frame;
+  QCborStreamWriter writer(&frame);
+  writer.startArray(5);
+  writer.append(kFormatVersion);
+  writer.append(qint64(type));
+  writer.append(qint64(++m_sequence));
+  writer.append(baseSecs);
+
+  if (type == KeyFrame) {
+    m_baseline.clear();
+    m_slots.clear();
+    writer.startArray(quint64(snapshots.size()));
+    for (const WeatherSnapshot& snapshot : snapshots) {
+      const WeatherSnapshot s = normalized(snapshot);
+      writer.startArray(fieldCount(AllFields));
+      writeFields(writer, s, AllFields, baseSecs);
+      writer.endArray();
+      m_slots.insert(s.cityName, m_baseline.size());
+      m_baseline.append(s);
+    }
+    writer.endArray();
+  } else {
+    // 记录数事先未知(未变化的城市不发送),使用不定长数组
+    writer.startArray();
+    for (const WeatherSnapshot& snapshot : snapshots) {
+      const WeatherSnapshot s = normalized(snapshot);
+      int slot = m_slots.value(s.cityName, -1);
+      int mask = AllFields;
+      if (slot < 0) {
+        slot = m_baseline.size();
+        m_slots.insert(s.cityName, slot);
+        m_baseline.append(s);
+      } else {
+        mask = changedFields(m_baseline.at(slot), s);
+        if (mask == 0) continue;
+        m_baseline[slot] = s;
+      }
+      writer.startArray(quint64(2 + fieldCount(mask)));
+      writer.append(qint64(slot));
+      writer.append(qint64(mask));
+      writeFields(writer, s, mask, baseSecs);
+      writer.endArray();
+    }
+    writer.endArray();
+  }
+  writer.endArray();
+
+  m_hasBaseline = true;
+  return frame;
+}
+
+bool WeatherCodec::decode(const QByteArray& frame,
+                          QVector<WeatherSnapshot>* out) {
+  QCborStreamReader reader(frame);
+  if (!reader.isArray() || !reader.enterContainer())
+    return fail("帧格式错误");
+
+  qint64 version = 0, type = 0, sequence = 0, baseSecs = 0;
+  if (!readInteger(reader, &version) || version != kFormatVersion)
+    return fail("不支持的帧版本");
+  if (!readInteger(reader, &type) || (type != KeyFrame && type != DeltaFrame))
+    return fail("未知的帧类型");
+  if (!readInteger(reader, &sequence) || !readInteger(reader, &baseSecs))
+    return fail("帧头不完整");
+
+  if (type == DeltaFrame &&
+      (!m_hasBaseline || quint32(sequence) != m_sequence + 1))
+    return fail("增量帧序号不连续,需要关键帧");
+
+  if (type == KeyFrame) {
+    m_baseline.clear();
+    m_slots.clear();
+  }
+
+  // 直接在基线上解码;中途出错时基线已不可信,由fail()清空
+  if (!reader.isArray() || !reader.enterContainer())
+    return fail("记录列表格式错误");
+  while (reader.hasNext()) {
+    if (!decodeRecord(reader, FrameType(type), baseSecs, &m_baseline))
+      return false;
+  }
+  if (!reader.leaveContainer() || !reader.leaveContainer() ||
+      reader.lastError() != QCborError::NoError)
+    return fail("帧数据损坏");
+
+  m_sequence = quint32(sequence);
+  m_hasBaseline = true;
+  if (out) *out = m_baseline;
+  return true;
+}
+
+bool WeatherCodec::decodeRecord(QCborStreamReader& reader, FrameType type,
+                                qint64 baseSecs,
+                                QVector<WeatherSnapshot>* baseline) {
+  if (!reader.isArray() || !reader.enterContainer())
+    return fail("记录格式错误");
+
+  qint64 mask = AllFields;
+  int slot = baseline->size();
+  if (type == DeltaFrame) {
+    qint64 wireSlot = 0;
+    if (!readInteger(reader, &wireSlot) || !readInteger(reader, &mask))
+      return fail("增量记录头不完整");
+    if (wireSlot < 0 || wireSlot > baseline->size() || (mask & ~AllFields))
+      return fail("增量记录槽位或掩码无效");
+    // 新增城市必须携带全部字段
+    if (wireSlot == baseline->size() && mask != AllFields)
+      return fail("新增城市缺少字段");
+    slot = int(wireSlot);
+  }
+  if (slot == baseline->size()) baseline->append(WeatherSnapshot());
+  WeatherSnapshot& s = (*baseline)[slot];
+
+  qint64 value = 0;
+  bool ok = true;
+  if (ok && (mask & CityField)) {
+    ok = readText(reader, &s.cityName);
+    if (ok) m_slots.insert(s.cityName, slot);
+  }
+  if (ok && (mask & TemperatureField)) {
+    ok = readInteger(reader, &value);
+    s.temperature = dequantize(value);
+  }
+  if (ok && (mask & HumidityField)) {
+    ok = readInteger(reader, &value);
+    s.humidity = int(value);
+  }
+  if (ok && (mask & WindSpeedField)) {
+    ok = readInteger(reader, &value);
+    s.windSpeed = dequantize(value);
+  }
+  if (ok && (mask & ConditionField)) ok = readText(reader, &s.weatherCondition);
+  if (ok && (mask & UpdatedField)) {
+    ok = readInteger(reader, &value);
+    s.lastUpdatedSecs = baseSecs + value;
+  }
+  if (!ok || reader.hasNext() || !reader.leaveContainer())
+    return fail("记录字段错误");
+  return true;
+}
+
+void WeatherCodec::reset() {
+  m_baseline.clear();
+  m_slots.clear();
+  m_sequence = 0;
+  m_hasBaseline = false;
+}
+
+QString WeatherCodec::errorString() const { return m_errorString; }
+
+bool WeatherCodec::fail(const QString& error) {
+  m_errorString = error;
+  reset();
+  return false;
+}
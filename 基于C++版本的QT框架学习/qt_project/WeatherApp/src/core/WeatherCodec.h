@@ -0,0 +1,65 @@
+#ifndef WEATHERCODEC_H
+#define WEATHERCODEC_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+#include "WeatherSnapshot.h"
+
+class QCborStreamReader;
+
+/**
+ * 多城市天气快照的二进制(CBOR)线格式
+ *
+ * 帧结构(全部为定长数组,不写字段名):
+ *   [版本, 帧类型, 序号, 基准时间(秒), [记录...]]
+ * 关键帧记录: [城市名, 温度*10, 湿度, 风速*10, 天气, 更新时间-基准时间]
+ * 增量帧记录: [槽位, 字段掩码, 变化的字段...]
+ *
+ * 槽位是城市在上一帧基线中的位置;槽位等于基线长度时表示新增城市.
+ * 温度和风速按0.1精度量化为整数,与界面显示精度一致.
+ * 编码端和解码端各自持有一个WeatherCodec实例,增量帧依赖双方基线一致.
+ */
+class WeatherCodec {
+ public:
+  enum FrameType { KeyFrame = 0, DeltaFrame = 1 };
+
+  enum Field {
+    CityField = 0x01,
+    TemperatureField = 0x02,
+    HumidityField = 0x04,
+    WindSpeedField = 0x08,
+    ConditionField = 0x10,
+    UpdatedField = 0x20,
+    AllFields = 0x3f
+  };
+
+  WeatherCodec();
+
+  // 编码一批快照;DeltaFrame只发送相对上一帧有变化的城市和字段
+  QByteArray encode(const QVector<WeatherSnapshot>& snapshots,
+                    FrameType type = DeltaFrame);
+
+  // 解码一帧并更新基线,out返回解码后的完整城市状态
+  bool decode(const QByteArray& frame, QVector<WeatherSnapshot>* out);
+
+  // 清空基线,下一帧必须是关键帧
+  void reset();
+
+  QString errorString() const;
+
+ private:
+  bool decodeRecord(QCborStreamReader& reader, FrameType type,
+                    qint64 baseSecs, QVector<WeatherSnapshot>* baseline);
+  bool fail(const QString& error);
+
+  QVector<WeatherSnapshot> m_baseline;
+  QHash<QString, int> m_slots;
+  quint32 m_sequence;
+  bool m_hasBaseline;
+  QString m_errorString;
+};
+
+#endif  // WEATHERCODEC_H
@@ -2,6 +2,8 @@
 
 #include <QDebug>
 
+#include "WeatherFormatter.h"
+
 WeatherData::WeatherData(QObject* parent)
     : QObject(parent), m_temperature(0.0), m_humidity(0), m_windSpeed(0.0) {
   m_lastUpdated = QDateTime::currentDateTime();
@@ -71,14 +73,46 @@ void WeatherData::reset() {
 
 // 转换为字符串
 QString WeatherData::toString() const {
-  return QString(
-             "城市: %1\n温度: %2摄氏度\n湿度: %3\n风速: %4km/h\n天气: "
-             "%5\n更新时间: "
-             "%6")
-      .arg(m_cityName)
-      .arg(m_temperature, 0, 'f', 1)
-      .arg(m_humidity)
-      .arg(m_windSpeed, 0, 'f', 1)
-      .arg(m_weatherCondition)
-      .arg(m_lastUpdated.toString("yyyy-MM-dd hh:mm:ss"));
+  QString text;
+  text.reserve(96);
+  toString(&text);
+  return text;
+}
+
+void WeatherData::toString(QString* out) const {
+  out->truncate(0);
+  out->append(QStringLiteral("城市: "));
+  out->append(m_cityName);
+  out->append(QStringLiteral("\n温度: "));
+  WeatherFormatter::appendFixed1(out, m_temperature);
+  out->append(QStringLiteral("摄氏度\n湿度: "));
+  WeatherFormatter::appendInt(out, m_humidity);
+  out->append(QStringLiteral("\n风速: "));
+  WeatherFormatter::appendFixed1(out, m_windSpeed);
+  out->append(QStringLiteral("km/h\n天气: "));
+  out->append(m_weatherCondition);
+  out->append(QStringLiteral("\n更新时间: "));
+  WeatherFormatter::appendDateTime(out, m_lastUpdated);
+}
+
+// 导出快照
+WeatherSnapshot WeatherData::snapshot() const {
+  WeatherSnapshot s;
+  s.cityName = m_cityName;
+  s.temperature = m_temperature;
+  s.humidity = m_humidity;
+  s.windSpeed = m_windSpeed;
+  s.weatherCondition = m_weatherCondition;
+  s.lastUpdatedSecs = m_lastUpdated.toSecsSinceEpoch();
+  return s;
+}
+
+// 应用快照(逐字段调用setter,未变化的字段不会发出信号)
+void WeatherData::applySnapshot(const WeatherSnapshot& snapshot) {
+  setCityName(snapshot.cityName);
+  setTemperature(snapshot.temperature);
+  setHumidity(snapshot.humidity);
+  setWindSpeed(snapshot.windSpeed);
+  setWeatherCondition(snapshot.weatherCondition);
+  setLastUpdated(QDateTime::fromSecsSinceEpoch(snapshot.lastUpdatedSecs));
 }
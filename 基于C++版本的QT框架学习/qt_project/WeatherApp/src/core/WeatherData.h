@@ -5,6 +5,8 @@
 #include <QObject>
 #include <QString>
 
+#include "WeatherSnapshot.h"
+
 class WeatherData : public QObject {
   Q_OBJECT
   Q_PROPERTY(
@@ -44,6 +46,12 @@ class WeatherData : public QObject {
 
   // 转换为字符串
   QString toString() const;
+  // 写入调用方复用的缓冲区(out容量足够时不分配内存)
+  void toString(QString* out) const;
+
+  // 与值类型快照互转(用于批量编码/传输)
+  WeatherSnapshot snapshot() const;
+  void applySnapshot(const WeatherSnapshot& snapshot);
 
  signals:
   void cityNameChanged();
@@ -0,0 +1,179 @@
+#include "WeatherFormatter.h"
+
+#include <QVector>
+#include <QtMath>
+
+namespace {
+
+// 预生成文本表的范围(按0.1精度量化后的整数)
+const int kMinTemperature = -800;  // -80.0°C
+const int kMaxTemperature = 700;   // 70.0°C
+const int kMaxWindSpeed = 3000;    // 300.0 km/h
+const int kMaxHumidity = 100;
+
+struct TextTables {
+  QVector<QString> temperature;
+  QVector<QString> humidity;
+  QVector<QString> windSpeed;
+};
+
+TextTables buildTables() {
+  TextTables tables;
+  tables.temperature.reserve(kMaxTemperature - kMinTemperature + 1);
+  for (int q = kMinTemperature; q <= kMaxTemperature; ++q) {
+    QString text;
+    WeatherFormatter::appendFixed1(&text, q / 10.0);
+    text.append(QStringLiteral("°C"));
+    tables.temperature.append(text);
+  }
+  tables.humidity.reserve(kMaxHumidity + 1);
+  for (int h = 0; h <= kMaxHumidity; ++h) {
+    QString text;
+    WeatherFormatter::appendInt(&text, h);
+    text.append(QLatin1Char('%'));
+    tables.humidity.append(text);
+  }
+  tables.windSpeed.reserve(kMaxWindSpeed + 1);
+  for (int q = 0; q <= kMaxWindSpeed; ++q) {
+    QString text;
+    WeatherFormatter::appendFixed1(&text, q / 10.0);
+    text.append(QStringLiteral(" km/h"));
+    tables.windSpeed.append(text);
+  }
+  return tables;
+}
+
+const TextTables& tables() {
+  static const TextTables instance = buildTables();
+  return instance;
+}
+
+void appendPadded(QString* out, int value, int width) {
+  char digits[12];
+  int pos = sizeof(digits);
+  do {
+    digits[--pos] = char('0' + value % 10);
+    value /= 10;
+  } while (value > 0 && pos > 0);
+  while (int(sizeof(digits)) - pos < width && pos > 0) digits[--pos] = '0';
+  out->append(QLatin1String(digits + pos, int(sizeof(digits)) - pos));
+}
+
+}  // namespace
+
+QString& WeatherFormatter::SpareBuffer::take() {
+  QString& buffer = text[next];
+  next ^= 1;
+  // 不共享时truncate保留原有容量
+  buffer.truncate(0);
+  return buffer;
+}
+
+WeatherFormatter::WeatherFormatter() : m_lastTimeSecs(-1) {
+  tables();
+  // 为时间缓冲区预留容量
+  for (QString& buffer : m_timeSpare.text) buffer.reserve(32);
+}
+
+const QString& WeatherFormatter::temperatureText(double celsius) {
+  const qint64 q = qRound64(celsius * 10.0);
+  if (q >= kMinTemperature && q <= kMaxTemperature)
+    return tables().temperature.at(int(q - kMinTemperature));
+
+  QString& text = m_temperatureSpare.take();
+  appendFixed1(&text, celsius);
+  text.append(QStringLiteral("°C"));
+  return text;
+}
+
+const QString& WeatherFormatter::humidityText(int humidity) {
+  if (humidity >= 0 && humidity <= kMaxHumidity)
+    return tables().humidity.at(humidity);
+
+  QString& text = m_humiditySpare.take();
+  appendInt(&text, humidity);
+  text.append(QLatin1Char('%'));
+  return text;
+}
+
+const QString& WeatherFormatter::windSpeedText(double kmh) {
+  const qint64 q = qRound64(kmh * 10.0);
+  if (q >= 0 && q <= kMaxWindSpeed) return tables().windSpeed.at(int(q));
+
+  QString& text = m_windSpare.take();
+  appendFixed1(&text, kmh);
+  text.append(QStringLiteral(" km/h"));
+  return text;
+}
+
+const QString& WeatherFormatter::timeText(const QDateTime& time) {
+  // 同一秒内重复刷新时直接返回上一次的文本
+  const qint64 secs = time.toSecsSinceEpoch();
+  if (secs == m_lastTimeSecs) return m_timeSpare.text[m_timeSpare.next ^ 1];
+
+  m_lastTimeSecs = secs;
+  QString& text = m_timeSpare.take();
+  appendDateTime(&text, time);
+  return text;
+}
+
+WeatherFormatter::ConditionStyle WeatherFormatter::conditionStyle(
+    const QString& condition) {
+  static const QString rain = QStringLiteral("雨");
+  static const QString sunny = QStringLiteral("晴");
+  static const QString snow = QStringLiteral("雪");
+
+  if (condition.contains(rain)) return RainStyle;
+  if (condition.contains(sunny)) return SunnyStyle;
+  if (condition.contains(snow)) return SnowStyle;
+  return PlainStyle;
+}
+
+const QString& WeatherFormatter::styleSheet(ConditionStyle style) {
+  static const QString sheets[] = {
+      QString(), QStringLiteral("color: blue; font-weight: bold;"),
+      QStringLiteral("color: orange; font-weight: bold;"),
+      QStringLiteral("color: gray; font-weight: bold;")};
+  return sheets[style];
+}
+
+void WeatherFormatter::appendFixed1(QString* out, double value) {
+  qint64 q = qRound64(value * 10.0);
+  if (q < 0) {
+    out->append(QLatin1Char('-'));
+    q = -q;
+  }
+  appendInt(out, q / 10);
+  out->append(QLatin1Char('.'));
+  out->append(QLatin1Char(char('0' + q % 10)));
+}
+
+void WeatherFormatter::appendInt(QString* out, qint64 value) {
+  char digits[24];
+  int pos = sizeof(digits);
+  const bool negative = value < 0;
+  quint64 magnitude = negative ? quint64(0) - quint64(value) : quint64(value);
+  do {
+    digits[--pos] = char('0' + magnitude % 10);
+    magnitude /= 10;
+  } while (magnitude > 0);
+  if (negative) digits[--pos] = '-';
+  out->append(QLatin1String(digits + pos, int(sizeof(digits)) - pos));
+}
+
+void WeatherFormatter::appendDateTime(QString* out, const QDateTime& time) {
+  // 等价于 toString("yyyy-MM-dd hh:mm:ss")
+  const QDate date = time.date();
+  const QTime clock = time.time();
+  appendPadded(out, date.year(), 4);
+  out->append(QLatin1Char('-'));
+  appendPadded(out, date.month(), 2);
+  out->append(QLatin1Char('-'));
+  appendPadded(out, date.day(), 2);
+  out->append(QLatin1Char(' '));
+  appendPadded(out, clock.hour(), 2);
+  out->append(QLatin1Char(':'));
+  appendPadded(out, clock.minute(), 2);
+  out->append(QLatin1Char(':'));
+  appendPadded(out, clock.second(), 2);
+}
@@ -0,0 +1,50 @@
+#ifndef WEATHERFORMATTER_H
+#define WEATHERFORMATTER_H
+
+#include <QDateTime>
+#include <QString>
+
+/**
+ * 天气数据的显示文本格式化
+ *
+ * 温度/湿度/风速的常用取值在首次构造时预先生成文本表(全局共享),
+ * 时间等无法查表的文本写入两个轮换使用的缓冲区: 界面持有其中一个的
+ * 浅拷贝时,另一个不被共享,可以原地改写而不触发分离拷贝.
+ * 预热之后,稳定刷新不再分配堆内存.
+ */
+class WeatherFormatter {
+ public:
+  enum ConditionStyle { PlainStyle, RainStyle, SunnyStyle, SnowStyle };
+
+  WeatherFormatter();
+
+  // 返回的引用在下一次同类调用前有效
+  const QString& temperatureText(double celsius);
+  const QString& humidityText(int humidity);
+  const QString& windSpeedText(double kmh);
+  const QString& timeText(const QDateTime& time);
+
+  static ConditionStyle conditionStyle(const QString& condition);
+  static const QString& styleSheet(ConditionStyle style);
+
+  // 追加到out末尾,out容量足够时不分配内存
+  static void appendFixed1(QString* out, double value);
+  static void appendInt(QString* out, qint64 value);
+  static void appendDateTime(QString* out, const QDateTime& time);
+
+ private:
+  // 两个轮换的缓冲区
+  struct SpareBuffer {
+    QString text[2];
+    int next = 0;
+    QString& take();
+  };
+
+  SpareBuffer m_temperatureSpare;
+  SpareBuffer m_humiditySpare;
+  SpareBuffer m_windSpare;
+  SpareBuffer m_timeSpare;
+  qint64 m_lastTimeSecs;
+};
+
+#endif  // WEATHERFORMATTER_H
@@ -0,0 +1,20 @@
+#ifndef WEATHERSNAPSHOT_H
+#define WEATHERSNAPSHOT_H
+
+#include <QMetaType>
+#include <QString>
+#include <QVector>
+
+// 单个城市天气的轻量值类型(不继承QObject,可批量拷贝/传输)
+struct WeatherSnapshot {
+  QString cityName;
+  double temperature = 0.0;
+  int humidity = 0;
+  double windSpeed = 0.0;
+  QString weatherCondition;
+  qint64 lastUpdatedSecs = 0;  // 自1970-01-01起的秒数(UTC)
+};
+
+Q_DECLARE_METATYPE(WeatherSnapshot)
+
+#endif  // WEATHERSNAPSHOT_H
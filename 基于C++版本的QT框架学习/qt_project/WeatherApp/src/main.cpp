@@ -1,9 +1,31 @@
 // src/main.cpp
 #include <QApplication>
+#include <QCommandLineParser>
 #include <QStyleFactory>
+#include <QTextStream>
+#include <QUrl>
 
+#include "services/WeatherProvider.h"
 #include "ui/MainWindow.h"
 
+namespace {
+// 由 "<json|cbor>:<url>" 创建数据源,格式不对时返回nullptr
+WeatherProvider* createProvider(const QString& spec, QString* error) {
+  const int colon = spec.indexOf(':');
+  const QString kind = spec.left(colon).toLower();
+  const QUrl url(spec.mid(colon + 1));
+  if (colon <= 0 || !url.isValid() || url.scheme().isEmpty()) {
+    *error = QString("数据源格式应为 <json|cbor>:<url>: %1").arg(spec);
+    return nullptr;
+  }
+  const QString name = QString("%1 %2").arg(kind, url.authority());
+  if (kind == "json") return new JsonWeatherProvider(name, url);
+  if (kind == "cbor") return new CborWeatherProvider(name, url);
+  *error = QString("未知的数据源类型: %1").arg(kind);
+  return nullptr;
+}
+}  // namespace
+
 int main(int argc, char* argv[]) {
   QApplication app(argc, argv);
 
@@ -12,12 +34,40 @@ int main(int argc, char* argv[]) {
   app.setApplicationVersion("1.0.0");
   app.setOrganizationName("WeatherAppOrg");
 
+  // 命令行: 按顺序注册天气数据源(第一个为主源,其余为对冲/故障转移的备用源)
+  QCommandLineParser parser;
+  parser.addHelpOption();
+  parser.addVersionOption();
+  const QCommandLineOption providerOption(
+      "provider",
+      "天气数据源,可重复指定;如 json:http://127.0.0.1:8080/weather "
+      "或 cbor:http://collector:9000/snapshot.未指定时使用模拟数据",
+      "kind:url");
+  parser.addOption(providerOption);
+  parser.process(app);
+
+  QList<WeatherProvider*> providers;
+  for (const QString& spec : parser.values(providerOption)) {
+    QString error;
+    WeatherProvider* provider = createProvider(spec, &error);
+    if (!provider) {
+      QTextStream(stderr) << error << "\n";
+      qDeleteAll(providers);
+      return 2;
+    }
+    providers.append(provider);
+  }
+
   // 设置应用程序样式
   QApplication::setStyle(QStyleFactory::create("Fusion"));
 
   // 创建并显示主窗口
   MainWindow mainWindow;
+  WeatherService* service = mainWindow.weatherService();
+  for (WeatherProvider* provider : providers) service->addProvider(provider);
+  // 启动时的模拟数据换成真实数据源的结果
+  if (!providers.isEmpty()) service->fetchWeatherByIndex(0, false);
   mainWindow.show();
 
   return app.exec();
-}
\ No newline at end of file
+}
@@ -0,0 +1,278 @@
+#include "ForecastModel.h"
+
+#include <QDateTime>
+
+#include "services/WeatherService.h"
+
+namespace {
+// 默认缓存上限,约能放下三个城市各15天的逐小时数据
+const qint64 kDefaultCacheLimit = 64 * 1024;
+const int kDefaultDays = 7;
+const int kSecsPerHour = 3600;
+}  // namespace
+
+const int ForecastModel::kMinCachedPages;
+
+ForecastModel::ForecastModel(WeatherService* service, QObject* parent)
+    : QAbstractTableModel(parent),
+      m_service(service),
+      m_originSecs(0),
+      m_days(kDefaultDays),
+      m_loadedPages(0),
+      m_useClock(0),
+      m_flushTimer(new QTimer(this)),
+      m_cacheLimit(kDefaultCacheLimit),
+      m_cacheBytes(0) {
+  // 同一轮事件循环里登记的页合并成一次请求
+  m_flushTimer->setSingleShot(true);
+  m_flushTimer->setInterval(0);
+  connect(m_flushTimer, &QTimer::timeout, this, &ForecastModel::flushRequests);
+
+  if (m_service) {
+    connect(m_service, &WeatherService::forecastPagesReady, this,
+            &ForecastModel::onPagesReady);
+    connect(m_service, &WeatherService::forecastFetchFailed, this,
+            &ForecastModel::onFetchFailed);
+  }
+}
+
+// QAbstractTableModel接口
+int ForecastModel::rowCount(const QModelIndex& parent) const {
+  if (parent.isValid()) return 0;
+  return m_loadedPages * ForecastPage::kHoursPerPage;
+}
+
+int ForecastModel::columnCount(const QModelIndex& parent) const {
+  if (parent.isValid()) return 0;
+  return ColumnCount;
+}
+
+QVariant ForecastModel::data(const QModelIndex& index, int role) const {
+  if (!index.isValid() || index.row() >= rowCount()) return QVariant();
+  if (role == Qt::TextAlignmentRole) return int(Qt::AlignCenter);
+  if (role != Qt::DisplayRole && role != ValueRole) return QVariant();
+
+  const int page = index.row() / ForecastPage::kHoursPerPage;
+  const int hour = index.row() % ForecastPage::kHoursPerPage;
+
+  // 时间列不依赖预报数据,不触发请求
+  if (index.column() == TimeColumn) {
+    const QDateTime time = QDateTime::fromSecsSinceEpoch(
+        ForecastPage::pageStart(m_originSecs, page) + hour * kSecsPerHour);
+    if (role == ValueRole) return time;
+    return time.toString("MM-dd HH:00");
+  }
+
+  const ForecastPage* cached = touchPage(page);
+  if (!cached || hour >= cached->hours.size()) {
+    if (role == ValueRole) return QVariant();
+    static const QString loadingText = QStringLiteral("...");
+    static const QString failedText = QStringLiteral("加载失败");
+    return m_failedPages.contains(page) ? failedText : loadingText;
+  }
+
+  const ForecastHour& forecast = cached->hours.at(hour);
+  switch (index.column()) {
+    case TemperatureColumn:
+      if (role == ValueRole) return forecast.temperature;
+      return m_formatter.temperatureText(forecast.temperature);
+    case HumidityColumn:
+      if (role == ValueRole) return forecast.humidity;
+      return m_formatter.humidityText(forecast.humidity);
+    case WindSpeedColumn:
+      if (role == ValueRole) return forecast.windSpeed;
+      return m_formatter.windSpeedText(forecast.windSpeed);
+    case ConditionColumn:
+      return forecast.weatherCondition;
+    default:
+      return QVariant();
+  }
+}
+
+QVariant ForecastModel::headerData(int section, Qt::Orientation orientation,
+                                   int role) const {
+  if (orientation != Qt::Horizontal || role != Qt::DisplayRole)
+    return QAbstractTableModel::headerData(section, orientation, role);
+
+  switch (section) {
+    case TimeColumn:
+      return QStringLiteral("时间");
+    case TemperatureColumn:
+      return QStringLiteral("温度");
+    case HumidityColumn:
+      return QStringLiteral("湿度");
+    case WindSpeedColumn:
+      return QStringLiteral("风速");
+    case ConditionColumn:
+      return QStringLiteral("天气");
+    default:
+      return QVariant();
+  }
+}
+
+bool ForecastModel::canFetchMore(const QModelIndex& parent) const {
+  return !parent.isValid() && !m_city.isEmpty() && m_loadedPages < m_days;
+}
+
+// 视图滚动到底: 多出一天的行,并请求这一页
+void ForecastModel::fetchMore(const QModelIndex& parent) {
+  if (!canFetchMore(parent)) return;
+
+  const int first = m_loadedPages * ForecastPage::kHoursPerPage;
+  beginInsertRows(QModelIndex(), first,
+                  first + ForecastPage::kHoursPerPage - 1);
+  ++m_loadedPages;
+  endInsertRows();
+  requestPage(m_loadedPages - 1);
+}
+
+void ForecastModel::setCity(const QString& city) {
+  beginResetModel();
+  m_city = city;
+  // 预报从当前整点开始;同一小时内切回来的城市可以直接使用缓存的页
+  const qint64 now = QDateTime::currentSecsSinceEpoch();
+  m_originSecs = now - now % kSecsPerHour;
+  m_loadedPages = m_city.isEmpty() ? 0 : 1;
+  m_wantedPages.clear();
+  m_requestedPages.clear();
+  m_failedPages.clear();
+  m_errorString.clear();
+  endResetModel();
+
+  if (m_loadedPages > 0) requestPage(0);
+}
+
+QString ForecastModel::city() const { return m_city; }
+
+void ForecastModel::setForecastDays(int days) {
+  days = qBound(1, days, int(ForecastPage::kMaxDays));
+  if (days == m_days) return;
+
+  if (days < m_loadedPages) {
+    beginRemoveRows(QModelIndex(), days * ForecastPage::kHoursPerPage,
+                    m_loadedPages * ForecastPage::kHoursPerPage - 1);
+    m_loadedPages = days;
+    endRemoveRows();
+  }
+  m_days = days;
+}
+
+int ForecastModel::forecastDays() const { return m_days; }
+
+void ForecastModel::setCacheLimit(qint64 bytes) {
+  m_cacheLimit = qMax(bytes, qint64(0));
+  evict();
+}
+
+qint64 ForecastModel::cacheLimit() const { return m_cacheLimit; }
+
+qint64 ForecastModel::cacheBytes() const { return m_cacheBytes; }
+
+int ForecastModel::cachedPageCount() const { return m_cache.size(); }
+
+QString ForecastModel::errorString() const { return m_errorString; }
+
+void ForecastModel::onPagesReady(const QVector<ForecastPage>& pages) {
+  for (const ForecastPage& page : pages) {
+    // 只缓存当前城市、当前起点的页;切走之后才返回的页已经没人看了
+    if (page.cityName != m_city ||
+        page.startSecs != ForecastPage::pageStart(m_originSecs, page.page))
+      continue;
+    m_requestedPages.remove(page.page);
+
+    const PageKey key(page.cityName, page.startSecs);
+    auto it = m_cache.find(key);
+    if (it != m_cache.end()) m_cacheBytes -= it->bytes;
+    CachedPage cached;
+    cached.page = page;
+    cached.bytes = pageBytes(page);
+    cached.lastUsed = ++m_useClock;
+    m_cache.insert(key, cached);
+    m_cacheBytes += cached.bytes;
+
+    if (page.page < m_loadedPages) {
+      const int first = page.page * ForecastPage::kHoursPerPage;
+      emit dataChanged(
+          index(first, TemperatureColumn),
+          index(first + ForecastPage::kHoursPerPage - 1, ConditionColumn));
+    }
+  }
+  evict();
+}
+
+void ForecastModel::onFetchFailed(const QString& city, qint64 originSecs,
+                                  const QVector<int>& pages,
+                                  const QString& error) {
+  if (city != m_city || originSecs != m_originSecs) return;
+
+  // 失败的页显示"加载失败",不再自动重试;重新选择城市时重试
+  m_errorString = error;
+  for (int page : pages) {
+    m_requestedPages.remove(page);
+    m_failedPages.insert(page);
+    if (page < m_loadedPages) {
+      const int first = page * ForecastPage::kHoursPerPage;
+      emit dataChanged(
+          index(first, TemperatureColumn),
+          index(first + ForecastPage::kHoursPerPage - 1, ConditionColumn));
+    }
+  }
+}
+
+void ForecastModel::flushRequests() {
+  QVector<int> pages;
+  for (int page : m_wantedPages) {
+    if (page >= m_loadedPages || m_cache.contains(keyFor(page))) continue;
+    pages.append(page);
+    m_requestedPages.insert(page);
+  }
+  m_wantedPages.clear();
+  if (m_service && !pages.isEmpty())
+    m_service->fetchForecastPages(m_city, m_originSecs, pages);
+}
+
+ForecastModel::PageKey ForecastModel::keyFor(int page) const {
+  return PageKey(m_city, ForecastPage::pageStart(m_originSecs, page));
+}
+
+const ForecastPage* ForecastModel::touchPage(int page) const {
+  auto it = m_cache.find(keyFor(page));
+  if (it == m_cache.end()) {
+    requestPage(page);
+    return nullptr;
+  }
+  it->lastUsed = ++m_useClock;
+  return &it->page;
+}
+
+void ForecastModel::requestPage(int page) const {
+  if (page >= m_loadedPages || m_wantedPages.contains(page) ||
+      m_requestedPages.contains(page) || m_failedPages.contains(page))
+    return;
+  m_wantedPages.insert(page);
+  if (!m_flushTimer->isActive()) m_flushTimer->start();
+}
+
+// 按最近使用时间淘汰,直到回到上限以内(缓存很小,线性查找即可)
+void ForecastModel::evict() {
+  while (m_cacheBytes > m_cacheLimit && m_cache.size() > kMinCachedPages) {
+    auto oldest = m_cache.begin();
+    for (auto it = m_cache.begin(); it != m_cache.end(); ++it) {
+      if (it->lastUsed < oldest->lastUsed) oldest = it;
+    }
+    m_cacheBytes -= oldest->bytes;
+    m_cache.erase(oldest);
+  }
+}
+
+qint64 ForecastModel::pageBytes(const ForecastPage& page) {
+  qint64 bytes = sizeof(CachedPage) + sizeof(PageKey) +
+                 page.cityName.size() * qint64(sizeof(QChar)) +
+                 page.hours.capacity() * qint64(sizeof(ForecastHour));
+  // 模拟数据的天气文本与静态表共享,真实数据源解析出来的各占一份
+  for (const ForecastHour& hour : page.hours) {
+    if (!hour.weatherCondition.isDetached()) continue;
+    bytes += hour.weatherCondition.size() * qint64(sizeof(QChar));
+  }
+  return bytes;
+}
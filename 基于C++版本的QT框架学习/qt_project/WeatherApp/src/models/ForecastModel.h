@@ -0,0 +1,114 @@
+#ifndef FORECASTMODEL_H
+#define FORECASTMODEL_H
+
+#include <QAbstractTableModel>
+#include <QHash>
+#include <QPair>
+#include <QSet>
+#include <QTimer>
+
+#include "core/ForecastPage.h"
+#include "core/WeatherFormatter.h"
+
+class WeatherService;
+
+/**
+ * 单个城市的逐小时预报表(每行一小时,最多ForecastPage::kMaxDays天)
+ *
+ * 行按天分页: 视图滚动到底时通过canFetchMore/fetchMore每次多出一天的行,
+ * data()访问到尚未缓存的页时登记下来,同一轮事件循环里登记的页合并后
+ * 交给WeatherService批量请求.已加载的页放在按字节计的LRU缓存中,
+ * 超出上限时淘汰最久没有被视图读取的页(即滚出视野最久的页),
+ * 再滚回来时重新请求.缓存按(城市,起始时刻)索引,切换城市不清空,
+ * 因此内存只取决于上限,与浏览过多少城市、多少天无关.
+ */
+class ForecastModel : public QAbstractTableModel {
+  Q_OBJECT
+
+ public:
+  enum Column {
+    TimeColumn,
+    TemperatureColumn,
+    HumidityColumn,
+    WindSpeedColumn,
+    ConditionColumn,
+    ColumnCount
+  };
+  // 原始数值(温度/湿度/风速为数字,时间为QDateTime),未加载时为空
+  enum ForecastRoles { ValueRole = Qt::UserRole + 1 };
+
+  explicit ForecastModel(WeatherService* service, QObject* parent = nullptr);
+
+  // QAbstractTableModel接口
+  int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+  int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+  QVariant data(const QModelIndex& index,
+                int role = Qt::DisplayRole) const override;
+  QVariant headerData(int section, Qt::Orientation orientation,
+                      int role = Qt::DisplayRole) const override;
+  bool canFetchMore(const QModelIndex& parent) const override;
+  void fetchMore(const QModelIndex& parent) override;
+
+  // 切换城市,预报从当前整点开始,先显示第一天
+  void setCity(const QString& city);
+  QString city() const;
+
+  // 预报天数(1~ForecastPage::kMaxDays)
+  void setForecastDays(int days);
+  int forecastDays() const;
+
+  // 页缓存的内存上限(字节),至少能放下kMinCachedPages页
+  void setCacheLimit(qint64 bytes);
+  qint64 cacheLimit() const;
+  qint64 cacheBytes() const;
+  int cachedPageCount() const;
+
+  // 最近一次请求失败的原因
+  QString errorString() const;
+
+ private slots:
+  void onPagesReady(const QVector<ForecastPage>& pages);
+  void onFetchFailed(const QString& city, qint64 originSecs,
+                     const QVector<int>& pages, const QString& error);
+  void flushRequests();
+
+ private:
+  // 一屏最多几十行,留够两三天的页,避免视野内的页互相淘汰
+  static const int kMinCachedPages = 4;
+
+  // (城市, 页起始时刻)
+  typedef QPair<QString, qint64> PageKey;
+  struct CachedPage {
+    ForecastPage page;
+    qint64 bytes = 0;
+    quint64 lastUsed = 0;
+  };
+
+  PageKey keyFor(int page) const;
+  // 查找当前城市的第page页并标记为最近使用,不在缓存中时登记请求
+  const ForecastPage* touchPage(int page) const;
+  void requestPage(int page) const;
+  void evict();
+  static qint64 pageBytes(const ForecastPage& page);
+
+  WeatherService* m_service;
+  QString m_city;
+  qint64 m_originSecs;
+  int m_days;
+  int m_loadedPages;
+
+  // data()是const,命中时要更新使用时间,未命中时要登记请求
+  mutable QHash<PageKey, CachedPage> m_cache;
+  mutable quint64 m_useClock;
+  mutable QSet<int> m_wantedPages;
+  QSet<int> m_requestedPages;
+  QSet<int> m_failedPages;
+  QTimer* m_flushTimer;
+
+  qint64 m_cacheLimit;
+  qint64 m_cacheBytes;
+  QString m_errorString;
+  mutable WeatherFormatter m_formatter;
+};
+
+#endif  // FORECASTMODEL_H
@@ -0,0 +1,67 @@
+#include "ProviderHealth.h"
+
+#include <algorithm>
+
+LatencyTracker::LatencyTracker(int capacity)
+    : m_samples(qMax(1, capacity), 0), m_next(0), m_count(0) {}
+
+void LatencyTracker::addSample(qint64 ms) {
+  // 环形缓冲,只保留最近capacity个样本
+  m_samples[m_next] = ms;
+  m_next = (m_next + 1) % m_samples.size();
+  m_count = qMin(m_count + 1, m_samples.size());
+}
+
+int LatencyTracker::sampleCount() const { return m_count; }
+
+qint64 LatencyTracker::percentile(double p) const {
+  if (m_count == 0) return -1;
+  QVector<qint64> sorted = m_samples.mid(0, m_count);
+  const int rank = qBound(0, int(p * (m_count - 1) + 0.5), m_count - 1);
+  std::nth_element(sorted.begin(), sorted.begin() + rank, sorted.end());
+  return sorted.at(rank);
+}
+
+CircuitBreaker::CircuitBreaker(int failureThreshold, qint64 openMs)
+    : m_failureThreshold(qMax(1, failureThreshold)),
+      m_openMs(openMs),
+      m_state(Closed),
+      m_consecutiveFailures(0),
+      m_openedAtMs(0),
+      m_trialInFlight(false) {}
+
+bool CircuitBreaker::allowRequest(qint64 nowMs) {
+  if (m_state == Open && nowMs - m_openedAtMs >= m_openMs) {
+    m_state = HalfOpen;
+    m_trialInFlight = false;
+  }
+  switch (m_state) {
+    case Closed:
+      return true;
+    case HalfOpen:
+      if (m_trialInFlight) return false;
+      m_trialInFlight = true;
+      return true;
+    default:
+      return false;
+  }
+}
+
+void CircuitBreaker::recordSuccess() {
+  m_state = Closed;
+  m_consecutiveFailures = 0;
+  m_trialInFlight = false;
+}
+
+void CircuitBreaker::recordFailure(qint64 nowMs) {
+  m_trialInFlight = false;
+  m_consecutiveFailures++;
+  if (m_state == HalfOpen || m_consecutiveFailures >= m_failureThreshold) {
+    m_state = Open;
+    m_openedAtMs = nowMs;
+  }
+}
+
+void CircuitBreaker::recordCancelled() { m_trialInFlight = false; }
+
+CircuitBreaker::State CircuitBreaker::state() const { return m_state; }
@@ -0,0 +1,48 @@
+#ifndef PROVIDERHEALTH_H
+#define PROVIDERHEALTH_H
+
+#include <QVector>
+#include <QtGlobal>
+
+// 记录最近若干次成功请求的耗时,用于计算对冲请求的触发时机
+class LatencyTracker {
+ public:
+  explicit LatencyTracker(int capacity = 128);
+
+  void addSample(qint64 ms);
+  int sampleCount() const;
+  // 返回p分位数(0~1),没有样本时返回-1
+  qint64 percentile(double p) const;
+
+ private:
+  QVector<qint64> m_samples;
+  int m_next;
+  int m_count;
+};
+
+// 熔断器: 连续失败达到阈值后暂停使用该天气源,冷却后放行一次试探请求
+class CircuitBreaker {
+ public:
+  enum State { Closed, Open, HalfOpen };
+
+  explicit CircuitBreaker(int failureThreshold = 5, qint64 openMs = 30000);
+
+  // 是否允许发出请求(半开状态下同一时间只放行一次试探)
+  bool allowRequest(qint64 nowMs);
+  void recordSuccess();
+  void recordFailure(qint64 nowMs);
+  // 请求被主动取消(对冲竞速失败),不计入成功或失败
+  void recordCancelled();
+
+  State state() const;
+
+ private:
+  int m_failureThreshold;
+  qint64 m_openMs;
+  State m_state;
+  int m_consecutiveFailures;
+  qint64 m_openedAtMs;
+  bool m_trialInFlight;
+};
+
+#endif  // PROVIDERHEALTH_H
@@ -0,0 +1,172 @@
+#include "WeatherProvider.h"
+
+#include <QDateTime>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QUrlQuery>
+
+#include "core/WeatherCodec.h"
+
+WeatherProvider::WeatherProvider(const QString& name, const QUrl& baseUrl,
+                                 QObject* parent)
+    : QObject(parent), m_name(name), m_baseUrl(baseUrl) {}
+
+QString WeatherProvider::name() const { return m_name; }
+
+QUrl WeatherProvider::baseUrl() const { return m_baseUrl; }
+
+LatencyTracker& WeatherProvider::latency() { return m_latency; }
+
+CircuitBreaker& WeatherProvider::breaker() { return m_breaker; }
+
+bool WeatherProvider::supportsForecast() const { return false; }
+
+QNetworkRequest WeatherProvider::buildForecastRequest(const QString& city,
+                                                      qint64 startSecs,
+                                                      int hours) const {
+  Q_UNUSED(city)
+  Q_UNUSED(startSecs)
+  Q_UNUSED(hours)
+  return QNetworkRequest();
+}
+
+bool WeatherProvider::parseForecast(const QByteArray& data, int hours,
+                                    QVector<ForecastHour>* forecast,
+                                    QString* error) const {
+  Q_UNUSED(data)
+  Q_UNUSED(hours)
+  Q_UNUSED(forecast)
+  *error = QString("%1: 不支持逐小时预报").arg(name());
+  return false;
+}
+
+QNetworkRequest WeatherProvider::cityRequest(const QString& city,
+                                             const QByteArray& accept) const {
+  QUrl url(m_baseUrl);
+  QUrlQuery query(url);
+  query.addQueryItem("city", city);
+  url.setQuery(query);
+
+  QNetworkRequest request(url);
+  request.setRawHeader("Accept", accept);
+  return request;
+}
+
+JsonWeatherProvider::JsonWeatherProvider(const QString& name,
+                                         const QUrl& baseUrl, QObject* parent)
+    : WeatherProvider(name, baseUrl, parent) {}
+
+QNetworkRequest JsonWeatherProvider::buildRequest(const QString& city) const {
+  return cityRequest(city, "application/json");
+}
+
+bool JsonWeatherProvider::parseResponse(const QByteArray& data,
+                                        const QString& city,
+                                        WeatherSnapshot* snapshot,
+                                        QString* error) const {
+  QJsonParseError parseError;
+  const QJsonDocument doc = QJsonDocument::fromJson(data, &parseError);
+  if (parseError.error != QJsonParseError::NoError || !doc.isObject()) {
+    *error = QString("%1: JSON解析失败").arg(name());
+    return false;
+  }
+
+  const QJsonObject object = doc.object();
+  if (!object.contains("temperature")) {
+    *error = QString("%1: 响应缺少温度字段").arg(name());
+    return false;
+  }
+
+  snapshot->cityName = city;
+  snapshot->temperature = object["temperature"].toDouble();
+  snapshot->humidity = object["humidity"].toInt();
+  snapshot->windSpeed = object["windSpeed"].toDouble();
+  snapshot->weatherCondition = object["condition"].toString();
+  snapshot->lastUpdatedSecs =
+      object.contains("updated") ? qint64(object["updated"].toDouble())
+                                 : QDateTime::currentSecsSinceEpoch();
+  return true;
+}
+
+bool JsonWeatherProvider::supportsForecast() const { return true; }
+
+QNetworkRequest JsonWeatherProvider::buildForecastRequest(const QString& city,
+                                                          qint64 startSecs,
+                                                          int hours) const {
+  QUrl url(baseUrl());
+  QString path = url.path();
+  if (path.endsWith('/')) path.chop(1);
+  url.setPath(path + "/forecast");
+  QUrlQuery query;
+  query.addQueryItem("city", city);
+  query.addQueryItem("start", QString::number(startSecs));
+  query.addQueryItem("hours", QString::number(hours));
+  url.setQuery(query);
+
+  QNetworkRequest request(url);
+  request.setRawHeader("Accept", "application/json");
+  return request;
+}
+
+bool JsonWeatherProvider::parseForecast(const QByteArray& data, int hours,
+                                        QVector<ForecastHour>* forecast,
+                                        QString* error) const {
+  QJsonParseError parseError;
+  const QJsonDocument doc = QJsonDocument::fromJson(data, &parseError);
+  if (parseError.error != QJsonParseError::NoError || !doc.isObject()) {
+    *error = QString("%1: JSON解析失败").arg(name());
+    return false;
+  }
+
+  const QJsonArray array = doc.object()["hours"].toArray();
+  if (array.size() != hours) {
+    *error = QString("%1: 预报应有%2小时,实际%3小时")
+                 .arg(name())
+                 .arg(hours)
+                 .arg(array.size());
+    return false;
+  }
+
+  forecast->clear();
+  forecast->reserve(hours);
+  for (const QJsonValue& value : array) {
+    const QJsonObject object = value.toObject();
+    ForecastHour hour;
+    hour.temperature = object["temperature"].toDouble();
+    hour.humidity = object["humidity"].toInt();
+    hour.windSpeed = object["windSpeed"].toDouble();
+    hour.weatherCondition = object["condition"].toString();
+    forecast->append(hour);
+  }
+  return true;
+}
+
+CborWeatherProvider::CborWeatherProvider(const QString& name,
+                                         const QUrl& baseUrl, QObject* parent)
+    : WeatherProvider(name, baseUrl, parent) {}
+
+QNetworkRequest CborWeatherProvider::buildRequest(const QString& city) const {
+  return cityRequest(city, "application/cbor");
+}
+
+bool CborWeatherProvider::parseResponse(const QByteArray& data,
+                                        const QString& city,
+                                        WeatherSnapshot* snapshot,
+                                        QString* error) const {
+  // 每个响应都是独立的关键帧,无需保留基线
+  WeatherCodec codec;
+  QVector<WeatherSnapshot> snapshots;
+  if (!codec.decode(data, &snapshots)) {
+    *error = QString("%1: %2").arg(name(), codec.errorString());
+    return false;
+  }
+  for (const WeatherSnapshot& s : snapshots) {
+    if (s.cityName == city) {
+      *snapshot = s;
+      return true;
+    }
+  }
+  *error = QString("%1: 响应中没有城市 %2").arg(name(), city);
+  return false;
+}
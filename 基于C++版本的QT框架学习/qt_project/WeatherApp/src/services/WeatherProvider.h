@@ -0,0 +1,91 @@
+#ifndef WEATHERPROVIDER_H
+#define WEATHERPROVIDER_H
+
+#include <QNetworkRequest>
+#include <QObject>
+#include <QUrl>
+
+#include "core/ForecastPage.h"
+#include "core/WeatherSnapshot.h"
+#include "services/ProviderHealth.h"
+
+// 天气数据源抽象: 负责构造请求和解析响应,网络收发由WeatherService统一处理
+// baseUrl可以指向本地的替身服务器,便于测试故障转移和对冲逻辑
+class WeatherProvider : public QObject {
+  Q_OBJECT
+
+ public:
+  WeatherProvider(const QString& name, const QUrl& baseUrl,
+                  QObject* parent = nullptr);
+
+  QString name() const;
+  QUrl baseUrl() const;
+
+  virtual QNetworkRequest buildRequest(const QString& city) const = 0;
+  virtual bool parseResponse(const QByteArray& data, const QString& city,
+                             WeatherSnapshot* snapshot,
+                             QString* error) const = 0;
+
+  // 逐小时预报(可选): 一次请求从startSecs起连续hours个小时.
+  // 不支持的数据源supportsForecast返回false,WeatherService会跳过它
+  virtual bool supportsForecast() const;
+  virtual QNetworkRequest buildForecastRequest(const QString& city,
+                                               qint64 startSecs,
+                                               int hours) const;
+  virtual bool parseForecast(const QByteArray& data, int hours,
+                             QVector<ForecastHour>* forecast,
+                             QString* error) const;
+
+  // 每个数据源各自的延迟统计与熔断状态
+  LatencyTracker& latency();
+  CircuitBreaker& breaker();
+
+ protected:
+  // 生成 baseUrl?city=<城市> 形式的请求
+  QNetworkRequest cityRequest(const QString& city,
+                              const QByteArray& accept) const;
+
+ private:
+  QString m_name;
+  QUrl m_baseUrl;
+  LatencyTracker m_latency;
+  CircuitBreaker m_breaker;
+};
+
+// 返回扁平JSON的数据源:
+// {"temperature":..,"humidity":..,"windSpeed":..,"condition":..,"updated":秒}
+// 逐小时预报为 <baseUrl>/forecast?city=..&start=秒&hours=N,返回
+// {"hours":[{"temperature":..,"humidity":..,"windSpeed":..,"condition":..},..]}
+class JsonWeatherProvider : public WeatherProvider {
+  Q_OBJECT
+
+ public:
+  JsonWeatherProvider(const QString& name, const QUrl& baseUrl,
+                      QObject* parent = nullptr);
+
+  QNetworkRequest buildRequest(const QString& city) const override;
+  bool parseResponse(const QByteArray& data, const QString& city,
+                     WeatherSnapshot* snapshot, QString* error) const override;
+
+  bool supportsForecast() const override;
+  QNetworkRequest buildForecastRequest(const QString& city, qint64 startSecs,
+                                       int hours) const override;
+  bool parseForecast(const QByteArray& data, int hours,
+                     QVector<ForecastHour>* forecast,
+                     QString* error) const override;
+};
+
+// 返回WeatherCodec关键帧的数据源(采集端节点)
+class CborWeatherProvider : public WeatherProvider {
+  Q_OBJECT
+
+ public:
+  CborWeatherProvider(const QString& name, const QUrl& baseUrl,
+                      QObject* parent = nullptr);
+
+  QNetworkRequest buildRequest(const QString& city) const override;
+  bool parseResponse(const QByteArray& data, const QString& city,
+                     WeatherSnapshot* snapshot, QString* error) const override;
+};
+
+#endif  // WEATHERPROVIDER_H
@@ -7,6 +7,35 @@
 #include <QNetworkRequest>
 #include <QRandomGenerator>
 #include <QUrl>
+#include <QtMath>
+
+#include <algorithm>
+
+namespace {
+// 模拟网络延迟
+const int kMockLatencyMs = 500;
+// 缓存数据在此时间内视为新鲜,可直接显示
+const qint64 kFreshSecs = 5 * 60;
+// 选择频率的衰减半衰期
+const double kSelectionHalfLifeMs = 30 * 60 * 1000.0;
+// 每次预取的相邻城市范围与常用城市个数
+const int kNeighborRadius = 2;
+const int kFrequentCount = 3;
+// 数据源样本不足时的对冲延迟,以及对冲请求占总请求量的上限
+const qint64 kDefaultHedgeDelayMs = 1000;
+const int kMinHedgeSamples = 20;
+const int kMaxHedgePercent = 10;
+// 一个预报请求最多合并的页数(天)
+const int kMaxForecastPagesPerRequest = 7;
+
+// 模拟数据的天气条件(静态表,避免每次刷新重建列表)
+const QStringList& mockConditions() {
+  static const QStringList conditions = {"晴朗", "多云",   "阴天", "小雨",
+                                         "中雨", "大雨",   "阵雪", "雾",
+                                         "雷阵雨", "晴转多云"};
+  return conditions;
+}
+}  // namespace
 
 WeatherService::WeatherService(QObject* parent)
     : QObject(parent),
@@ -14,7 +43,15 @@ WeatherService::WeatherService(QObject* parent)
       m_currentWeather(new WeatherData(this)),
       m_cityModel(new CityModel(this)),
       m_autoUpdateTimer(new QTimer(this)),
-      m_isLoading(false) {
+      m_isLoading(false),
+      m_prefetchMaxInFlight(2),
+      m_prefetchPerMinute(30),
+      m_prefetchWindowStartMs(0),
+      m_prefetchWindowCount(0),
+      m_nextFetchId(0),
+      m_foregroundFetchId(0),
+      m_providerRequestCount(0),
+      m_hedgeCount(0) {
   // 连接网络响应信号
   connect(m_networkManager, &QNetworkAccessManager::finished, this,
           &WeatherService::onNetworkReply);
@@ -32,28 +69,107 @@ WeatherService::WeatherService(QObject* parent)
 
 WeatherService::~WeatherService() { stopAutoUpdate(); }
 
-void WeatherService::fetchWeather(const QString& city) {
+void WeatherService::fetchWeather(const QString& city, bool allowCached) {
   if (city.isEmpty()) {
     m_errorString = "城市名称不能为空";
     emit errorStringChanged();
     return;
   }
 
+  // 之前的前台请求即使晚到也不能覆盖这次的结果
+  supersedeForegroundFetch();
+
+  // 命中预取缓存时直接显示,不再等待网络
+  m_pendingForegroundCity.clear();
+  if (allowCached && applyCachedWeather(city)) return;
+
   m_isLoading = true;
   emit isLoadingChanged();
 
-  // 在实际应用中,这里应该调用真实的天气API
-  // 例如: QNetworkRequest request(QUrl("http://api.weather.com/v3/.."));
+  // 该城市正在预取,复用在途请求
+  if (m_prefetchInFlight.contains(city)) {
+    m_pendingForegroundCity = city;
+    return;
+  }
 
-  // 由于这是一个示例,我们使用模拟数据
-  QTimer::singleShot(500, this, [this, city]() { fetchMockWeatherData(city); });
+  if (!m_providers.isEmpty()) {
+    startProviderFetch(city, true);
+    return;
+  }
+
+  // 未配置数据源时使用模拟数据
+  const quint64 fetchId = m_foregroundFetchId;
+  QTimer::singleShot(kMockLatencyMs, this, [this, city, fetchId]() {
+    if (fetchId == m_foregroundFetchId) fetchMockWeatherData(city);
+  });
 }
-void WeatherService::fetchWeatherByIndex(int cityIndex) {
+void WeatherService::fetchWeatherByIndex(int cityIndex, bool allowCached) {
   if (cityIndex >= 0 && cityIndex < m_cityModel->rowCount()) {
+    recordSelection(cityIndex);
     QString cityName = m_cityModel->getCityName(cityIndex);
-    fetchWeather(cityName);
+    fetchWeather(cityName, allowCached);
   }
 }
+
+void WeatherService::prefetchAround(int cityIndex) {
+  const int count = m_cityModel->rowCount();
+  if (cityIndex < 0 || cityIndex >= count) return;
+
+  // 新的浏览位置最能反映接下来的需求,丢弃旧的排队项
+  m_prefetchQueue.clear();
+  auto enqueue = [this](int index) {
+    const QString city = m_cityModel->getCityName(index);
+    if (city.isEmpty() || city == m_currentWeather->cityName() ||
+        m_prefetchQueue.contains(city) || m_prefetchInFlight.contains(city) ||
+        isFresh(city))
+      return;
+    m_prefetchQueue.append(city);
+  };
+
+  // 先按距离由近到远预取相邻城市
+  enqueue(cityIndex);
+  for (int d = 1; d <= kNeighborRadius; ++d) {
+    if (cityIndex + d < count) enqueue(cityIndex + d);
+    if (cityIndex - d >= 0) enqueue(cityIndex - d);
+  }
+
+  // 再预取按频率和最近程度加权后得分最高的城市
+  const qint64 now = QDateTime::currentMSecsSinceEpoch();
+  QVector<QPair<double, int>> ranked;
+  ranked.reserve(m_selectionHistory.size());
+  for (auto it = m_selectionHistory.cbegin(); it != m_selectionHistory.cend();
+       ++it) {
+    const double age = now - it.value().lastSelectedMs;
+    const double score =
+        it.value().count * qPow(0.5, age / kSelectionHalfLifeMs);
+    ranked.append(qMakePair(score, it.key()));
+  }
+  std::sort(ranked.begin(), ranked.end(),
+            [](const QPair<double, int>& a, const QPair<double, int>& b) {
+              return a.first > b.first;
+            });
+  for (int i = 0; i < ranked.size() && i < kFrequentCount; ++i) {
+    if (ranked.at(i).second < count) enqueue(ranked.at(i).second);
+  }
+
+  pumpPrefetchQueue();
+}
+
+void WeatherService::setPrefetchBudget(int maxInFlight, int perMinute) {
+  m_prefetchMaxInFlight = qMax(0, maxInFlight);
+  m_prefetchPerMinute = qMax(0, perMinute);
+  pumpPrefetchQueue();
+}
+
+void WeatherService::addProvider(WeatherProvider* provider) {
+  if (!provider || m_providers.contains(provider)) return;
+  provider->setParent(this);
+  m_providers.append(provider);
+}
+
+QList<WeatherProvider*> WeatherService::providers() const {
+  return m_providers;
+}
 WeatherData* WeatherService::currentWeather() const { return m_currentWeather; }
 
 CityModel* WeatherService::cityModel() const { return m_cityModel; }
@@ -77,26 +193,336 @@ void WeatherService::stopAutoUpdate() {
   }
 }
 
+QByteArray WeatherService::encodeSnapshots(bool keyFrame) {
+  return m_snapshotEncoder.encode(
+      cachedSnapshots(),
+      keyFrame ? WeatherCodec::KeyFrame : WeatherCodec::DeltaFrame);
+}
+
+bool WeatherService::decodeSnapshots(const QByteArray& frame) {
+  QVector<WeatherSnapshot> snapshots;
+  if (!m_snapshotDecoder.decode(frame, &snapshots)) {
+    m_errorString = m_snapshotDecoder.errorString();
+    emit errorStringChanged();
+    return false;
+  }
+
+  for (const WeatherSnapshot& snapshot : snapshots) applySnapshot(snapshot);
+  return true;
+}
+
+void WeatherService::applySnapshot(const WeatherSnapshot& snapshot) {
+  if (snapshot.cityName != m_currentWeather->cityName()) {
+    cacheSnapshot(snapshot);
+    return;
+  }
+  updateCurrentWeather(snapshot);
+  emit weatherUpdated();
+}
+
+QVector<WeatherSnapshot> WeatherService::cachedSnapshots() const {
+  QVector<WeatherSnapshot> snapshots;
+  snapshots.reserve(m_snapshotCache.size());
+  for (auto it = m_snapshotCache.cbegin(); it != m_snapshotCache.cend(); ++it)
+    snapshots.append(it.value());
+  return snapshots;
+}
+
+void WeatherService::fetchForecastPages(const QString& city,
+                                        qint64 originSecs, QVector<int> pages) {
+  if (city.isEmpty()) return;
+  std::sort(pages.begin(), pages.end());
+  pages.erase(std::unique(pages.begin(), pages.end()), pages.end());
+
+  int i = 0;
+  while (i < pages.size()) {
+    if (pages.at(i) < 0 || pages.at(i) >= ForecastPage::kMaxDays) {
+      ++i;
+      continue;
+    }
+    int j = i + 1;
+    while (j < pages.size() && pages.at(j) == pages.at(j - 1) + 1 &&
+           pages.at(j) < ForecastPage::kMaxDays &&
+           j - i < kMaxForecastPagesPerRequest)
+      ++j;
+
+    PendingForecast fetch;
+    fetch.city = city;
+    fetch.originSecs = originSecs;
+    fetch.firstPage = pages.at(i);
+    fetch.pageCount = j - i;
+    const quint64 forecastId = ++m_nextFetchId;
+    m_pendingForecasts.insert(forecastId, fetch);
+    sendForecastRequest(forecastId);
+    i = j;
+  }
+}
+
 void WeatherService::onNetworkReply(QNetworkReply* reply) {
+  reply->deleteLater();
+
+  if (reply->property("forecastId").isValid()) {
+    onForecastReply(reply);
+    return;
+  }
+
+  const quint64 fetchId = reply->property("fetchId").toULongLong();
+  WeatherProvider* provider =
+      m_providers.value(reply->property("provider").toInt(), nullptr);
+  if (!provider) return;
+
+  auto it = m_pendingFetches.find(fetchId);
+  if (it == m_pendingFetches.end()) {
+    // 对冲竞速中落败、已被取消的请求
+    provider->breaker().recordCancelled();
+    return;
+  }
+  it->replies.removeOne(reply);
+
+  const qint64 now = QDateTime::currentMSecsSinceEpoch();
+  WeatherSnapshot snapshot;
+  QString error;
+  bool ok = false;
+  if (reply->error() == QNetworkReply::NoError) {
+    ok = provider->parseResponse(reply->readAll(), it->city, &snapshot, &error);
+  } else {
+    error = QString("%1: %2").arg(provider->name(), reply->errorString());
+  }
+
+  if (ok) {
+    provider->latency().addSample(now -
+                                  reply->property("startedMs").toLongLong());
+    provider->breaker().recordSuccess();
+
+    // 先移除请求再取消其余在途请求,被取消的回复会走上面的分支
+    const PendingFetch fetch = it.value();
+    m_pendingFetches.erase(it);
+    for (QNetworkReply* other : fetch.replies) other->abort();
+    completeFetch(fetchId, fetch.city, fetch.foreground, snapshot);
+    return;
+  }
+
+  provider->breaker().recordFailure(now);
+  if (!it->replies.isEmpty()) return;  // 仍有其他数据源在途
+
+  // 所有在途请求都失败了,立即转移到下一个可用数据源
+  const int next = nextProvider(it.value());
+  if (next >= 0) {
+    sendProviderRequest(fetchId, next);
+    return;
+  }
+  const PendingFetch fetch = it.value();
+  m_pendingFetches.erase(it);
+  failFetch(fetchId, fetch.city, fetch.foreground, error);
+}
+
+void WeatherService::startProviderFetch(const QString& city, bool foreground) {
+  const quint64 fetchId = ++m_nextFetchId;
+  PendingFetch fetch;
+  fetch.city = city;
+  fetch.foreground = foreground;
+  if (foreground) m_foregroundFetchId = fetchId;
+
+  const int primary = nextProvider(fetch);
+  if (primary < 0) {
+    failFetch(fetchId, city, foreground, "所有天气数据源暂不可用");
+    return;
+  }
+  m_pendingFetches.insert(fetchId, fetch);
+  sendProviderRequest(fetchId, primary);
+
+  // 主源超过其观测到的p95仍未返回时发对冲请求
+  const LatencyTracker& latency = m_providers.at(primary)->latency();
+  const qint64 delay = latency.sampleCount() >= kMinHedgeSamples
+                           ? latency.percentile(0.95)
+                           : kDefaultHedgeDelayMs;
+  QTimer::singleShot(int(delay), this,
+                     [this, fetchId]() { onHedgeTimeout(fetchId); });
+}
+
+int WeatherService::nextProvider(const PendingFetch& fetch) {
+  const qint64 now = QDateTime::currentMSecsSinceEpoch();
+  for (int i = 0; i < m_providers.size(); ++i) {
+    if (fetch.triedProviders.contains(i)) continue;
+    if (m_providers.at(i)->breaker().allowRequest(now)) return i;
+  }
+  return -1;
+}
+
+void WeatherService::sendProviderRequest(quint64 fetchId, int providerIndex) {
+  PendingFetch& fetch = m_pendingFetches[fetchId];
+  WeatherProvider* provider = m_providers.at(providerIndex);
+
+  QNetworkReply* reply =
+      m_networkManager->get(provider->buildRequest(fetch.city));
+  reply->setProperty("fetchId", fetchId);
+  reply->setProperty("provider", providerIndex);
+  reply->setProperty("city", fetch.city);
+  reply->setProperty("startedMs", QDateTime::currentMSecsSinceEpoch());
+
+  fetch.triedProviders.append(providerIndex);
+  fetch.replies.append(reply);
+  m_providerRequestCount++;
+}
+
+void WeatherService::onHedgeTimeout(quint64 fetchId) {
+  auto it = m_pendingFetches.find(fetchId);
+  if (it == m_pendingFetches.end() || it->hedged || it->replies.isEmpty())
+    return;
+
+  // 对冲请求量不超过总请求量的kMaxHedgePercent
+  if ((m_hedgeCount + 1) * 100 > m_providerRequestCount * kMaxHedgePercent &&
+      m_hedgeCount > 0)
+    return;
+
+  const int secondary = nextProvider(it.value());
+  if (secondary < 0) return;
+  it->hedged = true;
+  m_hedgeCount++;
+  sendProviderRequest(fetchId, secondary);
+}
+
+void WeatherService::supersedeForegroundFetch() {
+  auto it = m_pendingFetches.find(m_foregroundFetchId);
+  if (it != m_pendingFetches.end() && it->foreground) {
+    // 先移除请求再取消,被取消的回复按对冲落败处理
+    const QList<QNetworkReply*> replies = it->replies;
+    m_pendingFetches.erase(it);
+    for (QNetworkReply* reply : replies) reply->abort();
+  }
+  m_foregroundFetchId = ++m_nextFetchId;
+}
+
+void WeatherService::completeFetch(quint64 fetchId, const QString& city,
+                                   bool foreground,
+                                   const WeatherSnapshot& snapshot) {
+  Q_UNUSED(city)
+  if (!foreground) {
+    onPrefetchFinished(snapshot);
+    return;
+  }
+  // 已被更新的前台请求取代: 数据照常写入缓存,但不改变当前天气
+  if (fetchId != m_foregroundFetchId) {
+    cacheSnapshot(snapshot);
+    return;
+  }
+  updateCurrentWeather(snapshot);
   m_isLoading = false;
   emit isLoadingChanged();
+  emit weatherUpdated();
+  pumpPrefetchQueue();
+}
+
+void WeatherService::failFetch(quint64 fetchId, const QString& city,
+                               bool foreground, const QString& error) {
+  if (foreground && fetchId != m_foregroundFetchId) return;
+  if (!foreground) {
+    m_prefetchInFlight.remove(city);
+    // 预取失败不打扰用户,除非前台正在等待这个城市
+    if (m_pendingForegroundCity != city) {
+      pumpPrefetchQueue();
+      return;
+    }
+    m_pendingForegroundCity.clear();
+  }
+  m_isLoading = false;
+  emit isLoadingChanged();
+  m_errorString = error;
+  emit errorStringChanged();
+  emit weatherFetchFailed(m_errorString);
+  pumpPrefetchQueue();
+}
+
+void WeatherService::sendForecastRequest(quint64 forecastId) {
+  auto it = m_pendingForecasts.find(forecastId);
+  if (it == m_pendingForecasts.end()) return;
+
+  const qint64 now = QDateTime::currentMSecsSinceEpoch();
+  bool supported = false;
+  for (int i = 0; i < m_providers.size(); ++i) {
+    WeatherProvider* provider = m_providers.at(i);
+    if (!provider->supportsForecast()) continue;
+    supported = true;
+    if (it->triedProviders.contains(i) || !provider->breaker().allowRequest(now))
+      continue;
+
+    QNetworkReply* reply = m_networkManager->get(provider->buildForecastRequest(
+        it->city, ForecastPage::pageStart(it->originSecs, it->firstPage),
+        it->pageCount * ForecastPage::kHoursPerPage));
+    reply->setProperty("forecastId", forecastId);
+    reply->setProperty("provider", i);
+    it->triedProviders.append(i);
+    return;
+  }
+
+  const PendingForecast fetch = it.value();
+  m_pendingForecasts.erase(it);
+  if (!supported) {
+    // 未配置支持预报的数据源时使用模拟数据
+    QTimer::singleShot(kMockLatencyMs, this, [this, fetch]() {
+      QVector<ForecastPage> pages;
+      pages.reserve(fetch.pageCount);
+      for (int k = 0; k < fetch.pageCount; ++k)
+        pages.append(generateMockForecastPage(fetch.city, fetch.originSecs,
+                                              fetch.firstPage + k));
+      emit forecastPagesReady(pages);
+    });
+    return;
+  }
+
+  QVector<int> pages;
+  for (int k = 0; k < fetch.pageCount; ++k) pages.append(fetch.firstPage + k);
+  emit forecastFetchFailed(
+      fetch.city, fetch.originSecs, pages,
+      fetch.lastError.isEmpty() ? QString("所有天气数据源暂不可用")
+                                : fetch.lastError);
+}
+
+void WeatherService::onForecastReply(QNetworkReply* reply) {
+  const quint64 forecastId = reply->property("forecastId").toULongLong();
+  WeatherProvider* provider =
+      m_providers.value(reply->property("provider").toInt(), nullptr);
+  auto it = m_pendingForecasts.find(forecastId);
+  if (!provider || it == m_pendingForecasts.end()) return;
 
+  const int hours = it->pageCount * ForecastPage::kHoursPerPage;
+  QVector<ForecastHour> forecast;
+  QString error;
+  bool ok = false;
   if (reply->error() == QNetworkReply::NoError) {
-    QByteArray data = reply->readAll();
-    QString city = reply->property("city").toString();
-    parseWeatherResponse(data, city);
+    ok = provider->parseForecast(reply->readAll(), hours, &forecast, &error);
   } else {
-    m_errorString = reply->errorString();
-    emit errorStringChanged();
-    emit weatherFetchFailed(m_errorString);
+    error = QString("%1: %2").arg(provider->name(), reply->errorString());
   }
 
-  reply->deleteLater();
+  // 预报响应比当前天气大得多,不计入对冲用的延迟统计,只影响熔断
+  if (!ok) {
+    provider->breaker().recordFailure(QDateTime::currentMSecsSinceEpoch());
+    it->lastError = error;
+    sendForecastRequest(forecastId);
+    return;
+  }
+  provider->breaker().recordSuccess();
+
+  const PendingForecast fetch = it.value();
+  m_pendingForecasts.erase(it);
+  QVector<ForecastPage> pages;
+  pages.reserve(fetch.pageCount);
+  for (int k = 0; k < fetch.pageCount; ++k) {
+    ForecastPage page;
+    page.cityName = fetch.city;
+    page.page = fetch.firstPage + k;
+    page.startSecs = ForecastPage::pageStart(fetch.originSecs, page.page);
+    page.hours = forecast.mid(k * ForecastPage::kHoursPerPage,
+                              ForecastPage::kHoursPerPage);
+    pages.append(page);
+  }
+  emit forecastPagesReady(pages);
 }
 
 void WeatherService::onAutoUpdate() {
   if (!m_currentWeather->cityName().isEmpty()) {
-    fetchWeather(m_currentWeather->cityName());
+    fetchWeather(m_currentWeather->cityName(), false);
   }
 }
 
@@ -107,36 +533,136 @@ void WeatherService::fetchMockWeatherData(const QString& city) {
   m_isLoading = false;
   emit isLoadingChanged();
   emit weatherUpdated();
+
+  // 前台空闲后继续排队中的预取
+  pumpPrefetchQueue();
 }
 
-void WeatherService::parseWeatherResponse(const QByteArray& data,
-                                          const QString& city) {
-  // 在实际应用中，这里应该解析真实的API响应
-  // 示例：解析JSON数据
-  Q_UNUSED(data)
-  generateMockData(city);
+void WeatherService::recordSelection(int cityIndex) {
+  SelectionStat& stat = m_selectionHistory[cityIndex];
+  stat.count++;
+  stat.lastSelectedMs = QDateTime::currentMSecsSinceEpoch();
+}
+
+bool WeatherService::isFresh(const QString& city) const {
+  auto it = m_snapshotCache.constFind(city);
+  if (it == m_snapshotCache.cend()) return false;
+  const qint64 age =
+      QDateTime::currentSecsSinceEpoch() - it.value().lastUpdatedSecs;
+  return age >= 0 && age < kFreshSecs;
+}
+
+bool WeatherService::applyCachedWeather(const QString& city) {
+  if (!isFresh(city)) return false;
+
+  updateCurrentWeather(m_snapshotCache.value(city));
+  if (m_isLoading) {
+    m_isLoading = false;
+    emit isLoadingChanged();
+  }
+  emit weatherUpdated();
+  return true;
+}
+
+void WeatherService::pumpPrefetchQueue() {
+  // 前台请求优先,加载期间不发起预取
+  if (m_isLoading) return;
+
+  const qint64 now = QDateTime::currentMSecsSinceEpoch();
+  if (now - m_prefetchWindowStartMs >= 60 * 1000) {
+    m_prefetchWindowStartMs = now;
+    m_prefetchWindowCount = 0;
+  }
+
+  while (!m_prefetchQueue.isEmpty() &&
+         m_prefetchInFlight.size() < m_prefetchMaxInFlight &&
+         m_prefetchWindowCount < m_prefetchPerMinute) {
+    const QString city = m_prefetchQueue.takeFirst();
+    if (isFresh(city) || m_prefetchInFlight.contains(city)) continue;
+
+    m_prefetchInFlight.insert(city);
+    m_prefetchWindowCount++;
+    if (!m_providers.isEmpty()) {
+      startProviderFetch(city, false);
+      continue;
+    }
+    QTimer::singleShot(kMockLatencyMs, this, [this, city]() {
+      onPrefetchFinished(generateMockSnapshot(city));
+    });
+  }
+}
+
+void WeatherService::onPrefetchFinished(const WeatherSnapshot& snapshot) {
+  const QString city = snapshot.cityName;
+  m_prefetchInFlight.remove(city);
+
+  // 前台正在等待这个城市
+  if (m_pendingForegroundCity == city) {
+    m_pendingForegroundCity.clear();
+    updateCurrentWeather(snapshot);
+    m_isLoading = false;
+    emit isLoadingChanged();
+    emit weatherUpdated();
+  } else {
+    cacheSnapshot(snapshot);
+  }
+
+  pumpPrefetchQueue();
 }
 
 void WeatherService::generateMockData(const QString& city) {
+  updateCurrentWeather(generateMockSnapshot(city));
+}
+
+WeatherSnapshot WeatherService::generateMockSnapshot(
+    const QString& city) const {
   QRandomGenerator* random = QRandomGenerator::global();
 
   // 生成模拟天气数据
-  double temperature = 10 + random->bounded(20);  // 10-30°C
-  int humidity = 30 + random->bounded(50);        // 30-80%
-  double windSpeed = 1 + random->bounded(0, 10);  // 1-10 km/h
+  WeatherSnapshot snapshot;
+  snapshot.cityName = city;
+  snapshot.temperature = 10 + random->bounded(20);  // 10-30°C
+  snapshot.humidity = 30 + random->bounded(50);     // 30-80%
+  snapshot.windSpeed = 1 + random->bounded(0, 10);  // 1-10 km/h
 
-  // 天气条件
-  QStringList conditions = {"晴朗", "多云", "阴天", "小雨",   "中雨",
-                            "大雨", "阵雪", "雾",   "雷阵雨", "晴转多云"};
-  QString condition = conditions.at(random->bounded(conditions.size()));
+  const QStringList& conditions = mockConditions();
+  snapshot.weatherCondition =
+      conditions.at(random->bounded(conditions.size()));
+  snapshot.lastUpdatedSecs = QDateTime::currentSecsSinceEpoch();
+  return snapshot;
+}
 
+ForecastPage WeatherService::generateMockForecastPage(const QString& city,
+                                                      qint64 originSecs,
+                                                      int page) const {
+  ForecastPage result;
+  result.cityName = city;
+  result.page = page;
+  result.startSecs = ForecastPage::pageStart(originSecs, page);
+  result.hours.reserve(ForecastPage::kHoursPerPage);
+
+  const QStringList& conditions = mockConditions();
+  for (int h = 0; h < ForecastPage::kHoursPerPage; ++h) {
+    const qint64 hourIndex = result.startSecs / 3600 + h;
+    // 同一城市同一小时的模拟值固定,页被淘汰后重新获取时内容不变
+    QRandomGenerator random(uint(qHash(city)) ^ uint(hourIndex));
+    // 北京时间14点前后最热
+    const int localHour = int((hourIndex + 8) % 24);
+    ForecastHour hour;
+    hour.temperature =
+        18 + 6 * qSin((localHour - 8) * M_PI / 12) + random.bounded(4.0) - 2;
+    hour.humidity = 40 + random.bounded(40);
+    hour.windSpeed = 1 + random.bounded(10);
+    hour.weatherCondition = conditions.at(random.bounded(conditions.size()));
+    result.hours.append(hour);
+  }
+  return result;
+}
+
+void WeatherService::updateCurrentWeather(const WeatherSnapshot& snapshot) {
   // 更新天气数据
-  m_currentWeather->setCityName(city);
-  m_currentWeather->setTemperature(temperature);
-  m_currentWeather->setHumidity(humidity);
-  m_currentWeather->setWindSpeed(windSpeed);
-  m_currentWeather->setWeatherCondition(condition);
-  m_currentWeather->setLastUpdated(QDateTime::currentDateTime());
+  m_currentWeather->applySnapshot(snapshot);
+  cacheSnapshot(snapshot);
 
   // 清除错误信息
   if (!m_errorString.isEmpty()) {
@@ -144,3 +670,8 @@ void WeatherService::generateMockData(const QString& city) {
     emit errorStringChanged();
   }
 }
+
+void WeatherService::cacheSnapshot(const WeatherSnapshot& snapshot) {
+  m_snapshotCache.insert(snapshot.cityName, snapshot);
+  emit snapshotUpdated(snapshot);
+}
@@ -4,10 +4,14 @@
 #include <QNetworkAccessManager>
 #include <QNetworkReply>
 #include <QObject>
+#include <QSet>
 #include <QTimer>
 
+#include "core/ForecastPage.h"
+#include "core/WeatherCodec.h"
 #include "core/WeatherData.h"
 #include "models/CityModel.h"
+#include "services/WeatherProvider.h"
 
 class WeatherService : public QObject {
   Q_OBJECT
@@ -18,9 +22,18 @@ class WeatherService : public QObject {
   explicit WeatherService(QObject* parent = nullptr);
   ~WeatherService();
 
-  // 获取天气数据
-  Q_INVOKABLE void fetchWeather(const QString& city);
-  Q_INVOKABLE void fetchWeatherByIndex(int cityIndex);
+  // 获取天气数据(allowCached为true时可直接使用预取到的新鲜数据)
+  Q_INVOKABLE void fetchWeather(const QString& city, bool allowCached = true);
+  Q_INVOKABLE void fetchWeatherByIndex(int cityIndex, bool allowCached = true);
+
+  // 预取当前城市附近以及常用的城市
+  Q_INVOKABLE void prefetchAround(int cityIndex);
+  // 预取带宽预算: 同时在途的预取数与每分钟预取上限
+  void setPrefetchBudget(int maxInFlight, int perMinute);
+
+  // 注册天气数据源(按注册顺序作为主源/备用源);没有数据源时使用模拟数据
+  void addProvider(WeatherProvider* provider);
+  QList<WeatherProvider*> providers() const;
 
   // 获取当前天气数据对象
   WeatherData* currentWeather() const;
@@ -35,15 +48,37 @@ class WeatherService : public QObject {
   // 设置自动更新
   void setAutoUpdateInterval(int minutes);
 
+  // 多城市快照的二进制(CBOR)编码,用于采集端与显示端之间传输
+  // keyFrame为false时只编码相对上一帧变化的字段
+  QByteArray encodeSnapshots(bool keyFrame = false);
+  // 解码对端发来的帧并更新快照缓存
+  bool decodeSnapshots(const QByteArray& frame);
+  // 应用一个已解码的快照: 写入缓存,是当前城市时同时更新当前天气并发出weatherUpdated
+  void applySnapshot(const WeatherSnapshot& snapshot);
+  // 当前缓存的全部城市快照
+  QVector<WeatherSnapshot> cachedSnapshots() const;
+
+  // 逐小时预报: 请求城市自originSecs起的若干页(每页一天).
+  // 连续的页合并为一个请求,结果按页经forecastPagesReady返回;
+  // 没有支持预报的数据源时使用模拟数据
+  void fetchForecastPages(const QString& city, qint64 originSecs,
+                          QVector<int> pages);
+
  public slots:
   // 停止自动更新
   void stopAutoUpdate();
 
  signals:
   void weatherUpdated();
+  // 任一城市的快照写入缓存时发出(前台请求、预取、解码的帧),
+  // 不只是当前城市;缓存命中时会再次发出同一份快照
+  void snapshotUpdated(const WeatherSnapshot& snapshot);
   void weatherFetchFailed(const QString& error);
   void isLoadingChanged();
   void errorStringChanged();
+  void forecastPagesReady(const QVector<ForecastPage>& pages);
+  void forecastFetchFailed(const QString& city, qint64 originSecs,
+                           const QVector<int>& pages, const QString& error);
  private slots:
   void onNetworkReply(QNetworkReply* reply);
   void onAutoUpdate();
@@ -51,10 +86,53 @@ class WeatherService : public QObject {
  private:
   // 模拟天气数据(实际项目中应调用真实API)
   void fetchMockWeatherData(const QString& city);
-  // 解析JSON响应(模拟)
-  void parseWeatherResponse(const QByteArray& data, const QString& city);
   // 生成模拟数据器
   void generateMockData(const QString& city);
+  WeatherSnapshot generateMockSnapshot(const QString& city) const;
+  // 用快照更新当前天气并写入缓存
+  void updateCurrentWeather(const WeatherSnapshot& snapshot);
+  // 写入快照缓存并发出snapshotUpdated
+  void cacheSnapshot(const WeatherSnapshot& snapshot);
+
+  // 预取相关
+  void recordSelection(int cityIndex);
+  bool applyCachedWeather(const QString& city);
+  bool isFresh(const QString& city) const;
+  void pumpPrefetchQueue();
+  void onPrefetchFinished(const WeatherSnapshot& snapshot);
+
+  // 多数据源请求: 主源超过其p95未返回时向备用源发对冲请求,先成功者胜出
+  struct PendingFetch {
+    QString city;
+    bool foreground = true;
+    QList<int> triedProviders;
+    QList<QNetworkReply*> replies;
+    bool hedged = false;
+  };
+  void startProviderFetch(const QString& city, bool foreground);
+  int nextProvider(const PendingFetch& fetch);
+  void sendProviderRequest(quint64 fetchId, int providerIndex);
+  void onHedgeTimeout(quint64 fetchId);
+  // 新的前台请求开始: 取消在途的前台请求,之后晚到的前台结果一律丢弃
+  void supersedeForegroundFetch();
+  void completeFetch(quint64 fetchId, const QString& city, bool foreground,
+                     const WeatherSnapshot& snapshot);
+  void failFetch(quint64 fetchId, const QString& city, bool foreground,
+                 const QString& error);
+
+  // 逐小时预报请求: 同一城市连续的若干页,失败时依次转移到下一个数据源
+  struct PendingForecast {
+    QString city;
+    qint64 originSecs = 0;
+    int firstPage = 0;
+    int pageCount = 0;
+    QList<int> triedProviders;
+    QString lastError;
+  };
+  void sendForecastRequest(quint64 forecastId);
+  void onForecastReply(QNetworkReply* reply);
+  ForecastPage generateMockForecastPage(const QString& city, qint64 originSecs,
+                                        int page) const;
 
   QNetworkAccessManager* m_networkManager;
   WeatherData* m_currentWeather;
@@ -62,6 +140,37 @@ class WeatherService : public QObject {
   QTimer* m_autoUpdateTimer;
   bool m_isLoading;
   QString m_errorString;
+
+  // 每个城市最近一次的天气快照
+  QHash<QString, WeatherSnapshot> m_snapshotCache;
+  WeatherCodec m_snapshotEncoder;
+  WeatherCodec m_snapshotDecoder;
+
+  // 城市选择历史(频率+最近一次选择时间),用于挑选预取目标
+  struct SelectionStat {
+    int count = 0;
+    qint64 lastSelectedMs = 0;
+  };
+  QHash<int, SelectionStat> m_selectionHistory;
+
+  QStringList m_prefetchQueue;
+  QSet<QString> m_prefetchInFlight;
+  // 前台请求的城市恰好正在预取时,等预取完成后直接显示
+  QString m_pendingForegroundCity;
+  int m_prefetchMaxInFlight;
+  int m_prefetchPerMinute;
+  qint64 m_prefetchWindowStartMs;
+  int m_prefetchWindowCount;
+
+  QList<WeatherProvider*> m_providers;
+  QHash<quint64, PendingFetch> m_pendingFetches;
+  QHash<quint64, PendingForecast> m_pendingForecasts;
+  quint64 m_nextFetchId;
+  // 最近一次前台请求的编号,只有它的结果会更新当前天气
+  quint64 m_foregroundFetchId;
+  // 对冲请求计数,用于把额外请求量控制在总量的一小部分
+  qint64 m_providerRequestCount;
+  qint64 m_hedgeCount;
 };
 
 #endif  // WEATHERSERVICE_H
\ No newline at end of file
@@ -24,6 +24,8 @@ MainWindow::MainWindow(QWidget* parent)
 
 MainWindow::~MainWindow() {}
 
+WeatherService* MainWindow::weatherService() const { return m_weatherService; }
+
 void MainWindow::setupUI() {
   // 创建主部件
   m_weatherWidget = new WeatherWidget(this);
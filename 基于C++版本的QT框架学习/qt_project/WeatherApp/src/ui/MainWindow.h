@@ -15,6 +15,8 @@ class MainWindow : public QMainWindow {
   MainWindow(QWidget* parent = nullptr);
   ~MainWindow();
 
+  WeatherService* weatherService() const;
+
  private slots:
   void onAbout();
   void onExit();
@@ -0,0 +1,233 @@
+#include "SparklineWidget.h"
+
+#include <QPaintEvent>
+#include <QtMath>
+
+#include <cstring>
+
+namespace {
+// 选点缓冲比可见桶数多出的余量
+const int kBucketMargin = 4;
+// 纵轴范围扩展时额外留出的比例
+const double kRangePadding = 0.1;
+// 新样本改变最后3个桶的选点,连到它们的线段从倒数第4个桶开始;
+// 尾部竖带从那一列再往左留1列抗锯齿边缘
+const int kTailBuckets = 4;
+}  // namespace
+
+SparklineWidget::SparklineWidget(int capacity, QWidget* parent)
+    : QWidget(parent),
+      m_samples(qMax(2, capacity), 0.0),
+      m_total(0),
+      m_samplesPerBucket(1),
+      m_firstBucket(0),
+      m_lastBucket(-1),
+      m_minValue(0.0),
+      m_maxValue(0.0),
+      m_color(Qt::darkCyan),
+      m_cacheValid(false) {
+  setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
+}
+
+QSize SparklineWidget::sizeHint() const { return QSize(120, 24); }
+
+int SparklineWidget::sampleCount() const {
+  return int(qMin<qint64>(m_total, m_samples.size()));
+}
+
+void SparklineWidget::setColor(const QColor& color) {
+  m_color = color;
+  m_cacheValid = false;
+  update();
+}
+
+void SparklineWidget::clear() {
+  m_total = 0;
+  m_cacheValid = false;
+  update();
+}
+
+void SparklineWidget::addSample(double value) {
+  m_samples[int(m_total % m_samples.size())] = value;
+  m_total++;
+
+  // 尚未绘制过,等paintEvent整体重建
+  if (!m_cacheValid) {
+    update();
+    return;
+  }
+
+  const qint64 newLast = (m_total - 1) / m_samplesPerBucket;
+  const qint64 shift = newLast - m_lastBucket;
+  m_lastBucket = newLast;
+  m_firstBucket = qMax(m_firstBucket, newLast - plotRect().width() + 1);
+
+  // 只有最后两个桶的选点会因新样本而改变
+  const qint64 from = qMax(m_firstBucket, newLast - 2);
+  for (qint64 b = from; b <= newLast; ++b) {
+    selectBucket(b);
+    const double v = m_bucketValues.at(slotOf(b));
+    if (v < m_minValue || v > m_maxValue) {
+      m_cacheValid = false;
+      update();
+      return;
+    }
+  }
+
+  if (shift > 0) scrollCache(int(qMin<qint64>(shift, m_cache.width())));
+  redrawTail();
+}
+
+void SparklineWidget::paintEvent(QPaintEvent* event) {
+  if (!m_cacheValid || m_cache.size() != size()) rebuild();
+
+  QPainter painter(this);
+  painter.drawImage(event->rect(), m_cache, event->rect());
+}
+
+void SparklineWidget::resizeEvent(QResizeEvent* event) {
+  QWidget::resizeEvent(event);
+  m_cacheValid = false;
+}
+
+QRect SparklineWidget::plotRect() const { return rect().adjusted(1, 2, -2, -2); }
+
+qint64 SparklineWidget::oldestSample() const {
+  return m_total - sampleCount();
+}
+
+double SparklineWidget::sampleAt(qint64 index) const {
+  return m_samples.at(int(index % m_samples.size()));
+}
+
+int SparklineWidget::slotOf(qint64 bucket) const {
+  return int(bucket % m_bucketValues.size());
+}
+
+void SparklineWidget::selectBucket(qint64 bucket) {
+  const qint64 k = m_samplesPerBucket;
+  const qint64 begin = qMax(bucket * k, oldestSample());
+  const qint64 end = qMin((bucket + 1) * k, m_total);
+  if (begin >= end) return;  // 样本已移出缓冲区,保留原有选点
+
+  qint64 chosen = begin;
+  if (bucket == m_lastBucket) {
+    // 最后一个桶总是取最新样本
+    chosen = end - 1;
+  } else if (bucket > m_firstBucket) {
+    // 前一个桶的选中点
+    const double ax = m_bucketSamples.at(slotOf(bucket - 1));
+    const double ay = m_bucketValues.at(slotOf(bucket - 1));
+
+    // 后一个桶(可能尚未填满)的均值
+    const qint64 nextBegin = end;
+    const qint64 nextEnd = qMin(nextBegin + k, m_total);
+    double cx = 0.0, cy = 0.0;
+    for (qint64 i = nextBegin; i < nextEnd; ++i) {
+      cx += i;
+      cy += sampleAt(i);
+    }
+    const qint64 n = nextEnd - nextBegin;
+    cx /= n;
+    cy /= n;
+
+    double maxArea = -1.0;
+    for (qint64 i = begin; i < end; ++i) {
+      const double area =
+          qAbs((ax - cx) * (sampleAt(i) - ay) - (ax - i) * (cy - ay));
+      if (area > maxArea) {
+        maxArea = area;
+        chosen = i;
+      }
+    }
+  }
+
+  m_bucketSamples[slotOf(bucket)] = chosen;
+  m_bucketValues[slotOf(bucket)] = sampleAt(chosen);
+}
+
+QPointF SparklineWidget::bucketPoint(qint64 bucket) const {
+  // 每个桶占一个像素列,最新的桶在最右侧
+  const QRect plot = plotRect();
+  const double x = plot.right() - double(m_lastBucket - bucket);
+  const double span = m_maxValue - m_minValue;
+  const double t =
+      span > 0 ? (m_bucketValues.at(slotOf(bucket)) - m_minValue) / span : 0.5;
+  return QPointF(x, plot.bottom() - t * plot.height());
+}
+
+void SparklineWidget::rebuild() {
+  // 画家一直停留在缓存图像上,换图像前先结束
+  if (m_painter.isActive()) m_painter.end();
+  m_cache = QImage(size(), QImage::Format_ARGB32_Premultiplied);
+  m_cacheValid = !m_cache.isNull();
+  if (!m_cacheValid) return;
+  m_cache.fill(Qt::transparent);
+  m_painter.begin(&m_cache);
+  m_painter.setRenderHint(QPainter::Antialiasing);
+  m_painter.setPen(QPen(m_color, 1.2));
+
+  const QRect plot = plotRect();
+  const int tailLeft = qMax(0, plot.right() - kTailBuckets);
+  m_tailStrip = QRect(tailLeft, 0, width() - tailLeft, height());
+
+  const int buckets = qMax(1, plot.width());
+  m_samplesPerBucket = qMax<qint64>(1, (m_samples.size() + buckets - 1) / buckets);
+  m_bucketSamples.fill(0, buckets + kBucketMargin);
+  m_bucketValues.fill(0.0, buckets + kBucketMargin);
+
+  if (m_total == 0) {
+    m_firstBucket = 0;
+    m_lastBucket = -1;
+  } else {
+    m_lastBucket = (m_total - 1) / m_samplesPerBucket;
+    m_firstBucket =
+        qMax(oldestSample() / m_samplesPerBucket, m_lastBucket - buckets + 1);
+
+    double low = 0.0, high = 0.0;
+    for (qint64 b = m_firstBucket; b <= m_lastBucket; ++b) {
+      selectBucket(b);
+      const double v = m_bucketValues.at(slotOf(b));
+      low = b == m_firstBucket ? v : qMin(low, v);
+      high = b == m_firstBucket ? v : qMax(high, v);
+    }
+    const double padding = qMax((high - low) * kRangePadding, 0.5);
+    m_minValue = low - padding;
+    m_maxValue = high + padding;
+
+    m_path.clear();
+    for (qint64 b = m_firstBucket; b <= m_lastBucket; ++b)
+      m_path.append(bucketPoint(b));
+    m_painter.drawPolyline(m_path);
+  }
+
+  // 此后只做增量重画,裁剪区固定为尾部竖带
+  m_painter.setClipRect(m_tailStrip);
+}
+
+// 缓存整体左移shift列,右侧露出的列清为透明(预乘格式下即全0)
+void SparklineWidget::scrollCache(int shift) {
+  const int w = m_cache.width();
+  const size_t kept = size_t(w - shift) * sizeof(QRgb);
+  for (int y = 0; y < m_cache.height(); ++y) {
+    uchar* line = m_cache.scanLine(y);
+    std::memmove(line, line + size_t(shift) * sizeof(QRgb), kept);
+    std::memset(line + kept, 0, size_t(shift) * sizeof(QRgb));
+  }
+}
+
+void SparklineWidget::redrawTail() {
+  // 清空尾部竖带,再从竖带左侧两个桶起重画(这两段线的边缘落在竖带内),
+  // 画家的裁剪区就是竖带,与左侧未动的部分正好接上
+  const int left = m_tailStrip.left();
+  const size_t bytes = size_t(m_cache.width() - left) * sizeof(QRgb);
+  for (int y = 0; y < m_cache.height(); ++y)
+    std::memset(m_cache.scanLine(y) + size_t(left) * sizeof(QRgb), 0, bytes);
+
+  const qint64 start = qMax(m_firstBucket, m_lastBucket - kTailBuckets - 1);
+  m_path.clear();
+  for (qint64 b = start; b <= m_lastBucket; ++b) m_path.append(bucketPoint(b));
+  m_painter.drawPolyline(m_path);
+
+  update(m_tailStrip);
+}
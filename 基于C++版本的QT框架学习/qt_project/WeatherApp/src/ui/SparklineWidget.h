@@ -0,0 +1,79 @@
+#ifndef SPARKLINEWIDGET_H
+#define SPARKLINEWIDGET_H
+
+#include <QColor>
+#include <QImage>
+#include <QPainter>
+#include <QPolygonF>
+#include <QVector>
+#include <QWidget>
+
+/**
+ * 迷你趋势图(sparkline)
+ *
+ * 样本保存在固定容量的环形缓冲区中.绘制前按像素宽度做LTTB
+ * (Largest-Triangle-Three-Buckets)降采样,每个像素列对应一个桶.
+ * 桶按样本的绝对序号划分,新样本只会影响最后两个桶的选点,
+ * 因此追加样本时只需平移缓存位图并重画最右侧的一小段;
+ * 只有尺寸变化或数值超出当前纵轴范围时才整体重建.
+ *
+ * 缓存是一张QImage,重建后QPainter一直停留在它上面,裁剪区固定为尾部竖带;
+ * 平移与清空直接操作像素,折线顶点用成员缓冲区,稳态追加样本不再分配内存.
+ */
+class SparklineWidget : public QWidget {
+  Q_OBJECT
+
+ public:
+  explicit SparklineWidget(int capacity = 1024, QWidget* parent = nullptr);
+
+  void addSample(double value);
+  void clear();
+  int sampleCount() const;
+
+  void setColor(const QColor& color);
+
+  QSize sizeHint() const override;
+
+ protected:
+  void paintEvent(QPaintEvent* event) override;
+  void resizeEvent(QResizeEvent* event) override;
+
+ private:
+  QRect plotRect() const;
+  qint64 oldestSample() const;
+  double sampleAt(qint64 index) const;
+
+  // LTTB: 为桶b选出与前一选中点、后一桶均值构成最大三角形的样本
+  void selectBucket(qint64 bucket);
+  int slotOf(qint64 bucket) const;
+  QPointF bucketPoint(qint64 bucket) const;
+
+  void rebuild();
+  void scrollCache(int shift);
+  void redrawTail();
+
+  // 样本环形缓冲区
+  QVector<double> m_samples;
+  qint64 m_total;
+
+  // 每个桶(像素列)选中的样本
+  QVector<qint64> m_bucketSamples;
+  QVector<double> m_bucketValues;
+  qint64 m_samplesPerBucket;
+  qint64 m_firstBucket;
+  qint64 m_lastBucket;
+
+  // 纵轴范围(带余量,减少重建次数)
+  double m_minValue;
+  double m_maxValue;
+
+  QColor m_color;
+  // 画家在图像之后声明,先于图像析构
+  QImage m_cache;
+  QPainter m_painter;
+  QPolygonF m_path;
+  QRect m_tailStrip;
+  bool m_cacheValid;
+};
+
+#endif  // SPARKLINEWIDGET_H
@@ -1,13 +1,30 @@
 #include "WeatherWidget.h"
 
+#include <QAbstractItemView>
 #include <QApplication>
 #include <QCoreApplication>
+#include <QEvent>
 #include <QFormLayout>
+#include <QHeaderView>
 #include <QMessageBox>
 
+namespace {
+// 状态信息的显示时长
+const int kStatusTimeoutMs = 3000;
+}  // namespace
+
 WeatherWidget::WeatherWidget(QWidget* parent)
-    : QWidget(parent), m_weatherService(nullptr) {
+    : QWidget(parent),
+      m_forecastModel(nullptr),
+      m_weatherService(nullptr),
+      m_statusTimer(new QTimer(this)),
+      m_conditionStyle(-1) {
   setupUI();
+
+  // 复用同一个定时器清除状态,避免每次刷新都创建单次定时器
+  m_statusTimer->setSingleShot(true);
+  connect(m_statusTimer, &QTimer::timeout, this,
+          &WeatherWidget::onStatusTimeout);
 }
 
 WeatherWidget::~WeatherWidget() {}
@@ -19,21 +36,36 @@ void WeatherWidget::setWeatherService(WeatherService* service) {
   if (m_weatherService) {
     disconnect(m_weatherService, &WeatherService::weatherUpdated, this,
                &WeatherWidget::onWeatherUpdated);
+    disconnect(m_weatherService, &WeatherService::snapshotUpdated, this,
+               &WeatherWidget::onSnapshotUpdated);
     disconnect(m_weatherService, &WeatherService::weatherFetchFailed, this,
                &WeatherWidget::onWeatherFetchError);
   }
 
   m_weatherService = service;
+
+  // 预报模型绑定在服务上,换服务时重建
+  m_forecastView->setModel(nullptr);
+  delete m_forecastModel;
+  m_forecastModel = nullptr;
+
   // 服务的连接
   if (m_weatherService) {
     connect(m_weatherService, &WeatherService::weatherUpdated, this,
             &WeatherWidget::onWeatherUpdated);
+    connect(m_weatherService, &WeatherService::snapshotUpdated, this,
+            &WeatherWidget::onSnapshotUpdated);
     connect(m_weatherService, &WeatherService::weatherFetchFailed, this,
             &WeatherWidget::onWeatherFetchError);
 
     // 设置城市下拉框模型
     m_cityComboBox->setModel(m_weatherService->cityModel());
 
+    m_forecastModel = new ForecastModel(m_weatherService, this);
+    m_forecastView->setModel(m_forecastModel);
+    m_forecastModel->setCity(m_weatherService->cityModel()->getCityName(
+        m_cityComboBox->currentIndex()));
+
     // 更新显示
     updateWeatherDisplay();
   }
@@ -47,6 +79,7 @@ void WeatherWidget::setupUI() {
 
   m_cityComboBox = new QComboBox();
   m_cityComboBox->setMinimumWidth(150);
+  m_cityComboBox->view()->installEventFilter(this);
 
   m_refreshButton = new QPushButton("刷新");
   m_refreshButton->setIcon(
@@ -68,15 +101,39 @@ void WeatherWidget::setupUI() {
   m_conditionLabel = new QLabel("--");
   m_updateTimeLabel = new QLabel("--");
 
+  // 温度和风速旁边显示趋势图
+  m_tempTrend = new QStackedWidget();
+  m_windTrend = new QStackedWidget();
+  QHBoxLayout* tempLayout = new QHBoxLayout();
+  tempLayout->addWidget(m_tempLabel);
+  tempLayout->addWidget(m_tempTrend, 1);
+  QHBoxLayout* windLayout = new QHBoxLayout();
+  windLayout->addWidget(m_windLabel);
+  windLayout->addWidget(m_windTrend, 1);
+
   formLayout->addRow("城市", m_cityComboBox);
-  formLayout->addRow("温度", m_tempLabel);
+  formLayout->addRow("温度", tempLayout);
   formLayout->addRow("湿度", m_humidityLabel);
-  formLayout->addRow("风速", m_windLabel);
+  formLayout->addRow("风速", windLayout);
   formLayout->addRow("天气", m_conditionLabel);
   formLayout->addRow("更新时间", m_updateTimeLabel);
 
   weatherGroup->setLayout(formLayout);
 
+  // 逐小时预报: 行高固定,视图只为可见行取数据
+  QGroupBox* forecastGroup = new QGroupBox("逐小时预报");
+  QVBoxLayout* forecastLayout = new QVBoxLayout();
+  m_forecastView = new QTableView();
+  m_forecastView->verticalHeader()->hide();
+  m_forecastView->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+  m_forecastView->verticalHeader()->setDefaultSectionSize(
+      m_forecastView->fontMetrics().height() + 6);
+  m_forecastView->horizontalHeader()->setStretchLastSection(true);
+  m_forecastView->setSelectionBehavior(QAbstractItemView::SelectRows);
+  m_forecastView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+  forecastLayout->addWidget(m_forecastView);
+  forecastGroup->setLayout(forecastLayout);
+
   // 状态标签
   m_statusLabel = new QLabel("就绪");
   m_statusLabel->setAlignment(Qt::AlignCenter);
@@ -84,8 +141,8 @@ void WeatherWidget::setupUI() {
   // 添加到主布局
   mainLayout->addLayout(controlLayout);
   mainLayout->addWidget(weatherGroup);
+  mainLayout->addWidget(forecastGroup, 1);
   mainLayout->addWidget(m_statusLabel);
-  mainLayout->addStretch();
 
   setLayout(mainLayout);
   setMinimumSize(400, 300);
@@ -96,56 +153,122 @@ void WeatherWidget::setupConnetions() {
       m_cityComboBox,
       static_cast<void (QComboBox::*)(int)>(&QComboBox::currentIndexChanged),
       this, &WeatherWidget::onCityChanged);
+  connect(m_cityComboBox,
+          static_cast<void (QComboBox::*)(int)>(&QComboBox::highlighted), this,
+          &WeatherWidget::onCityHighlighted);
 
   connect(m_refreshButton, &QPushButton::clicked, this,
           &WeatherWidget::onRefreshClicked);
 }
+bool WeatherWidget::eventFilter(QObject* watched, QEvent* event) {
+  if (watched == m_cityComboBox->view() && event->type() == QEvent::Show &&
+      m_weatherService) {
+    m_weatherService->prefetchAround(m_cityComboBox->currentIndex());
+  }
+  return QWidget::eventFilter(watched, event);
+}
+
 void WeatherWidget::onCityChanged(int index) {
   if (m_weatherService && index >= 0) {
-    m_weatherService->fetchWeatherByIndex(index);
+    // 命中预取缓存时会同步发出weatherUpdated,状态需先设置
     m_statusLabel->setText("正在获取天气数据...");
+    m_weatherService->fetchWeatherByIndex(index);
+    m_weatherService->prefetchAround(index);
+    if (m_forecastModel)
+      m_forecastModel->setCity(
+          m_weatherService->cityModel()->getCityName(index));
+  }
+}
+void WeatherWidget::onCityHighlighted(int index) {
+  if (m_weatherService && index >= 0) {
+    m_weatherService->prefetchAround(index);
   }
 }
 void WeatherWidget::onRefreshClicked() {
   if (m_weatherService && m_cityComboBox->currentIndex() >= 0) {
-    m_weatherService->fetchWeatherByIndex(m_cityComboBox->currentIndex());
+    // 刷新总是绕过缓存
     m_statusLabel->setText("正在刷新天气数据");
+    m_weatherService->fetchWeatherByIndex(m_cityComboBox->currentIndex(),
+                                          false);
   }
 }
 void WeatherWidget::onWeatherUpdated() {
   updateWeatherDisplay();
-  m_statusLabel->setText("天气数据已更新");
+  showCurrentTrend();
+  static const QString updatedText = QStringLiteral("天气数据已更新");
+  m_statusLabel->setText(updatedText);
 
-  // 3秒后清除状态信息
-  QTimer::singleShot(3000, this, [this]() { m_statusLabel->setText("就绪"); });
+  // 3秒后清除状态信息;定时器已在运行时只刷新起点
+  m_statusClock.start();
+  if (!m_statusTimer->isActive()) m_statusTimer->start(kStatusTimeoutMs);
+}
+void WeatherWidget::onStatusTimeout() {
+  const qint64 remaining = kStatusTimeoutMs - m_statusClock.elapsed();
+  if (remaining > 0) {
+    m_statusTimer->start(int(remaining));
+    return;
+  }
+  static const QString readyText = QStringLiteral("就绪");
+  m_statusLabel->setText(readyText);
 }
 void WeatherWidget::onWeatherFetchError(const QString& error) {
   m_statusLabel->setText("获取天气数据失败");
   QMessageBox::warning(this, "错误", "无法获取天气数据: " + error);
 }
 
+void WeatherWidget::onSnapshotUpdated(const WeatherSnapshot& snapshot) {
+  if (snapshot.cityName.isEmpty()) return;
+
+  // 缓存命中会再次发出同一份快照,只有更新时间推进了才追加样本
+  CityTrend& trend = trendFor(snapshot.cityName);
+  if (snapshot.lastUpdatedSecs <= trend.lastUpdatedSecs) return;
+  trend.lastUpdatedSecs = snapshot.lastUpdatedSecs;
+  trend.temperature->addSample(snapshot.temperature);
+  trend.wind->addSample(snapshot.windSpeed);
+}
+
+WeatherWidget::CityTrend& WeatherWidget::trendFor(const QString& city) {
+  auto it = m_trends.find(city);
+  if (it == m_trends.end()) {
+    CityTrend trend;
+    trend.temperature = new SparklineWidget();
+    trend.temperature->setColor(QColor(Qt::darkRed));
+    m_tempTrend->addWidget(trend.temperature);
+    trend.wind = new SparklineWidget();
+    trend.wind->setColor(QColor(Qt::darkCyan));
+    m_windTrend->addWidget(trend.wind);
+    it = m_trends.insert(city, trend);
+  }
+  return it.value();
+}
+
+void WeatherWidget::showCurrentTrend() {
+  if (!m_weatherService || !m_weatherService->currentWeather()) return;
+
+  auto it = m_trends.constFind(m_weatherService->currentWeather()->cityName());
+  if (it == m_trends.cend()) return;
+  m_tempTrend->setCurrentWidget(it->temperature);
+  m_windTrend->setCurrentWidget(it->wind);
+}
+
 void WeatherWidget::updateWeatherDisplay() {
   if (!m_weatherService || !m_weatherService->currentWeather()) return;
 
   WeatherData* weather = m_weatherService->currentWeather();
 
+  // 文本来自预生成表或复用缓冲区;QLabel对相同文本不会重新布局
   m_cityLabel->setText(weather->cityName());
-  m_tempLabel->setText(QString("%1°C").arg(weather->temperature(), 0, 'f', 1));
-  m_humidityLabel->setText(QString("%1%").arg(weather->humidity()));
-  m_windLabel->setText(QString("%1 km/h").arg(weather->windSpeed(), 0, 'f', 1));
+  m_tempLabel->setText(m_formatter.temperatureText(weather->temperature()));
+  m_humidityLabel->setText(m_formatter.humidityText(weather->humidity()));
+  m_windLabel->setText(m_formatter.windSpeedText(weather->windSpeed()));
   m_conditionLabel->setText(weather->weatherCondition());
-  m_updateTimeLabel->setText(
-      weather->lastUpdated().toString("yyyy-MM-dd hh:mm:ss"));
-
-  // 根据天气条件设置图标或样式
-  QString condition = weather->weatherCondition();
-  if (condition.contains("雨")) {
-    m_conditionLabel->setStyleSheet("color: blue; font-weight: bold;");
-  } else if (condition.contains("晴")) {
-    m_conditionLabel->setStyleSheet("color: orange; font-weight: bold;");
-  } else if (condition.contains("雪")) {
-    m_conditionLabel->setStyleSheet("color: gray; font-weight: bold;");
-  } else {
-    m_conditionLabel->setStyleSheet("");
+  m_updateTimeLabel->setText(m_formatter.timeText(weather->lastUpdated()));
+
+  // 根据天气条件设置样式,只在类别变化时重设样式表(重设代价很高)
+  const WeatherFormatter::ConditionStyle style =
+      WeatherFormatter::conditionStyle(weather->weatherCondition());
+  if (style != m_conditionStyle) {
+    m_conditionStyle = style;
+    m_conditionLabel->setStyleSheet(WeatherFormatter::styleSheet(style));
   }
 }
@@ -2,12 +2,21 @@
 #define WEATHERWIDGET_H
 
 #include <QComboBox>
+#include <QElapsedTimer>
 #include <QGroupBox>
 #include <QHBoxLayout>
 #include <QLabel>
 #include <QPushButton>
+#include <QStackedWidget>
+#include <QTableView>
+#include <QTimer>
 #include <QWidget>
 
+#include <limits>
+
+#include "SparklineWidget.h"
+#include "core/WeatherFormatter.h"
+#include "models/ForecastModel.h"
 #include "services/WeatherService.h"
 
 class WeatherWidget : public QWidget {
@@ -20,16 +29,32 @@ class WeatherWidget : public QWidget {
   // 设置天气服务
   void setWeatherService(WeatherService* service);
 
+ protected:
+  // 监听下拉列表弹出,提前预取相邻城市
+  bool eventFilter(QObject* watched, QEvent* event) override;
+
  private slots:
   void onCityChanged(int index);
+  void onCityHighlighted(int index);
   void onRefreshClicked();
   void onWeatherUpdated();
+  void onSnapshotUpdated(const WeatherSnapshot& snapshot);
   void onWeatherFetchError(const QString& error);
   void updateWeatherDisplay();
+  void onStatusTimeout();
 
  private:
   void setupUI();
   void setupConnetions();
+  // 每个城市一组温度/风速趋势图,以及最后一个样本的更新时间
+  struct CityTrend {
+    SparklineWidget* temperature = nullptr;
+    SparklineWidget* wind = nullptr;
+    qint64 lastUpdatedSecs = std::numeric_limits<qint64>::min();
+  };
+  CityTrend& trendFor(const QString& city);
+  // 趋势图切换到当前城市
+  void showCurrentTrend();
 
   // UI组件
   QComboBox* m_cityComboBox;
@@ -42,8 +67,23 @@ class WeatherWidget : public QWidget {
   QLabel* m_updateTimeLabel;
   QLabel* m_statusLabel;
 
+  // 每个城市各自的温度/风速趋势图,切换城市时切换页面
+  QStackedWidget* m_tempTrend;
+  QStackedWidget* m_windTrend;
+  QHash<QString, CityTrend> m_trends;
+
+  // 当前城市的逐小时预报,滚动到底时按天加载
+  QTableView* m_forecastView;
+  ForecastModel* m_forecastModel;
+
   // 服务
   WeatherService* m_weatherService;
+
+  // 刷新路径上复用的格式化器与状态定时器
+  WeatherFormatter m_formatter;
+  QTimer* m_statusTimer;
+  QElapsedTimer m_statusClock;
+  int m_conditionStyle;
 };
 
 #endif  // WEATHERWIDGET_H
@@ -0,0 +1,225 @@
+// tests/ProviderFailoverTest.cpp
+// 用本地QTcpServer做替身天气源,验证WeatherService的多数据源逻辑:
+// 超过主源p95后的对冲请求、出错时的故障转移、熔断器的打开/半开/恢复,
+// 以及被新的前台请求取代的旧请求不会覆盖当前天气.
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QNetworkProxy>
+#include <QSignalSpy>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTimer>
+#include <QtTest>
+
+#include "services/WeatherProvider.h"
+#include "services/WeatherService.h"
+
+namespace {
+// 未积累足够样本时WeatherService使用的对冲延迟
+const qint64 kDefaultHedgeDelayMs = 1000;
+const int kWaitMs = 3000;
+}  // namespace
+
+// 替身HTTP服务器: 每个连接处理一个GET,按当前设定延迟后返回JSON天气或HTTP 500
+class StandInServer : public QTcpServer {
+  Q_OBJECT
+
+ public:
+  explicit StandInServer(double temperature, QObject* parent = nullptr)
+      : QTcpServer(parent), m_temperature(temperature) {
+    connect(this, &QTcpServer::newConnection, this,
+            &StandInServer::onNewConnection);
+    listen(QHostAddress::LocalHost);
+  }
+
+  QUrl url() const {
+    return QUrl(QString("http://127.0.0.1:%1/weather").arg(serverPort()));
+  }
+
+  int delayMs = 0;
+  bool failing = false;
+  int requestCount = 0;
+  qint64 lastRequestMs = 0;
+
+ private slots:
+  void onNewConnection() {
+    while (QTcpSocket* socket = nextPendingConnection()) {
+      connect(socket, &QTcpSocket::readyRead, this,
+              [this, socket]() { onReadyRead(socket); });
+      connect(socket, &QTcpSocket::disconnected, socket,
+              &QObject::deleteLater);
+    }
+  }
+
+ private:
+  void onReadyRead(QTcpSocket* socket) {
+    QByteArray request = socket->property("request").toByteArray();
+    request += socket->readAll();
+    socket->setProperty("request", request);
+    if (!request.contains("\r\n\r\n")) return;
+
+    requestCount++;
+    lastRequestMs = QDateTime::currentMSecsSinceEpoch();
+    const bool fail = failing;
+    const double temperature = m_temperature;
+    // 客户端取消请求时连接随之关闭,以socket为上下文的定时回调不再执行
+    QTimer::singleShot(delayMs, socket, [socket, fail, temperature]() {
+      QByteArray response;
+      if (fail) {
+        response =
+            "HTTP/1.1 500 Internal Server Error\r\n"
+            "Content-Length: 0\r\nConnection: close\r\n\r\n";
+      } else {
+        const QByteArray body =
+            QString("{\"temperature\":%1,\"humidity\":40,\"windSpeed\":3,"
+                    "\"condition\":\"晴朗\",\"updated\":%2}")
+                .arg(temperature)
+                .arg(QDateTime::currentSecsSinceEpoch())
+                .toUtf8();
+        response = "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\n"
+                   "Connection: close\r\nContent-Length: " +
+                   QByteArray::number(body.size()) + "\r\n\r\n" + body;
+      }
+      socket->write(response);
+      socket->disconnectFromHost();
+    });
+  }
+
+  double m_temperature;
+};
+
+class ProviderFailoverTest : public QObject {
+  Q_OBJECT
+
+ private slots:
+  void initTestCase();
+  void hedgesAfterPrimaryP95();
+  void failsOverOnError();
+  void breakerOpensAndHalfOpens();
+  void dropsSupersededForegroundFetch();
+};
+
+void ProviderFailoverTest::initTestCase() {
+  // 替身服务器在本机,不经过环境变量里的代理
+  QNetworkProxy::setApplicationProxy(QNetworkProxy::NoProxy);
+}
+
+void ProviderFailoverTest::hedgesAfterPrimaryP95() {
+  StandInServer primary(10.0), secondary(20.0);
+  primary.delayMs = 5000;
+
+  WeatherService service;
+  auto* primaryProvider = new JsonWeatherProvider("primary", primary.url());
+  service.addProvider(primaryProvider);
+  service.addProvider(new JsonWeatherProvider("secondary", secondary.url()));
+  // 主源观测到的p95为100ms,样本数足以启用按p95对冲
+  for (int i = 0; i < 40; ++i) primaryProvider->latency().addSample(100);
+
+  QSignalSpy updated(&service, &WeatherService::weatherUpdated);
+  service.fetchWeather("北京", false);
+  QVERIFY(updated.wait(kWaitMs));
+
+  // 备用源先返回并胜出,对冲请求在p95之后、默认对冲延迟之前发出
+  QCOMPARE(service.currentWeather()->temperature(), 20.0);
+  QCOMPARE(primary.requestCount, 1);
+  QCOMPARE(secondary.requestCount, 1);
+  const qint64 hedgeDelay = secondary.lastRequestMs - primary.lastRequestMs;
+  QVERIFY2(hedgeDelay >= 90 && hedgeDelay < kDefaultHedgeDelayMs,
+           qPrintable(QString("hedge after %1 ms").arg(hedgeDelay)));
+  // 落败的主源请求被取消,不算作失败
+  QCOMPARE(primaryProvider->breaker().state(), CircuitBreaker::Closed);
+}
+
+void ProviderFailoverTest::failsOverOnError() {
+  StandInServer primary(10.0), secondary(20.0);
+  primary.failing = true;
+
+  WeatherService service;
+  auto* primaryProvider = new JsonWeatherProvider("primary", primary.url());
+  service.addProvider(primaryProvider);
+  service.addProvider(new JsonWeatherProvider("secondary", secondary.url()));
+
+  QSignalSpy updated(&service, &WeatherService::weatherUpdated);
+  QSignalSpy failed(&service, &WeatherService::weatherFetchFailed);
+  QElapsedTimer clock;
+  clock.start();
+  service.fetchWeather("北京", false);
+  QVERIFY(updated.wait(kWaitMs));
+
+  // 主源出错后立即转移,不等对冲延迟
+  QVERIFY(clock.elapsed() < kDefaultHedgeDelayMs);
+  QCOMPARE(service.currentWeather()->temperature(), 20.0);
+  QCOMPARE(primary.requestCount, 1);
+  QCOMPARE(secondary.requestCount, 1);
+  QCOMPARE(failed.count(), 0);
+  QCOMPARE(primaryProvider->breaker().state(), CircuitBreaker::Closed);
+}
+
+void ProviderFailoverTest::breakerOpensAndHalfOpens() {
+  StandInServer primary(10.0), secondary(20.0);
+  primary.failing = true;
+
+  WeatherService service;
+  auto* primaryProvider = new JsonWeatherProvider("primary", primary.url());
+  service.addProvider(primaryProvider);
+  service.addProvider(new JsonWeatherProvider("secondary", secondary.url()));
+  // 连续3次失败打开,冷却300ms
+  primaryProvider->breaker() = CircuitBreaker(3, 300);
+  QSignalSpy updated(&service, &WeatherService::weatherUpdated);
+
+  for (int i = 0; i < 3; ++i) {
+    service.fetchWeather("北京", false);
+    QVERIFY(updated.wait(kWaitMs));
+  }
+  QCOMPARE(primary.requestCount, 3);
+  QCOMPARE(primaryProvider->breaker().state(), CircuitBreaker::Open);
+
+  // 打开期间主源不再收到请求,直接使用备用源
+  service.fetchWeather("北京", false);
+  QVERIFY(updated.wait(kWaitMs));
+  QCOMPARE(primary.requestCount, 3);
+  QCOMPARE(secondary.requestCount, 4);
+
+  // 冷却后放行一次试探;试探失败则重新打开
+  QTest::qWait(400);
+  service.fetchWeather("北京", false);
+  QCOMPARE(primaryProvider->breaker().state(), CircuitBreaker::HalfOpen);
+  QVERIFY(updated.wait(kWaitMs));
+  QCOMPARE(primary.requestCount, 4);
+  QCOMPARE(primaryProvider->breaker().state(), CircuitBreaker::Open);
+
+  // 再次冷却后试探成功,恢复闭合并由主源提供数据
+  primary.failing = false;
+  QTest::qWait(400);
+  service.fetchWeather("北京", false);
+  QCOMPARE(primaryProvider->breaker().state(), CircuitBreaker::HalfOpen);
+  QVERIFY(updated.wait(kWaitMs));
+  QCOMPARE(primary.requestCount, 5);
+  QCOMPARE(primaryProvider->breaker().state(), CircuitBreaker::Closed);
+  QCOMPARE(service.currentWeather()->temperature(), 10.0);
+}
+
+void ProviderFailoverTest::dropsSupersededForegroundFetch() {
+  StandInServer server(10.0);
+  server.delayMs = 300;
+
+  WeatherService service;
+  service.addProvider(new JsonWeatherProvider("primary", server.url()));
+
+  QSignalSpy updated(&service, &WeatherService::weatherUpdated);
+  QSignalSpy failed(&service, &WeatherService::weatherFetchFailed);
+  service.fetchWeather("北京", false);
+  service.fetchWeather("上海", false);
+  QVERIFY(updated.wait(kWaitMs));
+  QCOMPARE(service.currentWeather()->cityName(), QString("上海"));
+
+  // 被取代的请求不会晚到覆盖当前城市,也不会报错
+  QVERIFY(!updated.wait(2 * server.delayMs));
+  QCOMPARE(updated.count(), 1);
+  QCOMPARE(failed.count(), 0);
+  QCOMPARE(service.currentWeather()->cityName(), QString("上海"));
+}
+
+QTEST_GUILESS_MAIN(ProviderFailoverTest)
+
+#include "ProviderFailoverTest.moc"
@@ -0,0 +1,135 @@
+// 航点CSV加载速度与读文件带宽的对比
+//
+// 生成N行与interduce.txt格式一致的CSV(坐标保留20位小数),
+// 先测量read()读完整个文件的带宽作为上限,再用不同线程数加载,
+// 输出吞吐量及其占读带宽的比例,并抽查解析结果与strtod一致.
+//
+// 用法: csv_bench [行数] [文件路径]   (默认 1000000 /tmp/waypoints_bench.csv)
+
+#include "waypoint_csv.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+        .count();
+}
+
+// 生成一块倾斜的不规则网格
+void generate(const char* path, size_t rows) {
+    FILE* fp = std::fopen(path, "w");
+    std::fputs("ID,NAMEING,WAYPOINTS_UTM_X,WAYPOINTS_UTM_Y,WAYPOINTS_UTM_Z,"
+               "TARGETS_UTM_X,TARGETS_UTM_Y,TARGETS_UTM_Z,WAYPOINTS_WGS84_LON,"
+               "WAYPOINTS_WGS84_LAT,WAYPOINTS_WGS84_Z,TARGETS_WGS84_LON,"
+               "TARGETS_WGS84_LAT,TARGETS_WGS84_Z,AVG_HEADING,AVG_PITCH\n",
+               fp);
+    std::mt19937 rng(41);
+    std::normal_distribution<double> jitter(0, 0.3);
+    const size_t cols = static_cast<size_t>(std::sqrt(static_cast<double>(rows))) + 1;
+    for (size_t i = 0; i < rows; i++) {
+        double gx = static_cast<double>(i % cols) * 2.5 + jitter(rng);
+        double gy = static_cast<double>(i / cols) * 4.0 + jitter(rng);
+        double x = 524660.0625 + gx * 0.94 - gy * 0.34;
+        double y = 2620749.5 + gx * 0.34 + gy * 0.94;
+        double z = 17.15 + jitter(rng);
+        double lon = 117.2418894 + gx * 1e-5;
+        double lat = 23.6974308 + gy * 1e-5;
+        std::fprintf(fp,
+                     "%zu,XS-02XB-01NBQ-%zu,%.20f,%.20f,%.20f,%.20f,%.20f,%.20f,"
+                     "%.20f,%.20f,%.20f,%.20f,%.20f,%.20f,%.20f,%.20f\n",
+                     i + 1, i % 100, x, y, z, x + 0.3, y + 0.7, z - 3.4, lon, lat,
+                     z, lon + 3e-6, lat + 7e-6, z - 3.4, 19.86 + jitter(rng),
+                     -86.19 + jitter(rng));
+    }
+    std::fclose(fp);
+}
+
+// read()读完整个文件的带宽(文件已在页缓存中时即内存带宽上限)
+double readBandwidth(const char* path, size_t* bytes) {
+    int fd = open(path, O_RDONLY);
+    std::vector<char> buf(1 << 20);
+    auto start = std::chrono::steady_clock::now();
+    size_t total = 0;
+    ssize_t n;
+    while ((n = read(fd, buf.data(), buf.size())) > 0) total += static_cast<size_t>(n);
+    double sec = secondsSince(start);
+    close(fd);
+    *bytes = total;
+    return total / sec;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    size_t rows = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    const char* path = argc > 2 ? argv[2] : "/tmp/waypoints_bench.csv";
+
+    generate(path, rows);
+    size_t bytes = 0;
+    readBandwidth(path, &bytes);  // 预热页缓存
+    double bandwidth = readBandwidth(path, &bytes);
+    std::printf("rows=%zu size=%.1f MB  read() %.0f MB/s\n", rows, bytes / 1e6,
+                bandwidth / 1e6);
+
+    std::vector<int> threadCounts = {1, 2, 4};
+    int hw = static_cast<int>(std::thread::hardware_concurrency());
+    if (hw > 4) threadCounts.push_back(hw);
+
+    for (int threads : threadCounts) {
+        WaypointCsvLoader loader;
+        auto start = std::chrono::steady_clock::now();
+        if (!loader.load(path, threads)) {
+            std::fprintf(stderr, "%s\n", loader.errorString().c_str());
+            return 1;
+        }
+        double sec = secondsSince(start);
+        const WaypointCloud& cloud = loader.cloud();
+        if (cloud.size() != rows) {
+            std::fprintf(stderr, "row count %zu != %zu\n", cloud.size(), rows);
+            return 1;
+        }
+        std::printf("threads=%-3d %8.1f ms  %7.0f MB/s  %5.1f%% of read()\n",
+                    threads, sec * 1000, bytes / sec / 1e6,
+                    100.0 * (bytes / sec) / bandwidth);
+    }
+
+    // 抽查: 最后一行与strtod的结果逐列比较
+    WaypointCsvLoader loader;
+    loader.load(path, 1);
+    const WaypointCloud& cloud = loader.cloud();
+    FILE* fp = std::fopen(path, "r");
+    std::fseek(fp, -4096, SEEK_END);
+    char line[4096], last[4096] = "";
+    while (std::fgets(line, sizeof(line), fp)) std::snprintf(last, sizeof(last), "%s", line);
+    std::fclose(fp);
+    char* p = last;
+    for (int k = 0; k < WaypointCsvLoader::kColumns; k++) {
+        char* comma = std::strchr(p, ',');
+        if (k >= 2) {
+            double expect = std::strtod(p, nullptr);
+            double got = cloud.column(k - 2)[rows - 1];
+            if (got != expect) {
+                std::fprintf(stderr, "column %d mismatch: %.20f vs %.20f\n", k + 1,
+                             got, expect);
+                return 1;
+            }
+        }
+        if (comma) p = comma + 1;
+    }
+    std::printf("spot check ok\n");
+    std::remove(path);
+    return 0;
+}
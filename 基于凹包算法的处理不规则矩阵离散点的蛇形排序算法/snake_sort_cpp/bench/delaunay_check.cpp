@@ -0,0 +1,221 @@
+// 量化范围边界上的Delaunay剖分检查
+//
+// 输入直接取量化网格上的整数坐标(最小值0、最大边长2^26,量化后不变),
+// 点集贴着范围的四角与四边:
+//   四角加均匀随机点、四边上大量共线点、以及高次超椭圆上的点
+//   (四边几乎是直线,全部点都在凸包上,外接圆极大).
+// 对每组点用整数精确检查:
+//   实三角形都是逆时针且面积非零、相邻实三角形的对顶点不在外接圆内、
+//   实三角形的面积之和等于凸包面积(凸包的每条边都在剖分中)、每个不重合的点都是顶点.
+//
+// 用法: delaunay_check [随机组数]   (默认 20)
+
+#include "delaunay.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+const int64_t kRange = int64_t(1) << 26;
+
+struct Points {
+    std::string name;
+    std::vector<double> x, y;
+
+    void add(int64_t px, int64_t py) {
+        x.push_back(static_cast<double>(px));
+        y.push_back(static_cast<double>(py));
+    }
+};
+
+int64_t orient(int64_t ax, int64_t ay, int64_t bx, int64_t by, int64_t px, int64_t py) {
+    return (bx - ax) * (py - ay) - (by - ay) * (px - ax);
+}
+
+bool inCircle(const int64_t* a, const int64_t* b, const int64_t* c, const int64_t* d) {
+    const int64_t adx = a[0] - d[0], ady = a[1] - d[1];
+    const int64_t bdx = b[0] - d[0], bdy = b[1] - d[1];
+    const int64_t cdx = c[0] - d[0], cdy = c[1] - d[1];
+    const __int128 det =
+        static_cast<__int128>(adx * adx + ady * ady) * (bdx * cdy - cdx * bdy) +
+        static_cast<__int128>(bdx * bdx + bdy * bdy) * (cdx * ady - adx * cdy) +
+        static_cast<__int128>(cdx * cdx + cdy * cdy) * (adx * bdy - bdx * ady);
+    return det > 0;
+}
+
+// 凸包面积的两倍(单调链)
+__int128 hullArea2(std::vector<std::pair<int64_t, int64_t>> p) {
+    std::sort(p.begin(), p.end());
+    p.erase(std::unique(p.begin(), p.end()), p.end());
+    if (p.size() < 3) return 0;
+    std::vector<std::pair<int64_t, int64_t>> h(2 * p.size());
+    size_t k = 0;
+    for (size_t i = 0; i < p.size(); i++) {
+        while (k >= 2 && orient(h[k - 2].first, h[k - 2].second, h[k - 1].first,
+                                h[k - 1].second, p[i].first, p[i].second) <= 0)
+            --k;
+        h[k++] = p[i];
+    }
+    for (size_t i = p.size() - 1, lower = k + 1; i-- > 0;) {
+        while (k >= lower && orient(h[k - 2].first, h[k - 2].second, h[k - 1].first,
+                                    h[k - 1].second, p[i].first, p[i].second) <= 0)
+            --k;
+        h[k++] = p[i];
+    }
+    __int128 area2 = 0;
+    for (size_t i = 0; i + 1 < k; i++)
+        area2 += static_cast<__int128>(h[i].first) * h[i + 1].second -
+                 static_cast<__int128>(h[i + 1].first) * h[i].second;
+    return area2;
+}
+
+bool check(const Points& points) {
+    const size_t n = points.x.size();
+    Delaunay delaunay;
+    if (!delaunay.build(points.x.data(), points.y.data(), n)) {
+        std::fprintf(stderr, "%s: %s\n", points.name.c_str(),
+                     delaunay.errorString().c_str());
+        return false;
+    }
+    std::vector<int64_t> xy(2 * n);
+    std::vector<std::pair<int64_t, int64_t>> all(n);
+    for (size_t i = 0; i < n; i++) {
+        xy[2 * i] = static_cast<int64_t>(points.x[i]);
+        xy[2 * i + 1] = static_cast<int64_t>(points.y[i]);
+        all[i] = {xy[2 * i], xy[2 * i + 1]};
+    }
+
+    const std::vector<Delaunay::Triangle>& triangles = delaunay.triangles();
+    std::vector<char> isVertex(n);
+    __int128 area2 = 0;
+    for (size_t i = 0; i < triangles.size(); i++) {
+        const Delaunay::Triangle& t = triangles[i];
+        if (!delaunay.isReal(t)) continue;
+        const int64_t* a = &xy[2 * t.vertex[0]];
+        const int64_t* b = &xy[2 * t.vertex[1]];
+        const int64_t* c = &xy[2 * t.vertex[2]];
+        const int64_t o = orient(a[0], a[1], b[0], b[1], c[0], c[1]);
+        if (o <= 0) {
+            std::fprintf(stderr, "%s: triangle %zu is not counterclockwise\n",
+                         points.name.c_str(), i);
+            return false;
+        }
+        area2 += o;
+        for (int k = 0; k < 3; k++) {
+            isVertex[t.vertex[k]] = 1;
+            const int32_t other = t.neighbor[k];
+            if (other < 0 || !delaunay.isReal(triangles[other])) continue;
+            const Delaunay::Triangle& u = triangles[other];
+            int j = 0;
+            while (j < 3 && u.neighbor[j] != static_cast<int32_t>(i)) ++j;
+            if (j == 3) {
+                std::fprintf(stderr, "%s: triangles %zu and %d are not linked both ways\n",
+                             points.name.c_str(), i, other);
+                return false;
+            }
+            if (inCircle(a, b, c, &xy[2 * u.vertex[j]])) {
+                std::fprintf(stderr, "%s: edge of triangle %zu is not Delaunay\n",
+                             points.name.c_str(), i);
+                return false;
+            }
+        }
+    }
+
+    const __int128 hull2 = hullArea2(all);
+    if (area2 != hull2) {
+        std::fprintf(stderr, "%s: triangles cover %.0f of hull area %.0f\n",
+                     points.name.c_str(), static_cast<double>(area2) / 2,
+                     static_cast<double>(hull2) / 2);
+        return false;
+    }
+    const std::vector<int32_t>& duplicateOf = delaunay.duplicateOf();
+    for (size_t i = 0; i < n; i++) {
+        if (hull2 > 0 && duplicateOf[i] == static_cast<int32_t>(i) && !isVertex[i]) {
+            std::fprintf(stderr, "%s: point %zu (%lld, %lld) is not a vertex\n",
+                         points.name.c_str(), i, static_cast<long long>(xy[2 * i]),
+                         static_cast<long long>(xy[2 * i + 1]));
+            return false;
+        }
+    }
+    return true;
+}
+
+void addCorners(Points* p) {
+    p->add(0, 0);
+    p->add(kRange, 0);
+    p->add(kRange, kRange);
+    p->add(0, kRange);
+}
+
+// 四角 + 均匀随机点
+Points uniform(unsigned seed) {
+    Points p;
+    p.name = "uniform " + std::to_string(seed);
+    std::mt19937_64 rng(seed);
+    std::uniform_int_distribution<int64_t> coord(0, kRange);
+    addCorners(&p);
+    for (int i = 0; i < 2000; i++) p.add(coord(rng), coord(rng));
+    return p;
+}
+
+// 四边上的共线点 + 少量内部点
+Points edges(unsigned seed) {
+    Points p;
+    p.name = "edges " + std::to_string(seed);
+    std::mt19937_64 rng(seed);
+    std::uniform_int_distribution<int64_t> coord(0, kRange);
+    addCorners(&p);
+    for (int i = 0; i < 500; i++) {
+        const int64_t t = coord(rng);
+        p.add(t, 0);
+        p.add(kRange, t);
+        p.add(kRange - t, kRange);
+        p.add(0, kRange - t);
+    }
+    for (int i = 0; i < 200; i++) p.add(coord(rng), coord(rng));
+    return p;
+}
+
+// 超椭圆 |x|^e + |y|^e = 1 上的点,四边近乎直线
+Points superellipse(unsigned seed, double exponent) {
+    Points p;
+    p.name = "superellipse " + std::to_string(seed);
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> angle(0, 2 * 3.14159265358979323846);
+    const double half = kRange / 2.0;
+    // 四个端点把范围撑满
+    p.add(0, kRange / 2);
+    p.add(kRange, kRange / 2);
+    p.add(kRange / 2, 0);
+    p.add(kRange / 2, kRange);
+    for (int i = 0; i < 2000; i++) {
+        const double a = angle(rng);
+        const double c = std::cos(a), s = std::sin(a);
+        const double ux = std::copysign(std::pow(std::fabs(c), 2 / exponent), c);
+        const double uy = std::copysign(std::pow(std::fabs(s), 2 / exponent), s);
+        p.add(std::llround(half + half * ux), std::llround(half + half * uy));
+    }
+    return p;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    const int rounds = argc > 1 ? std::atoi(argv[1]) : 20;
+    int failures = 0;
+    for (int r = 0; r < rounds; r++) {
+        const unsigned seed = 1000 + r;
+        const Points sets[] = {uniform(seed), edges(seed), superellipse(seed, 8 + r % 4 * 8)};
+        for (const Points& p : sets)
+            if (!check(p)) ++failures;
+    }
+    std::printf("%d point sets, %d failed\n", rounds * 3, failures);
+    return failures == 0 ? 0 : 1;
+}
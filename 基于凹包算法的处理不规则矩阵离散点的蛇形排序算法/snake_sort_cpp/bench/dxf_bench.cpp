@@ -0,0 +1,152 @@
+// 流式DXF导出的规模测试
+//
+// 点数从10^4增加到10^max,分别导出POLYLINE与LWPOLYLINE(都带POINT),输出:
+//   耗时、文件大小、写出速度,与同样字节数直接write()的耗时之比(接近1即受I/O限制),
+//   导出前后最大常驻内存的增量(应与点数无关).
+// 最后用一个简单的组码读取器读回最大的文件,核对顶点个数与坐标
+// (6位小数,每个坐标误差不超过5e-7,平面距离不超过1e-6).
+//
+// 用法: dxf_bench [最大指数] [输出文件]   (默认 6 /tmp/snake_bench.dxf)
+
+#include "dxf_writer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+namespace {
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+        .count();
+}
+
+long maxRssKb() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+// 同样字节数直接write()的耗时(1MB一块)
+double rawWriteSeconds(const char* path, size_t bytes) {
+    std::vector<char> block(1 << 20, 'x');
+    auto start = std::chrono::steady_clock::now();
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    for (size_t done = 0; done < bytes;) {
+        size_t n = std::min(block.size(), bytes - done);
+        if (write(fd, block.data(), n) != static_cast<ssize_t>(n)) break;
+        done += n;
+    }
+    close(fd);
+    return secondsSince(start);
+}
+
+// 读回: 统计VERTEX/LWPOLYLINE顶点与POINT,逐个与期望坐标比较
+bool verify(const char* path, const std::vector<double>& x, const std::vector<double>& y,
+            const std::vector<uint32_t>& order, bool lightweight, double tolerance) {
+    FILE* fp = std::fopen(path, "r");
+    if (!fp) return false;
+    char code[64], value[256];
+    std::string entity;
+    size_t vertices = 0, points = 0;
+    double px = 0, maxError = 0;
+    while (std::fgets(code, sizeof(code), fp) && std::fgets(value, sizeof(value), fp)) {
+        const int c = std::atoi(code);
+        value[std::strcspn(value, "\r\n")] = 0;
+        if (c == 0) {
+            entity = value;
+            continue;
+        }
+        const bool inRoute = lightweight ? entity == "LWPOLYLINE" : entity == "VERTEX";
+        if (!inRoute && entity != "POINT") continue;
+        if (c == 10) px = std::strtod(value, nullptr);
+        if (c != 20) continue;
+        size_t& k = inRoute ? vertices : points;
+        if (k >= order.size()) {
+            std::fclose(fp);
+            return false;
+        }
+        const uint32_t i = order[k++];
+        maxError = std::max(maxError, std::hypot(px - x[i], std::strtod(value, nullptr) - y[i]));
+    }
+    std::fclose(fp);
+    std::printf("read back: %zu vertices, %zu points, max coordinate error %.2e\n",
+                vertices, points, maxError);
+    return vertices == order.size() && points == order.size() && maxError <= tolerance;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    const int maxExponent = argc > 1 ? std::atoi(argv[1]) : 6;
+    const char* path = argc > 2 ? argv[2] : "/tmp/snake_bench.dxf";
+
+    const size_t maxN = static_cast<size_t>(std::pow(10.0, maxExponent));
+    std::mt19937 rng(44);
+    std::uniform_real_distribution<double> jitter(-0.5, 0.5);
+    std::vector<double> x(maxN), y(maxN), z(maxN);
+    std::vector<uint32_t> order(maxN);
+    for (size_t i = 0; i < maxN; i++) {
+        x[i] = 524660.0625 + (i % 1000) * 2.5 + jitter(rng);
+        y[i] = 2620749.5 + (i / 1000) * 4.0 + jitter(rng);
+        z[i] = 17.15 + jitter(rng);
+        // 每行1000个点的蛇形顺序,奇数行反向
+        const size_t row = i / 1000, col = i % 1000;
+        const size_t index = row * 1000 + (row % 2 ? 999 - col : col);
+        order[i] = static_cast<uint32_t>(index < maxN ? index : i);
+    }
+
+    std::printf("%10s %6s %9s %9s %9s %9s %9s\n", "n", "kind", "ms", "MB", "MB/s",
+                "vs write", "rss +KB");
+    for (int e = 4; e <= maxExponent; e++) {
+        const size_t n = static_cast<size_t>(std::pow(10.0, e));
+        const std::vector<uint32_t> sub(order.begin(), order.begin() + n);
+        for (int lightweight = 0; lightweight < 2; lightweight++) {
+            DxfExportOptions options;
+            options.lightweight = lightweight != 0;
+            const long rssBefore = maxRssKb();
+            auto start = std::chrono::steady_clock::now();
+            std::string error;
+            if (!exportSnakeDxf(path, x.data(), y.data(), z.data(), sub, options, &error)) {
+                std::fprintf(stderr, "%s\n", error.c_str());
+                return 1;
+            }
+            const double sec = secondsSince(start);
+            const long rssAfter = maxRssKb();
+            FILE* fp = std::fopen(path, "r");
+            std::fseek(fp, 0, SEEK_END);
+            const size_t bytes = static_cast<size_t>(std::ftell(fp));
+            std::fclose(fp);
+            const double raw = rawWriteSeconds(path, bytes);
+            std::printf("%10zu %6s %9.1f %9.1f %9.0f %9.2f %9ld\n", n,
+                        lightweight ? "lw" : "poly", sec * 1e3, bytes / 1e6,
+                        bytes / sec / 1e6, sec / raw, rssAfter - rssBefore);
+        }
+    }
+
+    // 最大规模下两种格式各导出一次并读回核对
+    const std::vector<uint32_t> sub(order.begin(), order.begin() + maxN);
+    DxfExportOptions options;
+    std::string error;
+    bool ok = exportSnakeDxf(path, x.data(), y.data(), z.data(), sub, options, &error) &&
+              verify(path, x, y, sub, false, 1e-6);
+    options.lightweight = true;
+    ok = ok && exportSnakeDxf(path, x.data(), y.data(), z.data(), sub, options, &error) &&
+         verify(path, x, y, sub, true, 1e-6);
+    std::remove(path);
+    if (!ok) {
+        std::fprintf(stderr, "verification failed %s\n", error.c_str());
+        return 1;
+    }
+    return 0;
+}
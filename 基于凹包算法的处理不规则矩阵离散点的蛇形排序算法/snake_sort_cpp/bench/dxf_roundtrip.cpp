@@ -0,0 +1,100 @@
+// 用dxflib的读取器核对流式导出的DXF
+//
+// 生成一条蛇形航线,分别以POLYLINE与LWPOLYLINE导出,再用DL_Dxf::in读回,
+// 检查多段线顶点个数、顺序与坐标,以及POINT的个数与坐标.
+//
+// 用法: dxf_roundtrip [点数] [输出文件]   (默认 100000 /tmp/snake_roundtrip.dxf)
+
+#include "dxf_writer.h"
+
+#include <dl_creationadapter.h>
+#include <dl_dxf.h>
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+struct Collector : public DL_CreationAdapter {
+    std::vector<double> vx, vy, vz;
+    std::vector<double> px, py, pz;
+    int polylines = 0;
+    size_t declaredVertices = 0;  // LWPOLYLINE的组码90;POLYLINE没有
+
+    void addPolyline(const DL_PolylineData& data) override {
+        ++polylines;
+        declaredVertices = data.number;
+    }
+    void addVertex(const DL_VertexData& data) override {
+        vx.push_back(data.x);
+        vy.push_back(data.y);
+        vz.push_back(data.z);
+    }
+    void addPoint(const DL_PointData& data) override {
+        px.push_back(data.x);
+        py.push_back(data.y);
+        pz.push_back(data.z);
+    }
+};
+
+double maxError(const std::vector<double>& ax, const std::vector<double>& ay,
+                const double* x, const double* y, const std::vector<uint32_t>& order) {
+    double err = 0;
+    for (size_t k = 0; k < order.size(); k++)
+        err = std::max(err, std::hypot(ax[k] - x[order[k]], ay[k] - y[order[k]]));
+    return err;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    const size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000;
+    const char* path = argc > 2 ? argv[2] : "/tmp/snake_roundtrip.dxf";
+
+    // 每行100个点的蛇形
+    std::vector<double> x(n), y(n), z(n);
+    std::vector<uint32_t> order(n);
+    for (size_t i = 0; i < n; i++) {
+        x[i] = 524660.0625 + (i % 100) * 2.5 + 0.123456;
+        y[i] = 2620749.5 + (i / 100) * 4.0;
+        z[i] = 17.15 - (i % 7) * 0.25;
+        const size_t row = i / 100, col = i % 100;
+        order[i] = static_cast<uint32_t>(row * 100 + (row % 2 ? 99 - col : col));
+        if (order[i] >= n) order[i] = static_cast<uint32_t>(i);
+    }
+
+    bool ok = true;
+    for (int lightweight = 0; lightweight < 2; lightweight++) {
+        DxfExportOptions options;
+        options.lightweight = lightweight != 0;
+        std::string error;
+        if (!exportSnakeDxf(path, x.data(), y.data(), z.data(), order, options, &error)) {
+            std::fprintf(stderr, "%s\n", error.c_str());
+            return 1;
+        }
+        Collector collector;
+        DL_Dxf dxf;
+        if (!dxf.in(path, &collector)) {
+            std::fprintf(stderr, "dxflib cannot read %s\n", path);
+            return 1;
+        }
+        const bool counts = collector.polylines == 1 && collector.vx.size() == n &&
+                            collector.px.size() == n &&
+                            (!lightweight || collector.declaredVertices == n);
+        const double routeErr =
+            counts ? maxError(collector.vx, collector.vy, x.data(), y.data(), order) : INFINITY;
+        const double pointErr =
+            counts ? maxError(collector.px, collector.py, x.data(), y.data(), order) : INFINITY;
+        const bool pass = counts && routeErr <= 1e-6 && pointErr <= 1e-6;
+        std::printf("%-10s polylines=%d vertices=%zu points=%zu route err %.1e point err "
+                    "%.1e  %s\n",
+                    lightweight ? "LWPOLYLINE" : "POLYLINE", collector.polylines,
+                    collector.vx.size(), collector.px.size(), routeErr, pointErr,
+                    pass ? "ok" : "FAILED");
+        ok = ok && pass;
+    }
+    std::remove(path);
+    return ok ? 0 : 1;
+}
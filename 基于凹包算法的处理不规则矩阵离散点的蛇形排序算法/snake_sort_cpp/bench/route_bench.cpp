@@ -0,0 +1,157 @@
+// 蛇形航线的2-opt/Or-opt改进测试
+//
+// 生成倾斜20度、带抖动和缺点的U形网格: 上半部中间挖去一块,
+// 蛇形顺序在U的两臂之间每行都要跨一次缺口.点数从10^3增加到10^max,
+// 以蛇形顺序为初始航线做局部改进,输出航线长度的变化、各阶段耗时与移动次数,并检查:
+//   结果是排列、首尾点不变、长度不增.
+// 10^3点时另跑一遍朴素的全对2-opt(O(n^2)每轮)作为质量参照.
+//
+// 用法: route_bench [最大指数] [时间预算秒] [线程数] [近邻数]   (默认 6 0 0 16; 预算0为不限)
+
+#include "route_optimizer.h"
+#include "snake_order.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace {
+
+const double kPi = 3.14159265358979323846;
+const double kColumnSpacing = 2.5;
+const double kRowSpacing = 4.0;
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+        .count();
+}
+
+struct Cloud {
+    std::vector<double> x, y, heading;
+};
+
+Cloud generate(size_t n, unsigned seed) {
+    Cloud g;
+    std::mt19937 rng(seed);
+    std::normal_distribution<double> jitter(0, 0.15);
+    std::normal_distribution<double> headingNoise(0, 1.5);
+    std::uniform_real_distribution<double> uniform(0, 1);
+    const double angle = 20 * kPi / 180;
+    // 缺口占去约1/6的面积
+    const size_t cols = static_cast<size_t>(std::sqrt(n / 0.8 * 6 / 5)) + 2;
+    const size_t rows = static_cast<size_t>(n / (cols * 0.97 * 5 / 6)) + 1;
+    for (size_t r = 0; g.x.size() < n; r++) {
+        for (size_t c = 0; c < cols && g.x.size() < n; c++) {
+            const double u = static_cast<double>(c) / cols;
+            const double v = static_cast<double>(r) / rows;
+            if (u > 0.3 && u < 0.7 && v > 0.4) continue;
+            if (uniform(rng) < 0.03) continue;
+            const double gx = c * kColumnSpacing + jitter(rng);
+            const double gy = r * kRowSpacing + jitter(rng);
+            g.x.push_back(524660.0 + gx * std::cos(angle) - gy * std::sin(angle));
+            g.y.push_back(2620749.0 + gx * std::sin(angle) + gy * std::cos(angle));
+            g.heading.push_back((r % 2 ? 250.0 : 70.0) + headingNoise(rng));
+        }
+    }
+    return g;
+}
+
+// 朴素2-opt: 每轮枚举所有边对,取第一个改进,直到没有改进
+double naiveTwoOpt(const Cloud& g, std::vector<uint32_t> tour) {
+    auto d = [&](uint32_t a, uint32_t b) {
+        return std::hypot(g.x[a] - g.x[b], g.y[a] - g.y[b]);
+    };
+    bool improved = true;
+    while (improved) {
+        improved = false;
+        for (size_t i = 0; i + 2 < tour.size(); i++)
+            for (size_t j = i + 2; j + 1 < tour.size(); j++) {
+                const double gain = d(tour[i], tour[i + 1]) + d(tour[j], tour[j + 1]) -
+                                    d(tour[i], tour[j]) - d(tour[i + 1], tour[j + 1]);
+                if (gain > 1e-9) {
+                    std::reverse(tour.begin() + i + 1, tour.begin() + j + 1);
+                    improved = true;
+                }
+            }
+    }
+    return routeLength(g.x.data(), g.y.data(), tour);
+}
+
+bool check(const std::vector<uint32_t>& initial, const RouteOptimizer& optimizer,
+           const Cloud& g) {
+    const std::vector<uint32_t>& order = optimizer.order();
+    if (order.size() != initial.size()) {
+        std::fprintf(stderr, "size %zu != %zu\n", order.size(), initial.size());
+        return false;
+    }
+    std::vector<uint8_t> seen(order.size(), 0);
+    for (uint32_t p : order) {
+        if (p >= order.size() || seen[p]) {
+            std::fprintf(stderr, "not a permutation at point %u\n", p);
+            return false;
+        }
+        seen[p] = 1;
+    }
+    if (order.front() != initial.front() || order.back() != initial.back()) {
+        std::fprintf(stderr, "route endpoints moved\n");
+        return false;
+    }
+    const RouteStats& s = optimizer.stats();
+    const double length = routeLength(g.x.data(), g.y.data(), order);
+    if (std::fabs(length - s.finalLength) > 1e-6 * length || length > s.initialLength + 1e-6) {
+        std::fprintf(stderr, "length %.3f, reported %.3f, initial %.3f\n", length,
+                     s.finalLength, s.initialLength);
+        return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    const int maxExponent = argc > 1 ? std::atoi(argv[1]) : 6;
+    RouteOptions options;
+    options.timeBudget = argc > 2 ? std::atof(argv[2]) : 0;
+    options.threads = argc > 3 ? std::atoi(argv[3]) : 0;
+    if (argc > 4) options.neighbours = std::atoi(argv[4]);
+
+    std::printf("%10s %12s %12s %7s %9s %9s %9s %9s %9s %6s\n", "n", "snake m", "route m",
+                "saved", "snake ms", "knn ms", "opt ms", "2-opt", "or-opt", "passes");
+    for (int e = 3; e <= maxExponent; e++) {
+        const size_t n = static_cast<size_t>(std::pow(10.0, e));
+        const Cloud g = generate(n, 48 + e);
+        auto start = std::chrono::steady_clock::now();
+        SnakeSorter sorter;
+        if (!sorter.run(g.x.data(), g.y.data(), n, g.heading.data())) {
+            std::fprintf(stderr, "%s\n", sorter.errorString().c_str());
+            return 1;
+        }
+        const double snakeSeconds = secondsSince(start);
+
+        RouteOptimizer optimizer;
+        if (!optimizer.run(g.x.data(), g.y.data(), n, sorter.order(), options)) {
+            std::fprintf(stderr, "%s\n", optimizer.errorString().c_str());
+            return 1;
+        }
+        const RouteStats& s = optimizer.stats();
+        std::printf("%10zu %12.1f %12.1f %6.2f%% %9.2f %9.2f %9.2f %9zu %9zu %6d%s\n", n,
+                    s.initialLength, s.finalLength,
+                    100 * (1 - s.finalLength / s.initialLength), snakeSeconds * 1e3,
+                    s.neighbourSeconds * 1e3, s.optimizeSeconds * 1e3, s.twoOptMoves,
+                    s.orOptMoves, s.passes, s.timedOut ? "  (budget)" : "");
+        if (!check(sorter.order(), optimizer, g)) return 1;
+
+        if (e == 3) {
+            start = std::chrono::steady_clock::now();
+            const double naive = naiveTwoOpt(g, sorter.order());
+            std::printf("%10s %12s %12.1f %6.2f%% %19s %9.2f   (naive 2-opt)\n", "", "", naive,
+                        100 * (1 - naive / s.initialLength), "",
+                        secondsSince(start) * 1e3);
+        }
+    }
+    return 0;
+}
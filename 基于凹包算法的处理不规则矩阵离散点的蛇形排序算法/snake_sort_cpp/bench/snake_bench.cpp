@@ -0,0 +1,120 @@
+// 旋转 + 凹包 + 蛇形排序的规模测试
+//
+// 生成倾斜20度、带抖动和缺点、一侧挖去一块(凹口)的不规则网格,
+// 点数从10^3增加到10^max,输出各阶段耗时与吞吐量,并检查:
+//   分出的行数与生成的行数一致、每行内相邻点的间距接近列距、凹包是闭合的逆时针环、
+//   凹包外接矩形给出的角度(不经航向与最近邻修正)与网格方向相差在1度以内.
+//
+// 用法: snake_bench [最大指数]   (默认 6,内存足够时可到 7)
+
+#include "snake_order.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace {
+
+const double kPi = 3.14159265358979323846;
+const double kColumnSpacing = 2.5;
+const double kRowSpacing = 4.0;
+const double kGridAngle = 20 * kPi / 180;
+
+struct Grid {
+    std::vector<double> x, y, heading;
+    size_t rows = 0;
+};
+
+Grid generate(size_t n, unsigned seed) {
+    Grid g;
+    std::mt19937 rng(seed);
+    std::normal_distribution<double> jitter(0, 0.15);
+    std::normal_distribution<double> headingNoise(0, 1.5);
+    std::uniform_real_distribution<double> uniform(0, 1);
+    const double angle = kGridAngle;
+    const size_t cols = static_cast<size_t>(std::sqrt(n / 0.8)) + 2;
+    size_t r = 0;
+    while (g.x.size() < n) {
+        for (size_t c = 0; c < cols && g.x.size() < n; c++) {
+            // 凹口: 右侧中间的一块没有点;另有3%的随机缺点
+            const double u = static_cast<double>(c) / cols;
+            if (u > 0.6 && r % 100 > 30 && r % 100 < 60) continue;
+            if (uniform(rng) < 0.03) continue;
+            const double gx = c * kColumnSpacing + jitter(rng);
+            const double gy = r * kRowSpacing + jitter(rng);
+            g.x.push_back(524660.0 + gx * std::cos(angle) - gy * std::sin(angle));
+            g.y.push_back(2620749.0 + gx * std::sin(angle) + gy * std::cos(angle));
+            // 行方向自东20度,即航向70度;往返飞行
+            g.heading.push_back((r % 2 ? 250.0 : 70.0) + headingNoise(rng));
+        }
+        ++r;
+    }
+    // 最后一行可能只生成了一部分,仍算一行
+    g.rows = r;
+    return g;
+}
+
+bool check(const Grid& g, const SnakeSorter& sorter) {
+    if (sorter.rowCount() != g.rows) {
+        std::fprintf(stderr, "rows %zu != %zu\n", sorter.rowCount(), g.rows);
+        return false;
+    }
+    const std::vector<uint32_t>& order = sorter.order();
+    const std::vector<uint32_t>& rowStart = sorter.rowStart();
+    for (size_t r = 0; r + 1 < rowStart.size(); r++) {
+        for (uint32_t i = rowStart[r] + 1; i < rowStart[r + 1]; i++) {
+            const double d = std::hypot(g.x[order[i]] - g.x[order[i - 1]],
+                                        g.y[order[i]] - g.y[order[i - 1]]);
+            // 缺点或凹口会跳过若干列,但不会跨行
+            if (d < 0.5 * kColumnSpacing || d > g.x.size() * kColumnSpacing) {
+                std::fprintf(stderr, "row %zu step %.3f\n", r, d);
+                return false;
+            }
+        }
+    }
+    const std::vector<int32_t>& hull = sorter.hull();
+    if (g.x.size() >= 3 && hull.size() < 3) {
+        std::fprintf(stderr, "hull has %zu points\n", hull.size());
+        return false;
+    }
+    const double hullAngle = rotationFromHull(g.x.data(), g.y.data(), hull);
+    const double off = std::remainder(hullAngle - kGridAngle, kPi / 2);
+    if (std::fabs(off) > kPi / 180) {
+        std::fprintf(stderr, "hull rectangle angle %.3f is %.3f deg off the grid\n",
+                     hullAngle * 180 / kPi, off * 180 / kPi);
+        return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    int maxExponent = argc > 1 ? std::atoi(argv[1]) : 6;
+
+    std::printf("%10s %9s %9s %9s %9s %10s %9s %7s %7s %8s\n", "n", "tri ms",
+                "hull ms", "rot ms", "rows ms", "total ms", "Mpts/s", "rows",
+                "hull", "angle");
+    for (int e = 3; e <= maxExponent; e++) {
+        const size_t n = static_cast<size_t>(std::pow(10.0, e));
+        Grid g = generate(n, 42 + e);
+        SnakeSorter sorter;
+        auto start = std::chrono::steady_clock::now();
+        if (!sorter.run(g.x.data(), g.y.data(), n, g.heading.data())) {
+            std::fprintf(stderr, "%s\n", sorter.errorString().c_str());
+            return 1;
+        }
+        const double total = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count();
+        const SnakeTimings& t = sorter.timings();
+        std::printf("%10zu %9.2f %9.2f %9.2f %9.2f %10.2f %9.2f %7zu %7zu %8.3f\n", n,
+                    t.triangulation * 1e3, t.hull * 1e3, t.rotation * 1e3,
+                    t.rows * 1e3, total * 1e3, n / total / 1e6, sorter.rowCount(),
+                    sorter.hull().size(), sorter.rotation() * 180 / kPi);
+        if (!check(g, sorter)) return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,224 @@
+// UTM <-> WGS84 批量换算的精度与速度
+//
+// 精度: 与long double参考实现(同一Krüger级数,牛顿迭代到收敛)比较,
+//       并做往返换算,另外核对interduce.txt中第一行的两组坐标;
+// 速度: 标量与向量路径的正算、反算吞吐量,以及对整份航点数据做一致性检查的耗时.
+//
+// 用法: utm_bench [点数]   (默认 1000000)
+
+#include "utm_transform.h"
+#include "waypoint_csv.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace {
+
+const long double kPiL = 3.141592653589793238462643383279502884L;
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+        .count();
+}
+
+// long double参考实现
+struct Reference {
+    long double e, e2m, scaledA, alpha[6], beta[6];
+
+    Reference() {
+        const long double a = 6378137.0L, f = 1 / 298.257223563L;
+        const long double n = f / (2 - f);
+        const long double n2 = n * n, n3 = n2 * n, n4 = n3 * n, n5 = n4 * n, n6 = n5 * n;
+        e = std::sqrt(f * (2 - f));
+        e2m = (1 - f) * (1 - f);
+        scaledA = 0.9996L * a / (1 + n) * (1 + n2 / 4 + n4 / 64 + n6 / 256);
+        alpha[0] = n / 2 - 2 * n2 / 3 + 5 * n3 / 16 + 41 * n4 / 180 - 127 * n5 / 288 +
+                   7891 * n6 / 37800;
+        alpha[1] = 13 * n2 / 48 - 3 * n3 / 5 + 557 * n4 / 1440 + 281 * n5 / 630 -
+                   1983433 * n6 / 1935360;
+        alpha[2] = 61 * n3 / 240 - 103 * n4 / 140 + 15061 * n5 / 26880 +
+                   167603 * n6 / 181440;
+        alpha[3] = 49561 * n4 / 161280 - 179 * n5 / 168 + 6601661 * n6 / 7257600;
+        alpha[4] = 34729 * n5 / 80640 - 3418889 * n6 / 1995840;
+        alpha[5] = 212378941 * n6 / 319334400;
+        beta[0] = n / 2 - 2 * n2 / 3 + 37 * n3 / 96 - n4 / 360 - 81 * n5 / 512 +
+                  96199 * n6 / 604800;
+        beta[1] = n2 / 48 + n3 / 15 - 437 * n4 / 1440 + 46 * n5 / 105 -
+                  1118711 * n6 / 3870720;
+        beta[2] = 17 * n3 / 480 - 37 * n4 / 840 - 209 * n5 / 4480 + 5569 * n6 / 90720;
+        beta[3] = 4397 * n4 / 161280 - 11 * n5 / 504 - 830251 * n6 / 7257600;
+        beta[4] = 4583 * n5 / 161280 - 108847 * n6 / 3991680;
+        beta[5] = 20648693 * n6 / 638668800;
+    }
+
+    // 直接逐项求和,不用Clenshaw
+    void series(const long double* c, long double sign, long double xi, long double eta,
+                long double* outXi, long double* outEta) const {
+        long double sx = 0, sy = 0;
+        for (int j = 1; j <= 6; j++) {
+            sx += c[j - 1] * std::sin(2 * j * xi) * std::cosh(2 * j * eta);
+            sy += c[j - 1] * std::cos(2 * j * xi) * std::sinh(2 * j * eta);
+        }
+        *outXi = xi + sign * sx;
+        *outEta = eta + sign * sy;
+    }
+
+    long double taupf(long double tau) const {
+        const long double t1 = std::sqrt(1 + tau * tau);
+        const long double sig = std::sinh(e * std::atanh(e * tau / t1));
+        return tau * std::sqrt(1 + sig * sig) - sig * t1;
+    }
+
+    void forward(const UtmZone& zone, double lon, double lat, double* x, double* y) const {
+        const long double lon0 = 6.0L * zone.number - 183;
+        const long double phi = lat * kPiL / 180, lam = (lon - lon0) * kPiL / 180;
+        const long double taup = taupf(std::tan(phi));
+        const long double xip = std::atan2(taup, std::cos(lam));
+        const long double etap =
+            std::asinh(std::sin(lam) / std::sqrt(taup * taup + std::cos(lam) * std::cos(lam)));
+        long double xi, eta;
+        series(alpha, 1, xip, etap, &xi, &eta);
+        *x = static_cast<double>(scaledA * eta + 500000);
+        *y = static_cast<double>(scaledA * xi + (zone.north ? 0 : 10000000));
+    }
+
+    void inverse(const UtmZone& zone, double x, double y, double* lon, double* lat) const {
+        const long double lon0 = 6.0L * zone.number - 183;
+        const long double xi = (y - (zone.north ? 0 : 10000000)) / scaledA;
+        const long double eta = (x - 500000) / scaledA;
+        long double xip, etap;
+        series(beta, -1, xi, eta, &xip, &etap);
+        const long double taup =
+            std::sin(xip) / std::sqrt(std::sinh(etap) * std::sinh(etap) +
+                                      std::cos(xip) * std::cos(xip));
+        long double tau = taup / e2m;
+        for (int k = 0; k < 20; k++) {
+            const long double taupa = taupf(tau);
+            const long double dtau = (taup - taupa) * (1 + e2m * tau * tau) /
+                                     (e2m * std::sqrt(1 + tau * tau) *
+                                      std::sqrt(1 + taupa * taupa));
+            tau += dtau;
+            if (std::fabs(dtau) < 1e-19L * std::max(1.0L, std::fabs(taup))) break;
+        }
+        *lat = static_cast<double>(std::atan(tau) * 180 / kPiL);
+        *lon = static_cast<double>(lon0 + std::atan2(std::sinh(etap), std::cos(xip)) * 180 / kPiL);
+    }
+};
+
+// 经纬度误差换算成米(纬度1度约111km)
+double degreesToMeters(double dlon, double dlat, double lat) {
+    const double m = 111319.49;
+    return std::hypot(dlon * m * std::cos(lat * kPiL / 180), dlat * m);
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    const size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    const UtmZone zone{50, true};
+    const UtmTransform transform(zone);
+    const Reference reference;
+    std::printf("vector path: %s\n", UtmTransform::vectorized() ? "avx2+libmvec" : "off");
+
+    // interduce.txt 第一行
+    {
+        double lon = 117.24188942267666391217, lat = 23.69743082425670266389;
+        double x, y;
+        transform.forward(&lon, &lat, &x, &y, 1);
+        std::printf("interduce.txt row 1: (%.4f, %.4f) vs file (524660.0625, 2620749.5), "
+                    "diff %.4f m\n",
+                    x, y, std::hypot(x - 524660.0625, y - 2620749.5));
+    }
+
+    // 分带内的随机点: 中央经线±3度,纬度-80~84度
+    std::mt19937_64 rng(43);
+    std::uniform_real_distribution<double> dlon(-3, 3), dlat(-80, 84);
+    std::vector<double> lon(n), lat(n);
+    for (size_t i = 0; i < n; i++) {
+        lon[i] = 117 + dlon(rng);
+        lat[i] = dlat(rng);
+    }
+    // 南半球的点按南半球分带处理
+    std::vector<double> x(n), y(n), lon2(n), lat2(n);
+    size_t south = std::partition(lat.begin(), lat.end(), [](double v) { return v >= 0; }) -
+                   lat.begin();
+    const UtmTransform southTransform(UtmZone{50, false});
+
+    auto forwardAll = [&]() {
+        transform.forward(lon.data(), lat.data(), x.data(), y.data(), south);
+        southTransform.forward(lon.data() + south, lat.data() + south, x.data() + south,
+                               y.data() + south, n - south);
+    };
+    auto inverseAll = [&]() {
+        transform.inverse(x.data(), y.data(), lon2.data(), lat2.data(), south);
+        southTransform.inverse(x.data() + south, y.data() + south, lon2.data() + south,
+                               lat2.data() + south, n - south);
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    forwardAll();
+    const double forwardSec = secondsSince(start);
+    start = std::chrono::steady_clock::now();
+    inverseAll();
+    const double inverseSec = secondsSince(start);
+
+    // 抽样与参考实现比较,全部点做往返
+    double forwardErr = 0, inverseErr = 0, roundTripErr = 0;
+    const size_t step = std::max<size_t>(1, n / 20000);
+    for (size_t i = 0; i < n; i += step) {
+        const UtmZone& z = i < south ? zone : southTransform.zone();
+        double rx, ry, rlon, rlat;
+        reference.forward(z, lon[i], lat[i], &rx, &ry);
+        forwardErr = std::max(forwardErr, std::hypot(x[i] - rx, y[i] - ry));
+        reference.inverse(z, x[i], y[i], &rlon, &rlat);
+        inverseErr = std::max(inverseErr,
+                              degreesToMeters(lon2[i] - rlon, lat2[i] - rlat, rlat));
+    }
+    for (size_t i = 0; i < n; i++)
+        roundTripErr = std::max(roundTripErr,
+                                degreesToMeters(lon2[i] - lon[i], lat2[i] - lat[i], lat[i]));
+    std::printf("max error vs long double reference: forward %.2f nm, inverse %.2f nm\n",
+                forwardErr * 1e9, inverseErr * 1e9);
+    std::printf("max round-trip error: %.2f nm\n", roundTripErr * 1e9);
+    std::printf("%zu points: forward %.1f ms (%.1f Mpts/s), inverse %.1f ms (%.1f Mpts/s)\n",
+                n, forwardSec * 1e3, n / forwardSec / 1e6, inverseSec * 1e3,
+                n / inverseSec / 1e6);
+
+    // 同一批点逐点计算(不走向量路径)的耗时,作对比
+    {
+        std::vector<double> sx(n), sy(n);
+        start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < n; i++)
+            (i < south ? transform : southTransform)
+                .forward(&lon[i], &lat[i], &sx[i], &sy[i], 1);
+        const double sec = secondsSince(start);
+        double diff = 0;
+        for (size_t i = 0; i < n; i++)
+            diff = std::max(diff, std::hypot(sx[i] - x[i], sy[i] - y[i]));
+        std::printf("scalar forward %.1f ms (%.1f Mpts/s), max diff to batch %.2f nm\n",
+                    sec * 1e3, n / sec / 1e6, diff * 1e9);
+    }
+
+    // 航点文件一致性检查: 航点与目标点各n个
+    WaypointCloud cloud;
+    cloud.resize(south);
+    for (size_t i = 0; i < south; i++) {
+        cloud.waypointLon[i] = cloud.targetLon[i] = lon[i];
+        cloud.waypointLat[i] = cloud.targetLat[i] = lat[i];
+        cloud.waypointUtmX[i] = cloud.targetUtmX[i] = x[i];
+        cloud.waypointUtmY[i] = cloud.targetUtmY[i] = y[i] + (i % 1000 == 0 ? 0.5 : 0);
+    }
+    start = std::chrono::steady_clock::now();
+    UtmConsistency check = checkUtmConsistency(cloud, 0.01);
+    const double checkSec = secondsSince(start);
+    std::printf("consistency check of %zu rows: %.1f ms, zone %d%c, max error %.3f m, "
+                "%zu outliers (expected %zu)\n",
+                south, checkSec * 1e3, check.zone.number, check.zone.north ? 'N' : 'S',
+                check.maxError, check.outliers, 2 * ((south + 999) / 1000));
+    return 0;
+}
@@ -0,0 +1,33 @@
+#ifndef CONCAVE_HULL_H
+#define CONCAVE_HULL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class Delaunay;
+
+// alpha形状凹包: 保留外接圆半径不超过alpha的Delaunay三角形,
+// 它们与其余三角形之间的边首尾相连即为边界环
+class ConcaveHull {
+public:
+    // alpha <= 0 时取 alphaFactor × 全部三角形外接圆半径的中位数
+    bool build(const Delaunay& delaunay, const double* x, const double* y,
+               double alpha = 0, double alphaFactor = 2.0);
+
+    // 面积最大的逆时针边界环(点下标),即最外圈的特征点
+    const std::vector<int32_t>& boundary() const { return boundary_; }
+    // 边界环个数(外圈、内部空洞以及分离的区域)
+    size_t loopCount() const { return loopCount_; }
+    double alpha() const { return alpha_; }
+    const std::string& errorString() const { return errorString_; }
+
+private:
+    std::vector<int32_t> boundary_;
+    size_t loopCount_ = 0;
+    double alpha_ = 0;
+    std::string errorString_;
+};
+
+#endif
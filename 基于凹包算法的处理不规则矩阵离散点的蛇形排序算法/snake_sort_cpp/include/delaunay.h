@@ -0,0 +1,66 @@
+#ifndef DELAUNAY_H
+#define DELAUNAY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 二维Delaunay三角剖分(逐点插入 + Lawson翻边)
+//
+// 坐标先量化为整数网格(最大边长2^26格),方向与内切圆判断用64/128位整数精确计算,
+// 规则网格上大量共线、共圆的点也不会出错;量化后重合的点只插入一次.
+// 外围超级三角形的顶点放在无穷远处(符号化): 有限远的超级三角形在范围边界附近
+// 会落进实三角形的外接圆,使凸包上的边被翻掉.
+// 插入顺序按Hilbert曲线排序,从上一个三角形出发走到目标三角形,期望O(1)步,
+// 总时间O(n log n)(排序).
+class Delaunay {
+public:
+    // 三角形顶点逆时针;neighbor[i]为顶点i对边另一侧的三角形,-1表示没有
+    struct Triangle {
+        int32_t vertex[3];
+        int32_t neighbor[3];
+    };
+
+    bool build(const double* x, const double* y, size_t n);
+
+    // 全部三角形,包括与外围超级三角形顶点相连的(isReal为false)
+    const std::vector<Triangle>& triangles() const { return triangles_; }
+    bool isReal(const Triangle& t) const {
+        return t.vertex[0] < superBase_ && t.vertex[1] < superBase_ &&
+               t.vertex[2] < superBase_;
+    }
+
+    // 顶点编号即输入点下标;重合点的duplicateOf为先插入的那个点,否则为自身
+    const std::vector<int32_t>& duplicateOf() const { return duplicateOf_; }
+    const std::string& errorString() const { return errorString_; }
+
+private:
+    struct IPoint {
+        int64_t x, y;
+    };
+
+    // 返回包含点v的三角形;v在其某条边上时*edge为该边所对顶点的位置(否则-1),
+    // 与已有顶点重合时*same为该顶点(否则-1)
+    int32_t locate(int32_t v, int32_t start, int* edge, int32_t* same) const;
+    // 符号: >0 为p在有向线段ab左侧
+    int orientation(int32_t a, int32_t b, int32_t p) const;
+    // d在逆时针三角形abc的外接圆内
+    bool inCircle(int32_t a, int32_t b, int32_t c, int32_t d) const;
+    void splitTriangle(int32_t v, int32_t tri);
+    void splitEdge(int32_t v, int32_t tri, int edge);
+    void makeFan(int32_t v, const int32_t* ring, const int32_t* outer,
+                 const int32_t* slots, int count);
+    void relink(int32_t tri, int32_t a, int32_t b, int32_t to);
+    void legalize();
+    void flip(int32_t tri, int32_t other, int j);
+
+    std::vector<IPoint> points_;
+    std::vector<Triangle> triangles_;
+    std::vector<int32_t> duplicateOf_;
+    std::vector<int32_t> flipStack_;
+    int32_t superBase_ = 0;
+    std::string errorString_;
+};
+
+#endif
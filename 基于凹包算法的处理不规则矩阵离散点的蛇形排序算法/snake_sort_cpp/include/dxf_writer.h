@@ -0,0 +1,102 @@
+#ifndef DXF_WRITER_H
+#define DXF_WRITER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 流式ASCII DXF写出器
+//
+// 实体直接写进一块固定大小的缓冲区,满了用write()写出,不在内存中保存实体,
+// 内存占用与点数无关.浮点数按固定小数位手工格式化,不经过printf.
+// 写出出错后后续调用不再写入,close()返回false并给出errorString().
+//
+// R12只写HEADER与ENTITIES两段.R2000(AC1015)要求完整的文件骨架:
+// CLASSES/TABLES/BLOCKS/OBJECTS各段、每个对象的句柄(组码5)与属主(330)、
+// 实体的子类标记(100),以及大于所有句柄的$HANDSEED.$HANDSEED在实体之前写出,
+// 先占位,close()时按实际用到的句柄数用pwrite()回填,因此R2000只能写到普通文件.
+class DxfWriter {
+public:
+    DxfWriter() = default;
+    ~DxfWriter();
+
+    DxfWriter(const DxfWriter&) = delete;
+    DxfWriter& operator=(const DxfWriter&) = delete;
+
+    // R2000的LAYER表写在实体之前,实体用到的图层须在open()之前声明;R12不需要
+    void addLayer(const std::string& name);
+
+    // acadVersion: "AC1009"(R12,POLYLINE) 或 "AC1015"(R2000,可用LWPOLYLINE)
+    bool open(const std::string& path, const char* acadVersion = "AC1009",
+              size_t bufferSize = size_t(1) << 20);
+    bool close();
+
+    // 小数位数(默认6位,UTM坐标即微米)
+    void setPrecision(int decimals);
+
+    void point(const std::string& layer, double x, double y, double z);
+
+    // 三维POLYLINE: beginPolyline后逐个addVertex,最后endPolyline(SEQEND)
+    void beginPolyline(const std::string& layer, bool closed = false);
+    void addVertex(const std::string& layer, double x, double y, double z);
+    void endPolyline(const std::string& layer);
+
+    // 二维LWPOLYLINE: 顶点数必须先写出,之后逐个addLwVertex
+    void beginLwPolyline(const std::string& layer, size_t vertices,
+                         double elevation = 0, bool closed = false);
+    void addLwVertex(double x, double y);
+
+    size_t bytesWritten() const { return written_ + length_; }
+    const std::string& errorString() const { return errorString_; }
+
+private:
+    void writeTables();
+    void writeObjects();
+    void beginTable(const char* name, uint64_t handle, int entries);
+    void beginRecord(const char* type, uint64_t handle, uint64_t table,
+                     const char* subclass);
+    void beginEntity(const char* type, const std::string& layer, uint64_t owner,
+                     const char* subclass);
+    void patchHandseed();
+
+    void group(int code, const std::string& value);
+    void group(int code, const char* value);
+    void groupText(int code, const char* value, size_t size);
+    void groupInt(int code, long long value);
+    void groupDouble(int code, double value);
+    void groupHandle(int code, uint64_t handle);
+    void put(const char* data, size_t size);
+    void putCode(int code);
+    void flush();
+    void fail(const std::string& what);
+
+    int fd_ = -1;
+    std::vector<char> buffer_;
+    size_t length_ = 0;
+    size_t written_ = 0;
+    int precision_ = 6;
+    std::string errorString_;
+
+    bool r2000_ = false;
+    std::vector<std::string> layers_;
+    uint64_t nextHandle_ = 0;
+    uint64_t polylineHandle_ = 0;   // 当前POLYLINE,VERTEX与SEQEND的属主
+    size_t handseedOffset_ = 0;     // $HANDSEED占位值在文件中的偏移
+};
+
+// 蛇形航线导出选项
+struct DxfExportOptions {
+    bool lightweight = false;  // LWPOLYLINE(二维, R2000) 代替 POLYLINE(三维, R12)
+    bool points = true;        // 每个航点另写一个POINT
+    int precision = 6;
+    std::string routeLayer = "ROUTE";
+    std::string pointLayer = "WAYPOINTS";
+};
+
+// 按order的顺序把航点写成一条航线(及各航点);内存占用只有写出缓冲区
+bool exportSnakeDxf(const std::string& path, const double* x, const double* y,
+                    const double* z, const std::vector<uint32_t>& order,
+                    const DxfExportOptions& options, std::string* error);
+
+#endif
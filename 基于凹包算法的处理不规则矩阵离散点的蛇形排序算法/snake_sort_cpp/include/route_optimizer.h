@@ -0,0 +1,90 @@
+#ifndef ROUTE_OPTIMIZER_H
+#define ROUTE_OPTIMIZER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct RouteOptions {
+    // 每个点的候选近邻数(均匀网格上求k近邻).行距大于点距时,
+    // 隔行相连的边要到十几近邻才出现,太少会漏掉跨缺口的改进
+    int neighbours = 16;
+    // Or-opt: 把连续1~orOptLength个点整体挪到别处(可反向); 0 只做2-opt
+    int orOptLength = 3;
+    // 航线按位置切成这么长的段,各段在各自线程里独立优化,段的首尾点不动;
+    // 每一轮把分段错开半段,让跨段的移动在下一轮有机会
+    size_t segmentLength = size_t(1) << 17;
+    // <= 0 时使用硬件线程数
+    int threads = 0;
+    // 时间预算(秒,不含求近邻); <= 0 不限,做到没有改进为止
+    double timeBudget = 0;
+    int maxPasses = 16;
+};
+
+struct RouteStats {
+    double initialLength = 0;
+    double finalLength = 0;
+    size_t twoOptMoves = 0;
+    size_t orOptMoves = 0;
+    int passes = 0;
+    bool timedOut = false;
+    double neighbourSeconds = 0;
+    double optimizeSeconds = 0;
+};
+
+// 开放航线(首尾不相连)的长度
+double routeLength(const double* x, const double* y, const std::vector<uint32_t>& order);
+
+// 以给定顺序(通常是蛇形顺序)为初始航线做2-opt与Or-opt局部改进
+//
+// 候选移动只在k近邻里找,配合don't-look bits: 没有改进的点不再检查,
+// 直到它的邻边被某次移动改动.航线用数组表示,反转与平移的代价不超过段长.
+// 起点与终点保持不变.
+class RouteOptimizer {
+public:
+    bool run(const double* x, const double* y, size_t n, const std::vector<uint32_t>& order,
+             const RouteOptions& options = RouteOptions());
+
+    const std::vector<uint32_t>& order() const { return tour_; }
+    const RouteStats& stats() const { return stats_; }
+    const std::string& errorString() const { return errorString_; }
+
+private:
+    struct Worker;
+
+    void buildNeighbours(int threads);
+    void neighbourRange(size_t begin, size_t end);
+    void optimizeSegment(size_t lo, size_t hi, uint32_t segment, Worker* worker);
+    bool improve(uint32_t a, size_t lo, size_t hi, uint32_t segment, Worker* worker);
+    bool twoOpt(uint32_t a, size_t lo, size_t hi, uint32_t segment, Worker* worker);
+    bool orOpt(uint32_t a, size_t lo, size_t hi, uint32_t segment, Worker* worker);
+    void reverse(size_t from, size_t to);
+    void rotate(size_t first, size_t middle, size_t last);
+
+    double distance(uint32_t a, uint32_t b) const;
+
+    const double* x_ = nullptr;
+    const double* y_ = nullptr;
+    size_t n_ = 0;
+    RouteOptions options_;
+
+    // 均匀网格: 每格约4个点
+    double gridX_ = 0, gridY_ = 0, cellSize_ = 1;
+    size_t gridColumns_ = 0, gridRows_ = 0;
+    std::vector<uint32_t> cellStart_;
+    std::vector<uint32_t> cellPoints_;
+    std::vector<double> cellX_, cellY_;  // 按cellPoints顺序、相对网格原点的坐标
+    int k_ = 0;
+    std::vector<uint32_t> neighbours_;  // 第i个点的近邻为 [i*k, (i+1)*k),由近到远
+
+    std::vector<uint32_t> tour_;       // 位置 -> 点
+    std::vector<uint32_t> position_;   // 点 -> 位置
+    std::vector<uint32_t> segmentOf_;  // 点 -> 本轮所在的段
+    std::vector<uint8_t> active_;      // don't-look bits的反面: 1表示待检查
+
+    RouteStats stats_;
+    std::string errorString_;
+};
+
+#endif
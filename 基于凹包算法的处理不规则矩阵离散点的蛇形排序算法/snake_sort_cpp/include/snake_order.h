@@ -0,0 +1,90 @@
+#ifndef SNAKE_ORDER_H
+#define SNAKE_ORDER_H
+
+#include "concave_hull.h"
+#include "delaunay.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct WaypointCloud;
+
+// 旋转角的来源
+enum class RotationSource {
+    Auto,     // 凹包外接矩形定角度,有航向列时取离航向近的那条边,否则取长边;
+              // 凹包退化时退回航向或PCA
+    Heading,  // AVG_HEADING的轴向平均
+    Pca,      // 点集主方向(行沿长边)
+    Hull,     // 凹包外圈最小面积外接矩形(行沿长边)
+    None      // 不旋转
+};
+
+struct SnakeOptions {
+    RotationSource rotation = RotationSource::Auto;
+    // 用最近邻边的方向(网格方向,模90度)修正初始角度
+    bool refineRotation = true;
+    // 凹包的alpha, <= 0 时为 alphaFactor × 外接圆半径中位数
+    double alpha = 0;
+    double alphaFactor = 2.0;
+    // 分行容差: Y'方向相邻两点的间隔超过它即换行; <= 0 时为最近邻距离中位数的一半
+    double rowTolerance = 0;
+};
+
+// 各阶段耗时(秒)
+struct SnakeTimings {
+    double rotation = 0;
+    double triangulation = 0;
+    double hull = 0;
+    double rows = 0;
+};
+
+// 航向(度,自北顺时针)的轴向平均,换算为行方向相对X轴(东)的弧度;
+// 往返飞行的航向相差180度,取二倍角平均
+double rotationFromHeading(const double* heading, size_t n);
+// 协方差主方向的弧度
+double rotationFromPca(const double* x, const double* y, size_t n);
+// 边界环(点下标)的最小面积外接矩形长边的弧度;不足3个点时返回0
+double rotationFromHull(const double* x, const double* y,
+                        const std::vector<int32_t>& boundary);
+
+// 剖分与凹包 -> 旋转(凹包外接矩形定角度) -> 分行 -> 蛇形排序
+// 把点转到X'OY'坐标系使行与X'轴平行,按Y'分行,奇数行反向,输出访问顺序
+class SnakeSorter {
+public:
+    bool run(const double* x, const double* y, size_t n,
+             const double* heading = nullptr,
+             const SnakeOptions& options = SnakeOptions());
+    // 使用航点UTM坐标与AVG_HEADING
+    bool run(const WaypointCloud& cloud, const SnakeOptions& options = SnakeOptions());
+
+    // 蛇形顺序(点下标)
+    const std::vector<uint32_t>& order() const { return order_; }
+    // 第r行为 order[rowStart[r], rowStart[r + 1])
+    const std::vector<uint32_t>& rowStart() const { return rowStart_; }
+    size_t rowCount() const { return rowStart_.empty() ? 0 : rowStart_.size() - 1; }
+    // 凹包最外圈(逆时针点下标)
+    const std::vector<int32_t>& hull() const { return hull_.boundary(); }
+
+    double rotation() const { return rotation_; }
+    double alpha() const { return hull_.alpha(); }
+    double rowTolerance() const { return rowTolerance_; }
+    const SnakeTimings& timings() const { return timings_; }
+    const std::string& errorString() const { return errorString_; }
+
+private:
+    void nearestNeighbours(const double* x, const double* y, std::vector<float>* length,
+                           std::vector<float>* angle) const;
+
+    Delaunay delaunay_;
+    ConcaveHull hull_;
+    std::vector<uint32_t> order_;
+    std::vector<uint32_t> rowStart_;
+    double rotation_ = 0;
+    double rowTolerance_ = 0;
+    SnakeTimings timings_;
+    std::string errorString_;
+};
+
+#endif
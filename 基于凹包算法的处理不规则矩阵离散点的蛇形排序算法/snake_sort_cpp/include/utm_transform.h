@@ -0,0 +1,55 @@
+#ifndef UTM_TRANSFORM_H
+#define UTM_TRANSFORM_H
+
+#include <cstddef>
+
+struct WaypointCloud;
+
+// UTM分带: 带号1~60,北/南半球(南半球北坐标加10000km)
+struct UtmZone {
+    int number = 50;
+    bool north = true;
+};
+
+// 经纬度所在的标准分带(不处理挪威、斯瓦尔巴的特殊分带)
+UtmZone utmZoneFor(double lon, double lat);
+
+// WGS84经纬度与UTM坐标的批量互转
+//
+// 使用Krüger级数(展开到n^6,Karney 2011),在分带范围内误差为纳米级.
+// 数组按列(SoA)传入;CPU支持AVX2且编译时找到glibc的libmvec时,
+// 每次处理4个点,三角/双曲函数调用libmvec的向量版本,其余为Clenshaw求和;
+// 否则逐点计算,公式相同.
+class UtmTransform {
+public:
+    explicit UtmTransform(UtmZone zone = UtmZone());
+
+    // 经纬度(度) -> 东坐标、北坐标(米)
+    void forward(const double* lon, const double* lat, double* easting,
+                 double* northing, size_t n) const;
+    // 东坐标、北坐标(米) -> 经纬度(度)
+    void inverse(const double* easting, const double* northing, double* lon,
+                 double* lat, size_t n) const;
+
+    const UtmZone& zone() const { return zone_; }
+    // 当前是否走向量路径
+    static bool vectorized();
+
+private:
+    UtmZone zone_;
+    double centralMeridian_;  // 度
+    double falseNorthing_;
+};
+
+// 航点CSV中UTM列与WGS84列的一致性
+struct UtmConsistency {
+    UtmZone zone;
+    double maxError = 0;     // 由经纬度换算的UTM与文件中UTM的最大水平距离(米)
+    size_t worstRow = 0;
+    size_t outliers = 0;     // 超过容差的点数(航点与目标点分别计数)
+};
+
+// 按航点经纬度均值选分带,换算航点与目标点的经纬度并与UTM列比较
+UtmConsistency checkUtmConsistency(const WaypointCloud& cloud, double tolerance);
+
+#endif
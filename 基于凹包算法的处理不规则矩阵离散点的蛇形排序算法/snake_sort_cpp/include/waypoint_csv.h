@@ -0,0 +1,90 @@
+#ifndef WAYPOINT_CSV_H
+#define WAYPOINT_CSV_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// 只读映射的整个文件,析构时解除映射
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path, std::string* error);
+
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    int fd_ = -1;
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+// 航点点云,按列(SoA)存放;列顺序与CSV一致
+struct WaypointCloud {
+    std::vector<int64_t> id;
+    // NAMEING字段在源文件中的位置,不复制字符串
+    std::vector<uint64_t> nameOffset;
+    std::vector<uint32_t> nameLength;
+
+    std::vector<double> waypointUtmX, waypointUtmY, waypointUtmZ;
+    std::vector<double> targetUtmX, targetUtmY, targetUtmZ;
+    std::vector<double> waypointLon, waypointLat, waypointZ;
+    std::vector<double> targetLon, targetLat, targetZ;
+    std::vector<double> avgHeading, avgPitch;
+
+    // nameOffset的基址;从文件加载时source保证其有效
+    const char* nameBase = nullptr;
+    std::shared_ptr<const MappedFile> source;
+
+    size_t size() const { return id.size(); }
+    std::string_view name(size_t i) const;
+
+    void resize(size_t n);
+    // 14个浮点列,下标与CSV第3~16列对应
+    double* column(int k);
+    const double* column(int k) const;
+};
+
+// 16列航点CSV加载器
+// 文件整体mmap,按换行边界切块后可多线程解析,每块直接写入最终数组中的位置
+class WaypointCsvLoader {
+public:
+    static const int kColumns = 16;
+
+    // threads <= 0 时使用硬件线程数
+    bool load(const std::string& path, int threads = 1);
+    // 解析内存中的文本(用于测试与基准);text需在cloud使用期间保持有效
+    bool parse(const char* text, size_t size, int threads = 1);
+
+    const WaypointCloud& cloud() const { return cloud_; }
+    WaypointCloud takeCloud() { return std::move(cloud_); }
+    const std::string& errorString() const { return errorString_; }
+
+private:
+    struct Chunk {
+        const char* begin;
+        const char* end;
+        size_t firstRow;     // 该块第一行在结果中的下标
+        size_t firstLine;    // 该块第一行在文件中的行号(从1开始)
+        std::string error;
+    };
+
+    void parseChunk(Chunk* chunk);
+    bool parseRow(const char* begin, const char* end, size_t row,
+                  std::string* error);
+
+    WaypointCloud cloud_;
+    const char* base_ = nullptr;
+    std::string errorString_;
+};
+
+#endif
@@ -0,0 +1,99 @@
+#include "concave_hull.h"
+
+#include "delaunay.h"
+
+#include <algorithm>
+#include <cmath>
+
+bool ConcaveHull::build(const Delaunay& delaunay, const double* x, const double* y,
+                        double alpha, double alphaFactor) {
+    boundary_.clear();
+    loopCount_ = 0;
+    errorString_.clear();
+
+    const std::vector<Delaunay::Triangle>& triangles = delaunay.triangles();
+    const size_t n = delaunay.duplicateOf().size();
+    if (n == 0) return true;
+    // 以第一个点为原点,避免UTM坐标相减时的精度损失
+    const double ox = x[0], oy = y[0];
+
+    // 外接圆半径 R = abc / (4 * 面积)
+    std::vector<float> radius(triangles.size(), INFINITY);
+    for (size_t i = 0; i < triangles.size(); i++) {
+        const Delaunay::Triangle& t = triangles[i];
+        if (!delaunay.isReal(t)) continue;
+        const double ax = x[t.vertex[0]] - ox, ay = y[t.vertex[0]] - oy;
+        const double bx = x[t.vertex[1]] - ox, by = y[t.vertex[1]] - oy;
+        const double cx = x[t.vertex[2]] - ox, cy = y[t.vertex[2]] - oy;
+        const double area2 = (bx - ax) * (cy - ay) - (by - ay) * (cx - ax);
+        if (area2 <= 0) continue;
+        const double ab = std::hypot(bx - ax, by - ay);
+        const double bc = std::hypot(cx - bx, cy - by);
+        const double ca = std::hypot(ax - cx, ay - cy);
+        radius[i] = static_cast<float>(ab * bc * ca / (2 * area2));
+    }
+
+    if (alpha <= 0) {
+        std::vector<float> finite;
+        finite.reserve(triangles.size());
+        for (float r : radius)
+            if (std::isfinite(r)) finite.push_back(r);
+        if (finite.empty()) {
+            // 全部共线,没有面积
+            alpha_ = 0;
+            return true;
+        }
+        auto mid = finite.begin() + finite.size() / 2;
+        std::nth_element(finite.begin(), mid, finite.end());
+        alpha = alphaFactor * *mid;
+    }
+    alpha_ = alpha;
+
+    std::vector<char> kept(triangles.size());
+    for (size_t i = 0; i < triangles.size(); i++) kept[i] = radius[i] <= alpha;
+
+    // 边界有向边: 保留的三角形在其左侧;按起点挂链表
+    std::vector<int32_t> edgeFrom, edgeTo, nextOut;
+    std::vector<int32_t> firstOut(n, -1);
+    for (size_t i = 0; i < triangles.size(); i++) {
+        if (!kept[i]) continue;
+        const Delaunay::Triangle& t = triangles[i];
+        for (int k = 0; k < 3; k++) {
+            const int32_t other = t.neighbor[k];
+            if (other >= 0 && kept[other]) continue;
+            const int32_t from = t.vertex[(k + 1) % 3];
+            const int32_t to = t.vertex[(k + 2) % 3];
+            nextOut.push_back(firstOut[from]);
+            firstOut[from] = static_cast<int32_t>(edgeFrom.size());
+            edgeFrom.push_back(from);
+            edgeTo.push_back(to);
+        }
+    }
+
+    // 逐条未用过的边出发走成环;多个环共用一个顶点时任取一条出边
+    std::vector<char> used(edgeFrom.size());
+    std::vector<int32_t> loop;
+    double bestArea = 0;
+    for (size_t e0 = 0; e0 < edgeFrom.size(); e0++) {
+        if (used[e0]) continue;
+        loop.clear();
+        const int32_t start = edgeFrom[e0];
+        int32_t e = static_cast<int32_t>(e0);
+        double area2 = 0;
+        while (e >= 0) {
+            used[e] = 1;
+            const int32_t from = edgeFrom[e], to = edgeTo[e];
+            loop.push_back(from);
+            area2 += (x[from] - ox) * (y[to] - oy) - (x[to] - ox) * (y[from] - oy);
+            if (to == start) break;
+            e = firstOut[to];
+            while (e >= 0 && used[e]) e = nextOut[e];
+        }
+        ++loopCount_;
+        if (area2 > bestArea) {
+            bestArea = area2;
+            boundary_ = loop;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,349 @@
+#include "delaunay.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+// 量化后坐标范围[0, 2^26],坐标差小于2^27:
+// 方向判断的乘积小于2^54,内切圆判断的乘积小于2^108
+const int kGridBits = 26;
+
+// 超级三角形的第k个顶点取 R × kSuperDir[k], R → ∞(逆时针).
+// 含超级顶点的判断写成R的多项式,取最高次非零系数的符号,
+// 等于R足够大时有限超级三角形的结果;系数恒为零即真正共线/共圆.
+const int64_t kSuperDir[3][2] = {{-1, -1}, {2, -1}, {-1, 2}};
+
+// >0: p在有向线段ab左侧
+inline int64_t orient(int64_t ax, int64_t ay, int64_t bx, int64_t by, int64_t px,
+                      int64_t py) {
+    return (bx - ax) * (py - ay) - (by - ay) * (px - ax);
+}
+
+// >0: d在逆时针三角形abc的外接圆内
+template <typename P>
+bool inCircle(const P& a, const P& b, const P& c, const P& d) {
+    const int64_t adx = a.x - d.x, ady = a.y - d.y;
+    const int64_t bdx = b.x - d.x, bdy = b.y - d.y;
+    const int64_t cdx = c.x - d.x, cdy = c.y - d.y;
+    const int64_t alift = adx * adx + ady * ady;
+    const int64_t blift = bdx * bdx + bdy * bdy;
+    const int64_t clift = cdx * cdx + cdy * cdy;
+    const __int128 det =
+        static_cast<__int128>(alift) * (bdx * cdy - cdx * bdy) +
+        static_cast<__int128>(blift) * (cdx * ady - adx * cdy) +
+        static_cast<__int128>(clift) * (adx * bdy - bdx * ady);
+    return det > 0;
+}
+
+// c + r × R;实点的r为0,超级顶点的c为0
+struct Linear {
+    int64_t c, r;
+};
+
+struct SymPoint {
+    Linear x, y;
+};
+
+// 编号不小于superBase的是超级顶点
+template <typename P>
+SymPoint symbolic(const std::vector<P>& points, int32_t superBase, int32_t v) {
+    if (v >= superBase) {
+        const int64_t* dir = kSuperDir[v - superBase];
+        return {{0, dir[0]}, {0, dir[1]}};
+    }
+    return {{points[v].x, 0}, {points[v].y, 0}};
+}
+
+inline Linear operator-(const Linear& a, const Linear& b) { return {a.c - b.c, a.r - b.r}; }
+
+// 按R的升幂排列的系数
+struct Quadratic {
+    int64_t k[3];
+};
+
+inline Quadratic operator*(const Linear& a, const Linear& b) {
+    return {{a.c * b.c, a.c * b.r + a.r * b.c, a.r * b.r}};
+}
+
+inline Quadratic operator+(const Quadratic& a, const Quadratic& b) {
+    return {{a.k[0] + b.k[0], a.k[1] + b.k[1], a.k[2] + b.k[2]}};
+}
+
+inline Quadratic operator-(const Quadratic& a, const Quadratic& b) {
+    return {{a.k[0] - b.k[0], a.k[1] - b.k[1], a.k[2] - b.k[2]}};
+}
+
+// R → ∞ 时多项式的符号
+template <typename T, size_t N>
+int leadingSign(const T (&k)[N]) {
+    for (size_t i = N; i-- > 0;)
+        if (k[i] != 0) return k[i] > 0 ? 1 : -1;
+    return 0;
+}
+
+int orientSymbolic(const SymPoint& a, const SymPoint& b, const SymPoint& p) {
+    const Quadratic o = (b.x - a.x) * (p.y - a.y) - (b.y - a.y) * (p.x - a.x);
+    return leadingSign(o.k);
+}
+
+// 系数: 坐标差的常数项小于2^27、R项不超过3,四次多项式的系数远小于2^127
+bool inCircleSymbolic(const SymPoint& a, const SymPoint& b, const SymPoint& c,
+                      const SymPoint& d) {
+    const Linear adx = a.x - d.x, ady = a.y - d.y;
+    const Linear bdx = b.x - d.x, bdy = b.y - d.y;
+    const Linear cdx = c.x - d.x, cdy = c.y - d.y;
+    const Quadratic lift[3] = {adx * adx + ady * ady, bdx * bdx + bdy * bdy,
+                               cdx * cdx + cdy * cdy};
+    const Quadratic cross[3] = {bdx * cdy - cdx * bdy, cdx * ady - adx * cdy,
+                                adx * bdy - bdx * ady};
+    __int128 det[5] = {};
+    for (int i = 0; i < 3; i++)
+        for (int m = 0; m < 3; m++)
+            for (int k = 0; k < 3; k++)
+                det[m + k] += static_cast<__int128>(lift[i].k[m]) * cross[i].k[k];
+    return leadingSign(det) > 0;
+}
+
+// 2^order × 2^order 网格上的Hilbert曲线序号
+uint64_t hilbertIndex(uint32_t x, uint32_t y, int order) {
+    const uint32_t n = uint32_t(1) << order;
+    uint64_t d = 0;
+    for (uint32_t s = n >> 1; s > 0; s >>= 1) {
+        const uint32_t rx = (x & s) ? 1 : 0;
+        const uint32_t ry = (y & s) ? 1 : 0;
+        d += static_cast<uint64_t>(s) * s * ((3 * rx) ^ ry);
+        if (ry == 0) {
+            if (rx == 1) {
+                x = n - 1 - x;
+                y = n - 1 - y;
+            }
+            std::swap(x, y);
+        }
+    }
+    return d;
+}
+
+}  // namespace
+
+bool Delaunay::build(const double* x, const double* y, size_t n) {
+    triangles_.clear();
+    points_.clear();
+    duplicateOf_.clear();
+    errorString_.clear();
+    if (n > static_cast<size_t>(std::numeric_limits<int32_t>::max() / 2 - 3)) {
+        errorString_ = "too many points";
+        return false;
+    }
+
+    double minX = 0, minY = 0, maxX = 0, maxY = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (!std::isfinite(x[i]) || !std::isfinite(y[i])) {
+            errorString_ = "point " + std::to_string(i) + " is not finite";
+            return false;
+        }
+        if (i == 0 || x[i] < minX) minX = x[i];
+        if (i == 0 || x[i] > maxX) maxX = x[i];
+        if (i == 0 || y[i] < minY) minY = y[i];
+        if (i == 0 || y[i] > maxY) maxY = y[i];
+    }
+    const double extent = std::max(maxX - minX, maxY - minY);
+    const double scale = extent > 0 ? static_cast<double>(1 << kGridBits) / extent : 1;
+
+    superBase_ = static_cast<int32_t>(n);
+    points_.resize(n);
+    duplicateOf_.resize(n);
+    for (size_t i = 0; i < n; i++) {
+        points_[i].x = std::llround((x[i] - minX) * scale);
+        points_[i].y = std::llround((y[i] - minY) * scale);
+        duplicateOf_[i] = static_cast<int32_t>(i);
+    }
+    // 超级三角形的顶点只有编号,坐标见kSuperDir
+    triangles_.reserve(2 * n + 1);
+    triangles_.push_back({{superBase_, superBase_ + 1, superBase_ + 2}, {-1, -1, -1}});
+
+    std::vector<std::pair<uint64_t, int32_t>> order(n);
+    for (size_t i = 0; i < n; i++) {
+        order[i] = {hilbertIndex(static_cast<uint32_t>(points_[i].x),
+                                 static_cast<uint32_t>(points_[i].y), kGridBits + 1),
+                    static_cast<int32_t>(i)};
+    }
+    std::sort(order.begin(), order.end());
+
+    int32_t last = 0;
+    for (const auto& item : order) {
+        const int32_t v = item.second;
+        int edge = -1;
+        int32_t same = -1;
+        const int32_t tri = locate(v, last, &edge, &same);
+        if (same >= 0) {
+            duplicateOf_[v] = same;
+            last = tri;
+            continue;
+        }
+        if (edge >= 0) {
+            splitEdge(v, tri, edge);
+        } else {
+            splitTriangle(v, tri);
+        }
+        legalize();
+        last = tri;
+    }
+    return true;
+}
+
+int Delaunay::orientation(int32_t a, int32_t b, int32_t p) const {
+    if (a < superBase_ && b < superBase_ && p < superBase_) {
+        const IPoint& pa = points_[a];
+        const IPoint& pb = points_[b];
+        const IPoint& pp = points_[p];
+        const int64_t o = orient(pa.x, pa.y, pb.x, pb.y, pp.x, pp.y);
+        return (o > 0) - (o < 0);
+    }
+    return orientSymbolic(symbolic(points_, superBase_, a), symbolic(points_, superBase_, b),
+                          symbolic(points_, superBase_, p));
+}
+
+bool Delaunay::inCircle(int32_t a, int32_t b, int32_t c, int32_t d) const {
+    if (a < superBase_ && b < superBase_ && c < superBase_ && d < superBase_)
+        return ::inCircle(points_[a], points_[b], points_[c], points_[d]);
+    return inCircleSymbolic(symbolic(points_, superBase_, a),
+                            symbolic(points_, superBase_, b),
+                            symbolic(points_, superBase_, c),
+                            symbolic(points_, superBase_, d));
+}
+
+int32_t Delaunay::locate(int32_t v, int32_t start, int* edge, int32_t* same) const {
+    const IPoint& p = points_[v];
+    int32_t tri = start;
+    while (true) {
+        const Triangle& t = triangles_[tri];
+        int zeros = 0, zeroEdge = -1;
+        bool moved = false;
+        for (int i = 0; i < 3; i++) {
+            const int o = orientation(t.vertex[(i + 1) % 3], t.vertex[(i + 2) % 3], v);
+            if (o < 0) {
+                // Delaunay剖分上的可见性行走必然终止
+                tri = t.neighbor[i];
+                moved = true;
+                break;
+            }
+            if (o == 0) {
+                ++zeros;
+                zeroEdge = i;
+            }
+        }
+        if (moved) continue;
+
+        *edge = -1;
+        *same = -1;
+        if (zeros >= 2) {
+            for (int i = 0; i < 3; i++) {
+                if (t.vertex[i] >= superBase_) continue;
+                const IPoint& q = points_[t.vertex[i]];
+                if (q.x == p.x && q.y == p.y) *same = t.vertex[i];
+            }
+        } else if (zeros == 1) {
+            *edge = zeroEdge;
+        }
+        return tri;
+    }
+}
+
+// 以v为中心,用slots中的三角形围成扇形: 第k个为 (v, ring[k], ring[k+1]),
+// 其外侧邻居为outer[k]
+void Delaunay::makeFan(int32_t v, const int32_t* ring, const int32_t* outer,
+                       const int32_t* slots, int count) {
+    for (int k = 0; k < count; k++) {
+        const int next = (k + 1) % count;
+        const int prev = (k + count - 1) % count;
+        Triangle& t = triangles_[slots[k]];
+        t.vertex[0] = v;
+        t.vertex[1] = ring[k];
+        t.vertex[2] = ring[next];
+        t.neighbor[0] = outer[k];
+        t.neighbor[1] = slots[next];
+        t.neighbor[2] = slots[prev];
+        if (outer[k] >= 0) relink(outer[k], ring[k], ring[next], slots[k]);
+        flipStack_.push_back(slots[k]);
+    }
+}
+
+// 三角形tri中边ab对面的邻居改为to
+void Delaunay::relink(int32_t tri, int32_t a, int32_t b, int32_t to) {
+    Triangle& t = triangles_[tri];
+    for (int i = 0; i < 3; i++) {
+        if (t.vertex[i] != a && t.vertex[i] != b) {
+            t.neighbor[i] = to;
+            return;
+        }
+    }
+}
+
+void Delaunay::splitTriangle(int32_t v, int32_t tri) {
+    const Triangle t = triangles_[tri];
+    const int32_t base = static_cast<int32_t>(triangles_.size());
+    triangles_.resize(triangles_.size() + 2);
+    const int32_t ring[3] = {t.vertex[0], t.vertex[1], t.vertex[2]};
+    const int32_t outer[3] = {t.neighbor[2], t.neighbor[0], t.neighbor[1]};
+    const int32_t slots[3] = {tri, base, base + 1};
+    makeFan(v, ring, outer, slots, 3);
+}
+
+// v落在tri中第edge个顶点的对边上: 该边两侧的两个三角形拆成四个
+void Delaunay::splitEdge(int32_t v, int32_t tri, int edge) {
+    const Triangle t = triangles_[tri];
+    const int32_t c = t.vertex[edge];
+    const int32_t a = t.vertex[(edge + 1) % 3];
+    const int32_t b = t.vertex[(edge + 2) % 3];
+    const int32_t other = t.neighbor[edge];
+    const Triangle u = triangles_[other];
+    int j = 0;
+    while (u.neighbor[j] != tri) ++j;
+    const int32_t q = u.vertex[j];
+
+    const int32_t base = static_cast<int32_t>(triangles_.size());
+    triangles_.resize(triangles_.size() + 2);
+    const int32_t ring[4] = {b, c, a, q};
+    const int32_t outer[4] = {t.neighbor[(edge + 1) % 3], t.neighbor[(edge + 2) % 3],
+                              u.neighbor[(j + 1) % 3], u.neighbor[(j + 2) % 3]};
+    const int32_t slots[4] = {tri, other, base, base + 1};
+    makeFan(v, ring, outer, slots, 4);
+}
+
+// 新插入的点总在vertex[0],只需检查它的对边
+void Delaunay::legalize() {
+    while (!flipStack_.empty()) {
+        const int32_t tri = flipStack_.back();
+        flipStack_.pop_back();
+        const Triangle& t = triangles_[tri];
+        const int32_t other = t.neighbor[0];
+        if (other < 0) continue;
+        const Triangle& u = triangles_[other];
+        int j = 0;
+        while (u.neighbor[j] != tri) ++j;
+        if (inCircle(t.vertex[0], t.vertex[1], t.vertex[2], u.vertex[j])) {
+            flip(tri, other, j);
+        }
+    }
+}
+
+// t = (p, a, b) 与 u = (q, b, a) 的公共边ab换成pq
+void Delaunay::flip(int32_t tri, int32_t other, int j) {
+    Triangle& t = triangles_[tri];
+    Triangle& u = triangles_[other];
+    const int32_t p = t.vertex[0], a = t.vertex[1], b = t.vertex[2];
+    const int32_t q = u.vertex[j];
+    const int32_t tOppA = t.neighbor[1];  // 边 b-p
+    const int32_t tOppB = t.neighbor[2];  // 边 p-a
+    const int32_t uOppB = u.neighbor[(j + 1) % 3];  // 边 a-q
+    const int32_t uOppA = u.neighbor[(j + 2) % 3];  // 边 q-b
+
+    t = {{p, a, q}, {uOppB, other, tOppB}};
+    u = {{p, q, b}, {uOppA, tOppA, tri}};
+    if (uOppB >= 0) relink(uOppB, a, q, tri);
+    if (tOppA >= 0) relink(tOppA, b, p, other);
+    flipStack_.push_back(tri);
+    flipStack_.push_back(other);
+}
@@ -0,0 +1,583 @@
+#include "dxf_writer.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+const uint64_t kPow10[] = {1,         10,         100,         1000,      10000,
+                           100000,    1000000,    10000000,    100000000,
+                           1000000000};
+const int kMaxPrecision = 9;
+
+// 一个数字最长的格式化结果(超出快速路径范围时用snprintf)
+const size_t kMaxNumber = 64;
+
+// "00".."99"
+const char kDigitPairs[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+// 无符号整数写出,返回写出的位数
+inline int writeDigits(char* out, uint64_t v) {
+    char tmp[20];
+    char* p = tmp + sizeof(tmp);
+    while (v >= 100) {
+        const uint64_t pair = v % 100;
+        v /= 100;
+        p -= 2;
+        std::memcpy(p, kDigitPairs + pair * 2, 2);
+    }
+    if (v >= 10) {
+        p -= 2;
+        std::memcpy(p, kDigitPairs + v * 2, 2);
+    } else {
+        *--p = static_cast<char>('0' + v);
+    }
+    const int n = static_cast<int>(tmp + sizeof(tmp) - p);
+    std::memcpy(out, p, static_cast<size_t>(n));
+    return n;
+}
+
+// 固定小数位: |v| × 10^D 小于2^53时四舍五入成整数,拆成整数与小数两部分写出,
+// 与printf("%.*f")的结果至多在最后一位相差1.
+// 小数位数作为模板参数,除以10^D成为常数除法
+template <int D>
+size_t formatFixed(char* out, double v) {
+    const double scaled = std::fabs(v) * static_cast<double>(kPow10[D]);
+    if (!(scaled < 9007199254740992.0)) {
+        int n = std::snprintf(out, kMaxNumber, "%.*f", D, v);
+        return n < 0 ? 0 : static_cast<size_t>(std::min<int>(n, kMaxNumber - 1));
+    }
+    const uint64_t r = static_cast<uint64_t>(scaled + 0.5);
+    char* p = out;
+    if (v < 0 && r != 0) *p++ = '-';
+    p += writeDigits(p, r / kPow10[D]);
+    if (D > 0) {
+        *p++ = '.';
+        uint64_t frac = r % kPow10[D];
+        int i = D;
+        for (; i >= 2; i -= 2) {
+            std::memcpy(p + i - 2, kDigitPairs + (frac % 100) * 2, 2);
+            frac /= 100;
+        }
+        if (i == 1) p[0] = static_cast<char>('0' + frac);
+        p += D;
+    }
+    return static_cast<size_t>(p - out);
+}
+
+size_t formatFixed(char* out, double v, int decimals) {
+    switch (decimals) {
+        case 0: return formatFixed<0>(out, v);
+        case 1: return formatFixed<1>(out, v);
+        case 2: return formatFixed<2>(out, v);
+        case 3: return formatFixed<3>(out, v);
+        case 4: return formatFixed<4>(out, v);
+        case 5: return formatFixed<5>(out, v);
+        case 6: return formatFixed<6>(out, v);
+        case 7: return formatFixed<7>(out, v);
+        case 8: return formatFixed<8>(out, v);
+        default: return formatFixed<9>(out, v);
+    }
+}
+
+// 组码按DXF习惯右对齐到3位,连同换行共4字节
+inline void formatCode(char* out, int code) {
+    out[0] = code >= 100 ? static_cast<char>('0' + code / 100) : ' ';
+    out[1] = code >= 10 ? static_cast<char>('0' + code / 10 % 10) : ' ';
+    out[2] = static_cast<char>('0' + code % 10);
+    out[3] = '\n';
+}
+
+// R2000骨架中固定对象的句柄,沿用AutoCAD新建图形时的编号;
+// 图层与实体的句柄从kFirstHandle起顺序分配
+const uint64_t kBlockRecordTable = 0x1;
+const uint64_t kLayerTable = 0x2;
+const uint64_t kStyleTable = 0x3;
+const uint64_t kLtypeTable = 0x5;
+const uint64_t kViewTable = 0x6;
+const uint64_t kUcsTable = 0x7;
+const uint64_t kVportTable = 0x8;
+const uint64_t kAppidTable = 0x9;
+const uint64_t kDimstyleTable = 0xA;
+const uint64_t kRootDictionary = 0xC;
+const uint64_t kGroupDictionary = 0xD;
+const uint64_t kLayerZero = 0x10;
+const uint64_t kStyleStandard = 0x11;
+const uint64_t kAppidAcad = 0x12;
+const uint64_t kLtypeByBlock = 0x14;
+const uint64_t kLtypeByLayer = 0x15;
+const uint64_t kLtypeContinuous = 0x16;
+const uint64_t kPaperSpaceRecord = 0x1B;
+const uint64_t kPaperSpaceBlock = 0x1C;
+const uint64_t kPaperSpaceEnd = 0x1D;
+const uint64_t kModelSpaceRecord = 0x1F;
+const uint64_t kModelSpaceBlock = 0x20;
+const uint64_t kModelSpaceEnd = 0x21;
+const uint64_t kDimstyleStandard = 0x27;
+const uint64_t kFirstHandle = 0x30;
+
+// $HANDSEED占位为16位十六进制(句柄的最大长度),回填时长度不变
+const size_t kHandseedDigits = 16;
+
+// 句柄按十六进制大写写出;width为0时不补前导零
+inline size_t formatHandle(char* out, uint64_t handle, size_t width) {
+    char tmp[16];
+    size_t n = 0;
+    do {
+        tmp[n++] = "0123456789ABCDEF"[handle & 0xF];
+        handle >>= 4;
+    } while (handle != 0);
+    while (n < width) tmp[n++] = '0';
+    for (size_t i = 0; i < n; i++) out[i] = tmp[n - 1 - i];
+    return n;
+}
+
+}  // namespace
+
+DxfWriter::~DxfWriter() {
+    if (fd_ >= 0) close();
+}
+
+bool DxfWriter::open(const std::string& path, const char* acadVersion,
+                     size_t bufferSize) {
+    errorString_.clear();
+    fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd_ < 0) {
+        errorString_ = "cannot create " + path + ": " + std::strerror(errno);
+        return false;
+    }
+    buffer_.assign(bufferSize < 4096 ? 4096 : bufferSize, 0);
+    length_ = 0;
+    written_ = 0;
+    r2000_ = std::strcmp(acadVersion, "AC1015") >= 0;
+    nextHandle_ = kFirstHandle;
+
+    group(0, "SECTION");
+    group(2, "HEADER");
+    group(9, "$ACADVER");
+    group(1, acadVersion);
+    if (r2000_) {
+        group(9, "$HANDSEED");
+        putCode(5);
+        handseedOffset_ = bytesWritten();
+        put("0000000000000000\n", kHandseedDigits + 1);
+    }
+    group(0, "ENDSEC");
+    if (r2000_) writeTables();
+    group(0, "SECTION");
+    group(2, "ENTITIES");
+    return true;
+}
+
+bool DxfWriter::close() {
+    if (fd_ < 0) return errorString_.empty();
+    group(0, "ENDSEC");
+    if (r2000_) writeObjects();
+    group(0, "EOF");
+    flush();
+    if (r2000_) patchHandseed();
+    if (fd_ >= 0 && ::close(fd_) != 0 && errorString_.empty())
+        errorString_ = std::string("close failed: ") + std::strerror(errno);
+    fd_ = -1;
+    std::vector<char>().swap(buffer_);
+    return errorString_.empty();
+}
+
+void DxfWriter::addLayer(const std::string& name) {
+    if (name == "0" || std::find(layers_.begin(), layers_.end(), name) != layers_.end())
+        return;
+    layers_.push_back(name);
+}
+
+// CLASSES(空)、TABLES与BLOCKS: R2000要求的全部符号表及模型/图纸空间块
+void DxfWriter::writeTables() {
+    group(0, "SECTION");
+    group(2, "CLASSES");
+    group(0, "ENDSEC");
+
+    group(0, "SECTION");
+    group(2, "TABLES");
+
+    beginTable("VPORT", kVportTable, 0);
+    group(0, "ENDTAB");
+
+    beginTable("LTYPE", kLtypeTable, 3);
+    const struct {
+        uint64_t handle;
+        const char* name;
+        const char* description;
+    } ltypes[] = {{kLtypeByBlock, "ByBlock", ""},
+                  {kLtypeByLayer, "ByLayer", ""},
+                  {kLtypeContinuous, "Continuous", "Solid line"}};
+    for (const auto& ltype : ltypes) {
+        beginRecord("LTYPE", ltype.handle, kLtypeTable, "AcDbLinetypeTableRecord");
+        group(2, ltype.name);
+        groupInt(70, 0);
+        group(3, ltype.description);
+        groupInt(72, 65);
+        groupInt(73, 0);
+        groupDouble(40, 0);
+    }
+    group(0, "ENDTAB");
+
+    beginTable("LAYER", kLayerTable, static_cast<int>(layers_.size() + 1));
+    for (size_t i = 0; i <= layers_.size(); i++) {
+        beginRecord("LAYER", i == 0 ? kLayerZero : nextHandle_++, kLayerTable,
+                    "AcDbLayerTableRecord");
+        group(2, i == 0 ? std::string("0") : layers_[i - 1]);
+        groupInt(70, 0);
+        groupInt(62, 7);
+        group(6, "Continuous");
+    }
+    group(0, "ENDTAB");
+
+    beginTable("STYLE", kStyleTable, 1);
+    beginRecord("STYLE", kStyleStandard, kStyleTable, "AcDbTextStyleTableRecord");
+    group(2, "Standard");
+    groupInt(70, 0);
+    groupDouble(40, 0);
+    groupDouble(41, 1);
+    groupDouble(50, 0);
+    groupInt(71, 0);
+    groupDouble(42, 2.5);
+    group(3, "txt");
+    group(4, "");
+    group(0, "ENDTAB");
+
+    beginTable("VIEW", kViewTable, 0);
+    group(0, "ENDTAB");
+
+    beginTable("UCS", kUcsTable, 0);
+    group(0, "ENDTAB");
+
+    beginTable("APPID", kAppidTable, 1);
+    beginRecord("APPID", kAppidAcad, kAppidTable, "AcDbRegAppTableRecord");
+    group(2, "ACAD");
+    groupInt(70, 0);
+    group(0, "ENDTAB");
+
+    // DIMSTYLE表多一个子类标记,表项的句柄用组码105
+    beginTable("DIMSTYLE", kDimstyleTable, 1);
+    group(100, "AcDbDimStyleTable");
+    group(0, "DIMSTYLE");
+    groupHandle(105, kDimstyleStandard);
+    groupHandle(330, kDimstyleTable);
+    group(100, "AcDbSymbolTableRecord");
+    group(100, "AcDbDimStyleTableRecord");
+    group(2, "Standard");
+    groupInt(70, 0);
+    group(0, "ENDTAB");
+
+    beginTable("BLOCK_RECORD", kBlockRecordTable, 2);
+    beginRecord("BLOCK_RECORD", kModelSpaceRecord, kBlockRecordTable,
+                "AcDbBlockTableRecord");
+    group(2, "*Model_Space");
+    beginRecord("BLOCK_RECORD", kPaperSpaceRecord, kBlockRecordTable,
+                "AcDbBlockTableRecord");
+    group(2, "*Paper_Space");
+    group(0, "ENDTAB");
+
+    group(0, "ENDSEC");
+
+    group(0, "SECTION");
+    group(2, "BLOCKS");
+    const struct {
+        uint64_t record, begin, end;
+        const char* name;
+        bool paper;
+    } blocks[] = {{kModelSpaceRecord, kModelSpaceBlock, kModelSpaceEnd, "*Model_Space", false},
+                  {kPaperSpaceRecord, kPaperSpaceBlock, kPaperSpaceEnd, "*Paper_Space", true}};
+    for (const auto& block : blocks) {
+        group(0, "BLOCK");
+        groupHandle(5, block.begin);
+        groupHandle(330, block.record);
+        group(100, "AcDbEntity");
+        if (block.paper) groupInt(67, 1);
+        group(8, "0");
+        group(100, "AcDbBlockBegin");
+        group(2, block.name);
+        groupInt(70, 0);
+        groupDouble(10, 0);
+        groupDouble(20, 0);
+        groupDouble(30, 0);
+        group(3, block.name);
+        group(1, "");
+        group(0, "ENDBLK");
+        groupHandle(5, block.end);
+        groupHandle(330, block.record);
+        group(100, "AcDbEntity");
+        if (block.paper) groupInt(67, 1);
+        group(8, "0");
+        group(100, "AcDbBlockEnd");
+    }
+    group(0, "ENDSEC");
+}
+
+// OBJECTS: 根字典及其下的ACAD_GROUP字典
+void DxfWriter::writeObjects() {
+    group(0, "SECTION");
+    group(2, "OBJECTS");
+    group(0, "DICTIONARY");
+    groupHandle(5, kRootDictionary);
+    groupHandle(330, 0);
+    group(100, "AcDbDictionary");
+    groupInt(281, 1);
+    group(3, "ACAD_GROUP");
+    groupHandle(350, kGroupDictionary);
+    group(0, "DICTIONARY");
+    groupHandle(5, kGroupDictionary);
+    groupHandle(330, kRootDictionary);
+    group(100, "AcDbDictionary");
+    groupInt(281, 1);
+    group(0, "ENDSEC");
+}
+
+void DxfWriter::beginTable(const char* name, uint64_t handle, int entries) {
+    group(0, "TABLE");
+    group(2, name);
+    groupHandle(5, handle);
+    groupHandle(330, 0);
+    group(100, "AcDbSymbolTable");
+    groupInt(70, entries);
+}
+
+void DxfWriter::beginRecord(const char* type, uint64_t handle, uint64_t table,
+                            const char* subclass) {
+    group(0, type);
+    groupHandle(5, handle);
+    groupHandle(330, table);
+    group(100, "AcDbSymbolTableRecord");
+    group(100, subclass);
+}
+
+// 实体头: R12只有类型与图层,R2000加句柄、属主与子类标记
+void DxfWriter::beginEntity(const char* type, const std::string& layer, uint64_t owner,
+                            const char* subclass) {
+    group(0, type);
+    if (r2000_) {
+        groupHandle(5, nextHandle_++);
+        groupHandle(330, owner);
+        group(100, "AcDbEntity");
+    }
+    group(8, layer);
+    if (r2000_ && subclass) group(100, subclass);
+}
+
+// 所有句柄都已分配,把$HANDSEED的占位改成下一个可用句柄
+void DxfWriter::patchHandseed() {
+    if (fd_ < 0) return;
+    char text[kHandseedDigits];
+    formatHandle(text, nextHandle_, kHandseedDigits);
+    if (::pwrite(fd_, text, sizeof(text), static_cast<off_t>(handseedOffset_)) !=
+        static_cast<ssize_t>(sizeof(text)))
+        fail(std::string("cannot update $HANDSEED: ") + std::strerror(errno));
+}
+
+void DxfWriter::setPrecision(int decimals) {
+    precision_ = decimals < 0 ? 0 : (decimals > kMaxPrecision ? kMaxPrecision : decimals);
+}
+
+void DxfWriter::point(const std::string& layer, double x, double y, double z) {
+    beginEntity("POINT", layer, kModelSpaceRecord, "AcDbPoint");
+    groupDouble(10, x);
+    groupDouble(20, y);
+    groupDouble(30, z);
+}
+
+void DxfWriter::beginPolyline(const std::string& layer, bool closed) {
+    polylineHandle_ = nextHandle_;
+    beginEntity("POLYLINE", layer, kModelSpaceRecord, "AcDb3dPolyline");
+    groupInt(66, 1);  // 后面跟VERTEX
+    groupDouble(10, 0);
+    groupDouble(20, 0);
+    groupDouble(30, 0);
+    groupInt(70, 8 | (closed ? 1 : 0));  // 8: 三维多段线
+}
+
+void DxfWriter::addVertex(const std::string& layer, double x, double y, double z) {
+    beginEntity("VERTEX", layer, polylineHandle_, "AcDbVertex");
+    if (r2000_) group(100, "AcDb3dPolylineVertex");
+    groupDouble(10, x);
+    groupDouble(20, y);
+    groupDouble(30, z);
+    groupInt(70, 32);  // 三维多段线的顶点
+}
+
+void DxfWriter::endPolyline(const std::string& layer) {
+    beginEntity("SEQEND", layer, polylineHandle_, nullptr);
+}
+
+void DxfWriter::beginLwPolyline(const std::string& layer, size_t vertices,
+                                double elevation, bool closed) {
+    beginEntity("LWPOLYLINE", layer, kModelSpaceRecord, "AcDbPolyline");
+    groupInt(90, static_cast<long long>(vertices));
+    groupInt(70, closed ? 1 : 0);
+    groupDouble(38, elevation);
+}
+
+void DxfWriter::addLwVertex(double x, double y) {
+    groupDouble(10, x);
+    groupDouble(20, y);
+}
+
+void DxfWriter::group(int code, const std::string& value) {
+    groupText(code, value.data(), value.size());
+}
+
+void DxfWriter::group(int code, const char* value) {
+    groupText(code, value, std::strlen(value));
+}
+
+// 放得下时组码、文本与换行一次写进缓冲区
+void DxfWriter::groupText(int code, const char* value, size_t size) {
+    if (fd_ < 0) return;
+    if (buffer_.size() - length_ < size + 5) flush();
+    if (buffer_.size() - length_ >= size + 5) {
+        char* out = buffer_.data() + length_;
+        formatCode(out, code);
+        std::memcpy(out + 4, value, size);
+        out[4 + size] = '\n';
+        length_ += size + 5;
+        return;
+    }
+    putCode(code);
+    put(value, size);
+    put("\n", 1);
+}
+
+void DxfWriter::groupInt(int code, long long value) {
+    putCode(code);
+    char text[24];
+    char* p = text;
+    unsigned long long magnitude = static_cast<unsigned long long>(value);
+    if (value < 0) {
+        *p++ = '-';
+        magnitude = 0 - magnitude;
+    }
+    p += writeDigits(p, magnitude);
+    *p++ = '\n';
+    put(text, static_cast<size_t>(p - text));
+}
+
+void DxfWriter::groupHandle(int code, uint64_t handle) {
+    char text[kHandseedDigits];
+    groupText(code, text, formatHandle(text, handle, 0));
+}
+
+// 组码与数值一起直接格式化进缓冲区
+void DxfWriter::groupDouble(int code, double value) {
+    if (fd_ < 0) return;
+    if (buffer_.size() - length_ < kMaxNumber + 5) flush();
+    char* out = buffer_.data() + length_;
+    formatCode(out, code);
+    size_t n = 4 + formatFixed(out + 4, value, precision_);
+    out[n++] = '\n';
+    length_ += n;
+}
+
+void DxfWriter::putCode(int code) {
+    char text[4];
+    formatCode(text, code);
+    put(text, sizeof(text));
+}
+
+void DxfWriter::put(const char* data, size_t size) {
+    if (fd_ < 0) return;
+    if (buffer_.size() - length_ < size) {
+        flush();
+        if (size > buffer_.size()) {
+            // 超长的值(图层名等)直接写出
+            ssize_t n = ::write(fd_, data, size);
+            if (n != static_cast<ssize_t>(size)) fail("write failed");
+            else written_ += size;
+            return;
+        }
+    }
+    std::memcpy(buffer_.data() + length_, data, size);
+    length_ += size;
+}
+
+void DxfWriter::flush() {
+    size_t done = 0;
+    while (fd_ >= 0 && done < length_) {
+        ssize_t n = ::write(fd_, buffer_.data() + done, length_ - done);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {
+            fail(std::string("write failed: ") + std::strerror(errno));
+            break;
+        }
+        done += static_cast<size_t>(n);
+    }
+    written_ += done;
+    length_ = 0;
+}
+
+// 出错后关闭文件,后续写入全部忽略
+void DxfWriter::fail(const std::string& what) {
+    if (errorString_.empty()) errorString_ = what;
+    if (fd_ >= 0) ::close(fd_);
+    fd_ = -1;
+}
+
+bool exportSnakeDxf(const std::string& path, const double* x, const double* y,
+                    const double* z, const std::vector<uint32_t>& order,
+                    const DxfExportOptions& options, std::string* error) {
+    DxfWriter writer;
+    writer.addLayer(options.routeLayer);
+    if (options.points) writer.addLayer(options.pointLayer);
+    if (!writer.open(path, options.lightweight ? "AC1015" : "AC1009")) {
+        if (error) *error = writer.errorString();
+        return false;
+    }
+    writer.setPrecision(options.precision);
+
+    // 按order访问坐标是随机访问,提前预取后面第kAhead个点
+    const size_t kAhead = 16;
+    auto prefetch = [&](size_t k) {
+        if (k + kAhead >= order.size()) return;
+        const uint32_t i = order[k + kAhead];
+        __builtin_prefetch(x + i);
+        __builtin_prefetch(y + i);
+        if (z) __builtin_prefetch(z + i);
+    };
+
+    if (!order.empty()) {
+        if (options.lightweight) {
+            writer.beginLwPolyline(options.routeLayer, order.size(), z ? z[order[0]] : 0);
+            for (size_t k = 0; k < order.size(); k++) {
+                prefetch(k);
+                writer.addLwVertex(x[order[k]], y[order[k]]);
+            }
+        } else {
+            writer.beginPolyline(options.routeLayer);
+            for (size_t k = 0; k < order.size(); k++) {
+                prefetch(k);
+                const uint32_t i = order[k];
+                writer.addVertex(options.routeLayer, x[i], y[i], z ? z[i] : 0);
+            }
+            writer.endPolyline(options.routeLayer);
+        }
+    }
+    if (options.points) {
+        for (size_t k = 0; k < order.size(); k++) {
+            prefetch(k);
+            const uint32_t i = order[k];
+            writer.point(options.pointLayer, x[i], y[i], z ? z[i] : 0);
+        }
+    }
+
+    if (!writer.close()) {
+        if (error) *error = writer.errorString();
+        return false;
+    }
+    return true;
+}
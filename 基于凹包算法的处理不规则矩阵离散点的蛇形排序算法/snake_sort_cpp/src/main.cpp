@@ -0,0 +1,125 @@
+#include "dxf_writer.h"
+#include "route_optimizer.h"
+#include "snake_order.h"
+#include "utm_transform.h"
+#include "waypoint_csv.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+        .count();
+}
+
+// 按航线顺序写出: 序号,ID,NAMEING,行号(点在蛇形分行中的行)
+bool writeOrder(const char* path, const WaypointCloud& cloud, const SnakeSorter& sorter,
+                const std::vector<uint32_t>& order) {
+    FILE* fp = std::fopen(path, "w");
+    if (!fp) return false;
+    std::fputs("ORDER,ID,NAMEING,ROW\n", fp);
+    const std::vector<uint32_t>& snake = sorter.order();
+    const std::vector<uint32_t>& rowStart = sorter.rowStart();
+    std::vector<uint32_t> rowOf(snake.size());
+    for (size_t r = 0; r + 1 < rowStart.size(); r++)
+        for (uint32_t i = rowStart[r]; i < rowStart[r + 1]; i++)
+            rowOf[snake[i]] = static_cast<uint32_t>(r);
+    for (size_t i = 0; i < order.size(); i++) {
+        const std::string_view name = cloud.name(order[i]);
+        std::fprintf(fp, "%zu,%lld,%.*s,%u\n", i + 1,
+                     static_cast<long long>(cloud.id[order[i]]),
+                     static_cast<int>(name.size()), name.data(), rowOf[order[i]] + 1);
+    }
+    return std::fclose(fp) == 0;
+}
+
+}  // namespace
+
+// 用法: snake_sort <航点CSV> [线程数] [输出CSV] [输出DXF] [航线优化秒数]
+// 航线优化秒数 > 0 时以蛇形顺序为初始航线做2-opt/Or-opt改进,输出改进后的顺序
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::fprintf(stderr,
+                     "usage: %s <waypoints.csv> [threads] [order.csv] [route.dxf] "
+                     "[optimize seconds]\n",
+                     argv[0]);
+        return 1;
+    }
+    int threads = argc > 2 ? std::atoi(argv[2]) : 0;
+
+    auto start = std::chrono::steady_clock::now();
+    WaypointCsvLoader loader;
+    if (!loader.load(argv[1], threads)) {
+        std::fprintf(stderr, "%s\n", loader.errorString().c_str());
+        return 1;
+    }
+    double sec = secondsSince(start);
+
+    const WaypointCloud& cloud = loader.cloud();
+    std::printf("loaded %zu waypoints in %.3f s\n", cloud.size(), sec);
+    if (cloud.size() > 0) {
+        std::string first(cloud.name(0));
+        std::printf("first: %lld %s (%.6f, %.6f)\n",
+                    static_cast<long long>(cloud.id[0]), first.c_str(),
+                    cloud.waypointUtmX[0], cloud.waypointUtmY[0]);
+    }
+
+    // UTM列与经纬度列互相核对(容差5cm)
+    start = std::chrono::steady_clock::now();
+    UtmConsistency check = checkUtmConsistency(cloud, 0.05);
+    std::printf("utm check in %.3f s: zone %d%c, max error %.3f m (row %zu), "
+                "%zu outliers\n",
+                secondsSince(start), check.zone.number, check.zone.north ? 'N' : 'S',
+                check.maxError, check.worstRow + 1, check.outliers);
+
+    start = std::chrono::steady_clock::now();
+    SnakeSorter sorter;
+    if (!sorter.run(cloud)) {
+        std::fprintf(stderr, "%s\n", sorter.errorString().c_str());
+        return 1;
+    }
+    std::printf("snake order in %.3f s: rotation %.3f deg, %zu rows, "
+                "hull %zu points (alpha %.3f)\n",
+                secondsSince(start), sorter.rotation() * 180 / 3.14159265358979323846,
+                sorter.rowCount(), sorter.hull().size(), sorter.alpha());
+
+    std::vector<uint32_t> order = sorter.order();
+    const double optimizeSeconds = argc > 5 ? std::atof(argv[5]) : 0;
+    if (optimizeSeconds > 0) {
+        RouteOptions options;
+        options.threads = threads;
+        options.timeBudget = optimizeSeconds;
+        RouteOptimizer optimizer;
+        if (!optimizer.run(cloud.waypointUtmX.data(), cloud.waypointUtmY.data(), cloud.size(),
+                           order, options)) {
+            std::fprintf(stderr, "%s\n", optimizer.errorString().c_str());
+            return 1;
+        }
+        const RouteStats& s = optimizer.stats();
+        std::printf("route optimized in %.3f s: %.1f m -> %.1f m, %zu 2-opt and %zu or-opt "
+                    "moves%s\n",
+                    s.neighbourSeconds + s.optimizeSeconds, s.initialLength, s.finalLength,
+                    s.twoOptMoves, s.orOptMoves, s.timedOut ? " (time budget reached)" : "");
+        order = optimizer.order();
+    }
+
+    if (argc > 3 && !writeOrder(argv[3], cloud, sorter, order)) {
+        std::fprintf(stderr, "cannot write %s\n", argv[3]);
+        return 1;
+    }
+    if (argc > 4) {
+        start = std::chrono::steady_clock::now();
+        std::string error;
+        if (!exportSnakeDxf(argv[4], cloud.waypointUtmX.data(), cloud.waypointUtmY.data(),
+                            cloud.waypointUtmZ.data(), order, DxfExportOptions(),
+                            &error)) {
+            std::fprintf(stderr, "%s\n", error.c_str());
+            return 1;
+        }
+        std::printf("dxf written in %.3f s\n", secondsSince(start));
+    }
+    return 0;
+}
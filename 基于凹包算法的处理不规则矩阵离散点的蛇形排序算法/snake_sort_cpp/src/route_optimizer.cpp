@@ -0,0 +1,418 @@
+#include "route_optimizer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <deque>
+#include <thread>
+
+namespace {
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+        .count();
+}
+
+// 小于它的改进视为0,避免浮点误差下来回移动
+const double kEpsilon = 1e-9;
+
+}  // namespace
+
+double routeLength(const double* x, const double* y, const std::vector<uint32_t>& order) {
+    double length = 0;
+    for (size_t i = 1; i < order.size(); i++)
+        length += std::hypot(x[order[i]] - x[order[i - 1]], y[order[i]] - y[order[i - 1]]);
+    return length;
+}
+
+struct RouteOptimizer::Worker {
+    std::deque<uint32_t> queue;
+    size_t twoOptMoves = 0;
+    size_t orOptMoves = 0;
+    bool hasDeadline = false;
+    std::chrono::steady_clock::time_point deadline;
+    std::atomic<bool>* timedOut = nullptr;
+};
+
+double RouteOptimizer::distance(uint32_t a, uint32_t b) const {
+    const double dx = x_[a] - x_[b], dy = y_[a] - y_[b];
+    return std::sqrt(dx * dx + dy * dy);
+}
+
+bool RouteOptimizer::run(const double* x, const double* y, size_t n,
+                         const std::vector<uint32_t>& order, const RouteOptions& options) {
+    errorString_.clear();
+    stats_ = RouteStats();
+    tour_.clear();
+    if (n >= UINT32_MAX) {
+        errorString_ = "too many points";
+        return false;
+    }
+    if (order.size() != n) {
+        errorString_ = "order has " + std::to_string(order.size()) + " entries for " +
+                       std::to_string(n) + " points";
+        return false;
+    }
+    x_ = x;
+    y_ = y;
+    n_ = n;
+    options_ = options;
+    if (options_.segmentLength < 8) options_.segmentLength = 8;
+
+    // 初始顺序必须是排列
+    tour_ = order;
+    position_.assign(n, UINT32_MAX);
+    for (size_t i = 0; i < n; i++) {
+        if (tour_[i] >= n || position_[tour_[i]] != UINT32_MAX) {
+            errorString_ = "order is not a permutation";
+            tour_.clear();
+            return false;
+        }
+        position_[tour_[i]] = static_cast<uint32_t>(i);
+    }
+    stats_.initialLength = routeLength(x, y, tour_);
+    stats_.finalLength = stats_.initialLength;
+    if (n < 4) return true;
+
+    int threads = options_.threads;
+    if (threads <= 0) {
+        threads = static_cast<int>(std::thread::hardware_concurrency());
+        if (threads <= 0) threads = 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    buildNeighbours(threads);
+    stats_.neighbourSeconds = secondsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    std::atomic<bool> timedOut(false);
+    const auto deadline =
+        start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                    std::chrono::duration<double>(std::max(options_.timeBudget, 0.0)));
+    segmentOf_.resize(n);
+    active_.assign(n, 0);
+    // 连续两轮(两种分段)都没有改进才算收敛
+    int quietPasses = 0;
+    for (int pass = 0; pass < options_.maxPasses && quietPasses < 2 && !timedOut; pass++) {
+        const size_t length = options_.segmentLength;
+        const size_t offset = pass % 2 ? length / 2 : 0;
+        // 段 [lo, hi] 首尾相接,共用的端点归前一段
+        std::vector<std::pair<size_t, size_t>> segments;
+        size_t lo = 0;
+        size_t hi = std::min(offset > 0 ? offset : length, n - 1);
+        while (lo < n - 1) {
+            segments.push_back({lo, hi});
+            lo = hi;
+            hi = std::min(hi + length, n - 1);
+        }
+        for (uint32_t s = 0; s < segments.size(); s++)
+            for (size_t i = segments[s].first; i <= segments[s].second; i++)
+                segmentOf_[tour_[i]] = s;
+        for (uint32_t s = 0; s < segments.size(); s++)
+            segmentOf_[tour_[segments[s].first]] = s > 0 ? s - 1 : 0;
+
+        std::vector<Worker> workers(std::min<size_t>(threads, segments.size()));
+        for (Worker& w : workers) {
+            w.hasDeadline = options_.timeBudget > 0;
+            w.deadline = deadline;
+            w.timedOut = &timedOut;
+        }
+        std::atomic<size_t> next(0);
+        auto work = [&](Worker* w) {
+            for (size_t s = next++; s < segments.size(); s = next++)
+                optimizeSegment(segments[s].first, segments[s].second,
+                                static_cast<uint32_t>(s), w);
+        };
+        std::vector<std::thread> pool;
+        for (size_t i = 1; i < workers.size(); i++) pool.emplace_back(work, &workers[i]);
+        work(&workers[0]);
+        for (auto& t : pool) t.join();
+
+        size_t moves = 0;
+        for (const Worker& w : workers) {
+            stats_.twoOptMoves += w.twoOptMoves;
+            stats_.orOptMoves += w.orOptMoves;
+            moves += w.twoOptMoves + w.orOptMoves;
+        }
+        stats_.passes++;
+        quietPasses = moves == 0 ? quietPasses + 1 : 0;
+        // 只有一段时错开没有意义
+        if (segments.size() == 1 && moves == 0) break;
+    }
+    stats_.timedOut = timedOut;
+    stats_.optimizeSeconds = secondsSince(start);
+    stats_.finalLength = routeLength(x, y, tour_);
+    return true;
+}
+
+// ---- k近邻 ----
+
+void RouteOptimizer::buildNeighbours(int threads) {
+    double minX = x_[0], maxX = x_[0], minY = y_[0], maxY = y_[0];
+    for (size_t i = 1; i < n_; i++) {
+        minX = std::min(minX, x_[i]);
+        maxX = std::max(maxX, x_[i]);
+        minY = std::min(minY, y_[i]);
+        maxY = std::max(maxY, y_[i]);
+    }
+    const double width = maxX - minX, height = maxY - minY;
+    // 每格约4个点;点集退化成线或重合时按长边或1米分格
+    cellSize_ = std::sqrt(width * height * 4 / n_);
+    if (!(cellSize_ > 0)) cellSize_ = std::max(width, height) * 4 / n_;
+    if (!(cellSize_ > 0)) cellSize_ = 1;
+    while ((width / cellSize_ + 1) * (height / cellSize_ + 1) > 4.0 * n_ + 16) cellSize_ *= 2;
+    gridX_ = minX;
+    gridY_ = minY;
+    gridColumns_ = static_cast<size_t>(width / cellSize_) + 1;
+    gridRows_ = static_cast<size_t>(height / cellSize_) + 1;
+
+    // 计数排序把点按格子归桶
+    std::vector<uint32_t> cellOf(n_);
+    cellStart_.assign(gridColumns_ * gridRows_ + 1, 0);
+    for (size_t i = 0; i < n_; i++) {
+        const size_t cx = std::min(gridColumns_ - 1, static_cast<size_t>((x_[i] - minX) / cellSize_));
+        const size_t cy = std::min(gridRows_ - 1, static_cast<size_t>((y_[i] - minY) / cellSize_));
+        cellOf[i] = static_cast<uint32_t>(cy * gridColumns_ + cx);
+        cellStart_[cellOf[i] + 1]++;
+    }
+    for (size_t c = 0; c + 1 < cellStart_.size(); c++) cellStart_[c + 1] += cellStart_[c];
+    cellPoints_.resize(n_);
+    std::vector<uint32_t> fillPos(cellStart_.begin(), cellStart_.end() - 1);
+    for (size_t i = 0; i < n_; i++) cellPoints_[fillPos[cellOf[i]]++] = static_cast<uint32_t>(i);
+    // 坐标也按格子顺序复制一份,扫描一行格子时是连续读
+    cellX_.resize(n_);
+    cellY_.resize(n_);
+    for (size_t p = 0; p < n_; p++) {
+        cellX_[p] = x_[cellPoints_[p]] - minX;
+        cellY_[p] = y_[cellPoints_[p]] - minY;
+    }
+
+    k_ = static_cast<int>(std::min<size_t>(std::max(options_.neighbours, 1), n_ - 1));
+    neighbours_.assign(n_ * k_, UINT32_MAX);
+    const size_t chunks = std::min<size_t>(threads, n_ / 4096 + 1);
+    std::vector<std::thread> pool;
+    for (size_t t = 1; t < chunks; t++)
+        pool.emplace_back(&RouteOptimizer::neighbourRange, this, n_ * t / chunks,
+                          n_ * (t + 1) / chunks);
+    neighbourRange(0, n_ / chunks);
+    for (auto& t : pool) t.join();
+}
+
+// 从点所在格子向外一圈圈收集候选,第k近的点不比未搜的格子远即可停止
+void RouteOptimizer::neighbourRange(size_t begin, size_t end) {
+    std::vector<std::pair<double, uint32_t>> found;
+    const long columns = static_cast<long>(gridColumns_), rows = static_cast<long>(gridRows_);
+    const long maxRing = std::max(columns, rows);
+    for (size_t p = begin; p < end; p++) {
+        // 按格子顺序处理,相邻的点搜的是同一批格子
+        const uint32_t i = cellPoints_[p];
+        const double px = cellX_[p], py = cellY_[p];
+        const long cx = std::min(columns - 1, static_cast<long>(px / cellSize_));
+        const long cy = std::min(rows - 1, static_cast<long>(py / cellSize_));
+        found.clear();
+        auto scanRow = [&](long gy, long gx0, long gx1) {
+            if (gy < 0 || gy >= rows) return;
+            gx0 = std::max(gx0, 0L);
+            gx1 = std::min(gx1, columns - 1);
+            if (gx0 > gx1) return;
+            // 一行里相邻格子的点在cellPoints中是连续的
+            const size_t row = static_cast<size_t>(gy) * gridColumns_;
+            for (uint32_t q = cellStart_[row + gx0]; q < cellStart_[row + gx1 + 1]; q++) {
+                const double dx = cellX_[q] - px, dy = cellY_[q] - py;
+                if (q != p) found.push_back({dx * dx + dy * dy, q});
+            }
+        };
+        for (long r = 0; r <= maxRing; r++) {
+            if (r == 0) {
+                scanRow(cy, cx, cx);
+            } else {
+                scanRow(cy - r, cx - r, cx + r);
+                scanRow(cy + r, cx - r, cx + r);
+                for (long gy = cy - r + 1; gy <= cy + r - 1; gy++) {
+                    scanRow(gy, cx - r, cx - r);
+                    scanRow(gy, cx + r, cx + r);
+                }
+            }
+            if (static_cast<int>(found.size()) < k_) continue;
+            // 已搜完以(cx, cy)为中心、边长2r+1格的方块,方块外的点至少与点到方块边界一样远
+            const double reach = std::min(std::min(px - (cx - r) * cellSize_,
+                                                   (cx + r + 1) * cellSize_ - px),
+                                          std::min(py - (cy - r) * cellSize_,
+                                                   (cy + r + 1) * cellSize_ - py));
+            const double reach2 = reach * reach;
+            int inside = 0;
+            for (const auto& f : found) inside += f.first <= reach2;
+            if (inside >= k_) break;
+        }
+        const size_t count = std::min(found.size(), static_cast<size_t>(k_));
+        if (found.size() > count)
+            std::nth_element(found.begin(), found.begin() + count, found.end());
+        std::sort(found.begin(), found.begin() + count);
+        for (size_t m = 0; m < count; m++) neighbours_[i * k_ + m] = cellPoints_[found[m].second];
+    }
+}
+
+// ---- 局部改进 ----
+
+void RouteOptimizer::reverse(size_t from, size_t to) {
+    std::reverse(tour_.begin() + from, tour_.begin() + to + 1);
+    for (size_t i = from; i <= to; i++) position_[tour_[i]] = static_cast<uint32_t>(i);
+}
+
+void RouteOptimizer::rotate(size_t first, size_t middle, size_t last) {
+    std::rotate(tour_.begin() + first, tour_.begin() + middle, tour_.begin() + last);
+    for (size_t i = first; i < last; i++) position_[tour_[i]] = static_cast<uint32_t>(i);
+}
+
+void RouteOptimizer::optimizeSegment(size_t lo, size_t hi, uint32_t segment, Worker* worker) {
+    std::deque<uint32_t>& queue = worker->queue;
+    for (size_t i = lo; i <= hi; i++) {
+        const uint32_t p = tour_[i];
+        if (segmentOf_[p] != segment) continue;
+        active_[p] = 1;
+        queue.push_back(p);
+    }
+    size_t steps = 0;
+    while (!queue.empty()) {
+        if (worker->hasDeadline && (++steps & 255) == 0 &&
+            (*worker->timedOut || std::chrono::steady_clock::now() >= worker->deadline)) {
+            *worker->timedOut = true;
+            for (uint32_t p : queue) active_[p] = 0;
+            queue.clear();
+            return;
+        }
+        const uint32_t a = queue.front();
+        queue.pop_front();
+        active_[a] = 0;
+        // 有改进就再查一次a本身,直到它没有改进
+        while (improve(a, lo, hi, segment, worker)) {
+        }
+    }
+}
+
+bool RouteOptimizer::improve(uint32_t a, size_t lo, size_t hi, uint32_t segment,
+                             Worker* worker) {
+    if (twoOpt(a, lo, hi, segment, worker)) {
+        worker->twoOptMoves++;
+        return true;
+    }
+    if (options_.orOptLength > 0 && orOpt(a, lo, hi, segment, worker)) {
+        worker->orOptMoves++;
+        return true;
+    }
+    return false;
+}
+
+// 航线上的边(t[i], t[i+1])与(t[j], t[j+1])换成(t[i], t[j])与(t[i+1], t[j+1]).
+// 新边(a, c)须比a原来的邻边短,否则不可能有改进
+bool RouteOptimizer::twoOpt(uint32_t a, size_t lo, size_t hi, uint32_t segment,
+                            Worker* worker) {
+    const size_t i = position_[a];
+    const uint32_t* candidates = &neighbours_[static_cast<size_t>(a) * k_];
+    auto wake = [&](uint32_t p) {
+        if (segmentOf_[p] == segment && !active_[p]) {
+            active_[p] = 1;
+            worker->queue.push_back(p);
+        }
+    };
+    for (int direction = 0; direction < 2; direction++) {
+        // direction 0: a的后继; 1: a的前驱
+        if (direction == 0 ? i >= hi : i <= lo) continue;
+        const uint32_t b = tour_[direction == 0 ? i + 1 : i - 1];
+        const double ab = distance(a, b);
+        for (int m = 0; m < k_; m++) {
+            const uint32_t c = candidates[m];
+            if (c == UINT32_MAX) break;
+            const double ac = distance(a, c);
+            if (ac >= ab) break;
+            if (segmentOf_[c] != segment || c == b) continue;
+            const size_t j = position_[c];
+            if (j < lo || j > hi) continue;
+            if (direction == 0 ? j >= hi : j <= lo) continue;
+            const uint32_t d = tour_[direction == 0 ? j + 1 : j - 1];
+            if (d == a) continue;
+            const double gain = ab + distance(c, d) - ac - distance(b, d);
+            if (gain <= kEpsilon) continue;
+            if (direction == 0) {
+                if (j > i) reverse(i + 1, j);
+                else reverse(j + 1, i);
+            } else {
+                if (j > i) reverse(i, j - 1);
+                else reverse(j, i - 1);
+            }
+            wake(b);
+            wake(c);
+            wake(d);
+            return true;
+        }
+    }
+    return false;
+}
+
+// 把从a开始(或到a结束)的1~orOptLength个点整体取出,插到近邻c的某条邻边上,可反向
+bool RouteOptimizer::orOpt(uint32_t a, size_t lo, size_t hi, uint32_t segment,
+                           Worker* worker) {
+    const size_t position = position_[a];
+    auto wake = [&](uint32_t p) {
+        if (segmentOf_[p] == segment && !active_[p]) {
+            active_[p] = 1;
+            worker->queue.push_back(p);
+        }
+    };
+    for (int length = 1; length <= options_.orOptLength; length++) {
+        for (int anchor = 0; anchor < (length > 1 ? 2 : 1); anchor++) {
+            // 片段 [i, e]; anchor 0: a在开头, 1: a在结尾
+            if (anchor == 1 && position < static_cast<size_t>(length - 1)) continue;
+            const size_t i = anchor == 0 ? position : position - (length - 1);
+            const size_t e = i + length - 1;
+            if (i <= lo || e >= hi) continue;
+            const uint32_t s0 = tour_[i], se = tour_[e];
+            const uint32_t p = tour_[i - 1], nx = tour_[e + 1];
+            const double removeGain = distance(p, s0) + distance(se, nx) - distance(p, nx);
+            if (removeGain <= kEpsilon) continue;
+            for (int end = 0; end < 2; end++) {
+                const uint32_t from = end == 0 ? s0 : se;
+                const uint32_t* candidates = &neighbours_[static_cast<size_t>(from) * k_];
+                for (int m = 0; m < k_; m++) {
+                    const uint32_t c = candidates[m];
+                    if (c == UINT32_MAX) break;
+                    if (distance(from, c) >= removeGain) break;
+                    if (segmentOf_[c] != segment) continue;
+                    const size_t j = position_[c];
+                    if (j < lo || j > hi || (j >= i && j <= e)) continue;
+                    // c的两条邻边 (t[q], t[q+1]),不能碰到片段本身
+                    for (int side = 0; side < 2; side++) {
+                        if (side == 0 && j == 0) continue;
+                        const size_t q = side == 0 ? j - 1 : j;
+                        if (q < lo || q + 1 > hi || (q + 1 >= i && q <= e)) continue;
+                        const uint32_t u = tour_[q], v = tour_[q + 1];
+                        const double uv = distance(u, v);
+                        const double keep = distance(u, s0) + distance(se, v) - uv;
+                        const double flip = distance(u, se) + distance(s0, v) - uv;
+                        const bool reversed = flip < keep;
+                        const double gain = removeGain - std::min(keep, flip);
+                        if (gain <= kEpsilon) continue;
+                        size_t placed;
+                        if (q > e) {
+                            rotate(i, e + 1, q + 1);
+                            placed = q + 1 - length;
+                        } else {
+                            rotate(q + 1, i, e + 1);
+                            placed = q + 1;
+                        }
+                        if (reversed) reverse(placed, placed + length - 1);
+                        wake(p);
+                        wake(nx);
+                        wake(u);
+                        wake(v);
+                        wake(s0);
+                        wake(se);
+                        return true;
+                    }
+                }
+            }
+        }
+    }
+    return false;
+}
@@ -0,0 +1,276 @@
+#include "snake_order.h"
+
+#include "waypoint_csv.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <utility>
+
+namespace {
+
+const double kPi = 3.14159265358979323846;
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+        .count();
+}
+
+// 网格方向集中度低于该值(随机点集)时不做修正
+const double kMinGridConcentration = 0.5;
+
+}  // namespace
+
+double rotationFromHeading(const double* heading, size_t n) {
+    double c = 0, s = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (!std::isfinite(heading[i])) continue;
+        const double h = heading[i] * kPi / 180;
+        c += std::cos(2 * h);
+        s += std::sin(2 * h);
+    }
+    const double h = std::atan2(s, c) / 2;
+    // 航向自北顺时针,换成自东逆时针
+    return kPi / 2 - h;
+}
+
+double rotationFromPca(const double* x, const double* y, size_t n) {
+    if (n == 0) return 0;
+    double mx = 0, my = 0;
+    for (size_t i = 0; i < n; i++) {
+        mx += x[i];
+        my += y[i];
+    }
+    mx /= n;
+    my /= n;
+    double sxx = 0, syy = 0, sxy = 0;
+    for (size_t i = 0; i < n; i++) {
+        const double dx = x[i] - mx, dy = y[i] - my;
+        sxx += dx * dx;
+        syy += dy * dy;
+        sxy += dx * dy;
+    }
+    return std::atan2(2 * sxy, sxx - syy) / 2;
+}
+
+double rotationFromHull(const double* x, const double* y,
+                        const std::vector<int32_t>& boundary) {
+    if (boundary.size() < 3) return 0;
+    // 以第一个点为原点求凸包(单调链),外接矩形的一条边必与凸包的某条边重合
+    const double ox = x[boundary[0]], oy = y[boundary[0]];
+    std::vector<std::pair<double, double>> p(boundary.size());
+    for (size_t i = 0; i < boundary.size(); i++)
+        p[i] = {x[boundary[i]] - ox, y[boundary[i]] - oy};
+    std::sort(p.begin(), p.end());
+    auto cross = [](const std::pair<double, double>& o, const std::pair<double, double>& a,
+                    const std::pair<double, double>& b) {
+        return (a.first - o.first) * (b.second - o.second) -
+               (a.second - o.second) * (b.first - o.first);
+    };
+    std::vector<std::pair<double, double>> h(2 * p.size());
+    size_t m = 0;
+    for (size_t i = 0; i < p.size(); i++) {
+        while (m >= 2 && cross(h[m - 2], h[m - 1], p[i]) <= 0) --m;
+        h[m++] = p[i];
+    }
+    for (size_t i = p.size() - 1, lower = m + 1; i-- > 0;) {
+        while (m >= lower && cross(h[m - 2], h[m - 1], p[i]) <= 0) --m;
+        h[m++] = p[i];
+    }
+    --m;  // 首点在末尾重复了一次
+    if (m < 3) return 0;
+
+    // 旋转卡壳: 对每条边u,k为沿u最远点,j为离边最远点,l为沿u最近点;三者都只前进
+    auto next = [m](size_t i) { return (i + 1) % m; };
+    size_t k = 1, j = 1, l = 1;
+    double bestArea = INFINITY, best = 0;
+    for (size_t i = 0; i < m; i++) {
+        const double dx = h[next(i)].first - h[i].first;
+        const double dy = h[next(i)].second - h[i].second;
+        const double len = std::hypot(dx, dy);
+        if (!(len > 0)) continue;
+        const double ux = dx / len, uy = dy / len;
+        auto along = [&](size_t a) { return h[a].first * ux + h[a].second * uy; };
+        auto away = [&](size_t a) { return h[a].second * ux - h[a].first * uy; };
+        while (along(next(k)) > along(k)) k = next(k);
+        if (i == 0) j = k;
+        while (away(next(j)) > away(j)) j = next(j);
+        if (i == 0) l = j;
+        while (along(next(l)) < along(l)) l = next(l);
+        const double width = along(k) - along(l);
+        const double height = away(j) - away(i);
+        if (width * height < bestArea) {
+            bestArea = width * height;
+            best = std::atan2(uy, ux);
+            if (height > width) best += kPi / 2;
+        }
+    }
+    return std::remainder(best, kPi);
+}
+
+bool SnakeSorter::run(const WaypointCloud& cloud, const SnakeOptions& options) {
+    return run(cloud.waypointUtmX.data(), cloud.waypointUtmY.data(), cloud.size(),
+               cloud.avgHeading.data(), options);
+}
+
+bool SnakeSorter::run(const double* x, const double* y, size_t n,
+                      const double* heading, const SnakeOptions& options) {
+    order_.clear();
+    rowStart_.clear();
+    errorString_.clear();
+    timings_ = SnakeTimings();
+    if (n > UINT32_MAX) {
+        errorString_ = "too many points";
+        return false;
+    }
+
+    // ---- 剖分与凹包 ----
+    auto start = std::chrono::steady_clock::now();
+    if (!delaunay_.build(x, y, n)) {
+        errorString_ = delaunay_.errorString();
+        return false;
+    }
+    timings_.triangulation = secondsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    if (!hull_.build(delaunay_, x, y, options.alpha, options.alphaFactor)) {
+        errorString_ = hull_.errorString();
+        return false;
+    }
+    timings_.hull = secondsSince(start);
+
+    // ---- 旋转角 ----
+    start = std::chrono::steady_clock::now();
+    RotationSource source = options.rotation;
+    if (source == RotationSource::Auto && hull_.boundary().size() < 3)
+        source = heading ? RotationSource::Heading : RotationSource::Pca;
+    switch (source) {
+        case RotationSource::Auto:
+            // 凹包给出网格的准确角度(模90度),航向只用来选外接矩形的哪条边、朝哪头
+            rotation_ = rotationFromHull(x, y, hull_.boundary());
+            if (heading) {
+                const double h = rotationFromHeading(heading, n);
+                rotation_ = h + std::remainder(rotation_ - h, kPi / 2);
+            }
+            break;
+        case RotationSource::Heading:
+            rotation_ = heading ? rotationFromHeading(heading, n) : 0;
+            break;
+        case RotationSource::Pca:
+            rotation_ = rotationFromPca(x, y, n);
+            break;
+        case RotationSource::Hull:
+            rotation_ = rotationFromHull(x, y, hull_.boundary());
+            break;
+        default:
+            rotation_ = 0;
+            break;
+    }
+
+    std::vector<float> nnLength, nnAngle;
+    nearestNeighbours(x, y, &nnLength, &nnAngle);
+    if (options.refineRotation && source != RotationSource::None) {
+        // 规则网格的最近邻边沿行或列,四倍角平均得到模90度的网格方向,
+        // 取与初始角度最接近的那个
+        double c = 0, s = 0;
+        size_t count = 0;
+        for (size_t i = 0; i < n; i++) {
+            if (!(nnLength[i] > 0)) continue;
+            c += std::cos(4.0 * nnAngle[i]);
+            s += std::sin(4.0 * nnAngle[i]);
+            ++count;
+        }
+        if (count > 0 && std::hypot(c, s) / count > kMinGridConcentration) {
+            const double grid = std::atan2(s, c) / 4;
+            rotation_ += std::remainder(grid - rotation_, kPi / 2);
+        }
+    }
+    timings_.rotation = secondsSince(start);
+
+    // ---- 分行与蛇形 ----
+    start = std::chrono::steady_clock::now();
+    rowTolerance_ = options.rowTolerance;
+    if (rowTolerance_ <= 0) {
+        std::vector<float> positive;
+        positive.reserve(n);
+        for (float d : nnLength)
+            if (d > 0) positive.push_back(d);
+        if (!positive.empty()) {
+            auto mid = positive.begin() + positive.size() / 2;
+            std::nth_element(positive.begin(), mid, positive.end());
+            rowTolerance_ = 0.5 * *mid;
+        }
+    }
+
+    // 绕第一个点旋转,保持UTM坐标的精度
+    const double cosR = std::cos(rotation_), sinR = std::sin(rotation_);
+    const double ox = n ? x[0] : 0, oy = n ? y[0] : 0;
+    std::vector<std::pair<double, uint32_t>> byY(n);
+    std::vector<double> rx(n);
+    for (size_t i = 0; i < n; i++) {
+        const double dx = x[i] - ox, dy = y[i] - oy;
+        rx[i] = dx * cosR + dy * sinR;
+        byY[i] = {-dx * sinR + dy * cosR, static_cast<uint32_t>(i)};
+    }
+    std::sort(byY.begin(), byY.end());
+
+    order_.resize(n);
+    std::vector<std::pair<double, uint32_t>> row;
+    size_t begin = 0;
+    while (begin < n) {
+        size_t end = begin + 1;
+        while (end < n && byY[end].first - byY[end - 1].first <= rowTolerance_) ++end;
+        row.clear();
+        for (size_t i = begin; i < end; i++) row.push_back({rx[byY[i].second], byY[i].second});
+        // 偶数行沿X'正向,奇数行反向
+        if (rowStart_.size() % 2 == 0) {
+            std::sort(row.begin(), row.end());
+        } else {
+            std::sort(row.begin(), row.end(),
+                      [](const std::pair<double, uint32_t>& a,
+                         const std::pair<double, uint32_t>& b) { return b < a; });
+        }
+        rowStart_.push_back(static_cast<uint32_t>(begin));
+        for (size_t i = 0; i < row.size(); i++) order_[begin + i] = row[i].second;
+        begin = end;
+    }
+    rowStart_.push_back(static_cast<uint32_t>(n));
+    timings_.rows = secondsSince(start);
+    return true;
+}
+
+// 每个点在Delaunay剖分中最短的邻边(最近邻必为Delaunay邻点);
+// 重合点与没有实三角形的点长度为0
+void SnakeSorter::nearestNeighbours(const double* x, const double* y,
+                                    std::vector<float>* length,
+                                    std::vector<float>* angle) const {
+    const size_t n = delaunay_.duplicateOf().size();
+    length->assign(n, 0);
+    angle->assign(n, 0);
+    if (n == 0) return;
+    // 先比较平方长度并记下邻点,最后每个点只算一次开方与角度
+    std::vector<double> best(n, INFINITY);
+    std::vector<int32_t> nearest(n, -1);
+    for (const Delaunay::Triangle& t : delaunay_.triangles()) {
+        if (!delaunay_.isReal(t)) continue;
+        for (int k = 0; k < 3; k++) {
+            const int32_t a = t.vertex[k], b = t.vertex[(k + 1) % 3];
+            const double dx = x[b] - x[a], dy = y[b] - y[a];
+            const double d2 = dx * dx + dy * dy;
+            if (d2 < best[a]) {
+                best[a] = d2;
+                nearest[a] = b;
+            }
+            if (d2 < best[b]) {
+                best[b] = d2;
+                nearest[b] = a;
+            }
+        }
+    }
+    for (size_t i = 0; i < n; i++) {
+        if (nearest[i] < 0) continue;
+        const double dx = x[nearest[i]] - x[i], dy = y[nearest[i]] - y[i];
+        (*length)[i] = static_cast<float>(std::sqrt(best[i]));
+        (*angle)[i] = static_cast<float>(std::atan2(dy, dx));
+    }
+}
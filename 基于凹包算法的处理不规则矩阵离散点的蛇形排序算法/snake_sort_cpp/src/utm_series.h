@@ -0,0 +1,52 @@
+#ifndef UTM_SERIES_H
+#define UTM_SERIES_H
+
+// UtmTransform内部: WGS84的Krüger级数系数与各实现的内核
+//
+// 正算: 纬度 -> 共形纬度 τ' -> 球面横轴墨卡托 ζ' = ξ' + iη'
+//       -> ζ = ζ' + Σ α_j sin(2jζ')
+// 反算: ζ' = ζ - Σ β_j sin(2jζ) -> τ' -> 牛顿迭代求 τ = tan(纬度)
+// 复数级数用Clenshaw求和,只需 sin/cos(2ξ) 与 exp(2η) 各一次.
+
+#include <cstddef>
+
+namespace utm {
+
+const int kOrder = 6;
+const double kScale = 0.9996;             // 中央经线比例因子 k0
+const double kFalseEasting = 500000.0;
+const double kSouthFalseNorthing = 10000000.0;
+// 反算牛顿迭代次数;从 τ'/(1-e²) 出发两次即收敛到双精度
+const int kNewtonIterations = 2;
+
+struct Series {
+    double e;              // 第一偏心率
+    double e2m;            // 1 - e²
+    double scaledA;        // k0 × 子午线弧长的归一化半径 A
+    double alpha[kOrder];  // 正算系数 α1..α6
+    double beta[kOrder];   // 反算系数 -β1..-β6(已取负)
+};
+
+const Series& wgs84Series();
+
+// 逐点实现(也处理向量路径剩下的尾部)
+void forwardScalar(const Series& s, double lon0, double falseNorthing,
+                   const double* lon, const double* lat, double* easting,
+                   double* northing, size_t n);
+void inverseScalar(const Series& s, double lon0, double falseNorthing,
+                   const double* easting, const double* northing, double* lon,
+                   double* lat, size_t n);
+
+#ifdef SNAKE_SORT_HAVE_LIBMVEC
+// AVX2 + libmvec,每次4个点;返回已处理的点数(4的倍数)
+size_t forwardAvx2(const Series& s, double lon0, double falseNorthing,
+                   const double* lon, const double* lat, double* easting,
+                   double* northing, size_t n);
+size_t inverseAvx2(const Series& s, double lon0, double falseNorthing,
+                   const double* easting, const double* northing, double* lon,
+                   double* lat, size_t n);
+#endif
+
+}  // namespace utm
+
+#endif
@@ -0,0 +1,211 @@
+#include "utm_transform.h"
+
+#include "utm_series.h"
+#include "waypoint_csv.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace utm {
+
+namespace {
+
+const double kDegree = 3.14159265358979323846 / 180;
+
+Series makeWgs84Series() {
+    const double a = 6378137.0;
+    const double f = 1 / 298.257223563;
+    const double n = f / (2 - f);
+    const double n2 = n * n, n3 = n2 * n, n4 = n3 * n, n5 = n4 * n, n6 = n5 * n;
+
+    Series s;
+    s.e = std::sqrt(f * (2 - f));
+    s.e2m = (1 - f) * (1 - f);
+    s.scaledA = kScale * a / (1 + n) * (1 + n2 / 4 + n4 / 64 + n6 / 256);
+
+    s.alpha[0] = n / 2 - 2 * n2 / 3 + 5 * n3 / 16 + 41 * n4 / 180 - 127 * n5 / 288 +
+                 7891 * n6 / 37800;
+    s.alpha[1] = 13 * n2 / 48 - 3 * n3 / 5 + 557 * n4 / 1440 + 281 * n5 / 630 -
+                 1983433 * n6 / 1935360;
+    s.alpha[2] = 61 * n3 / 240 - 103 * n4 / 140 + 15061 * n5 / 26880 +
+                 167603 * n6 / 181440;
+    s.alpha[3] = 49561 * n4 / 161280 - 179 * n5 / 168 + 6601661 * n6 / 7257600;
+    s.alpha[4] = 34729 * n5 / 80640 - 3418889 * n6 / 1995840;
+    s.alpha[5] = 212378941 * n6 / 319334400;
+
+    // 反算系数取负,与正算共用同一个求和
+    s.beta[0] = -(n / 2 - 2 * n2 / 3 + 37 * n3 / 96 - n4 / 360 - 81 * n5 / 512 +
+                  96199 * n6 / 604800);
+    s.beta[1] = -(n2 / 48 + n3 / 15 - 437 * n4 / 1440 + 46 * n5 / 105 -
+                  1118711 * n6 / 3870720);
+    s.beta[2] = -(17 * n3 / 480 - 37 * n4 / 840 - 209 * n5 / 4480 + 5569 * n6 / 90720);
+    s.beta[3] = -(4397 * n4 / 161280 - 11 * n5 / 504 - 830251 * n6 / 7257600);
+    s.beta[4] = -(4583 * n5 / 161280 - 108847 * n6 / 3991680);
+    s.beta[5] = -(20648693 * n6 / 638668800);
+    return s;
+}
+
+// ζ + Σ c_j sin(2jζ),ζ = xi + i·eta
+inline void clenshaw(const double* c, double xi, double eta, double* outXi,
+                     double* outEta) {
+    const double s2 = std::sin(2 * xi), c2 = std::cos(2 * xi);
+    const double ex = std::exp(2 * eta);
+    const double sh2 = (ex - 1 / ex) / 2, ch2 = (ex + 1 / ex) / 2;
+    // 2cos(2ζ)
+    const double ar = 2 * c2 * ch2, ai = -2 * s2 * sh2;
+    double y1r = 0, y1i = 0, y2r = 0, y2i = 0;
+    for (int j = kOrder - 1; j >= 0; j--) {
+        const double yr = c[j] + ar * y1r - ai * y1i - y2r;
+        const double yi = ar * y1i + ai * y1r - y2i;
+        y2r = y1r;
+        y2i = y1i;
+        y1r = yr;
+        y1i = yi;
+    }
+    // sin(2ζ) × y1
+    const double sr = s2 * ch2, si = c2 * sh2;
+    *outXi = xi + (sr * y1r - si * y1i);
+    *outEta = eta + (sr * y1i + si * y1r);
+}
+
+}  // namespace
+
+const Series& wgs84Series() {
+    static const Series series = makeWgs84Series();
+    return series;
+}
+
+void forwardScalar(const Series& s, double lon0, double falseNorthing,
+                   const double* lon, const double* lat, double* easting,
+                   double* northing, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        const double phi = lat[i] * kDegree;
+        const double lam = (lon[i] - lon0) * kDegree;
+        const double sphi = std::sin(phi), cphi = std::cos(phi);
+        // 共形纬度的正切 τ'
+        const double sig = std::sinh(s.e * std::atanh(s.e * sphi));
+        const double taup = (sphi * std::sqrt(1 + sig * sig) - sig) / cphi;
+        const double slam = std::sin(lam), clam = std::cos(lam);
+        const double xip = std::atan2(taup, clam);
+        const double etap = std::asinh(slam / std::sqrt(taup * taup + clam * clam));
+        double xi, eta;
+        clenshaw(s.alpha, xip, etap, &xi, &eta);
+        easting[i] = s.scaledA * eta + kFalseEasting;
+        northing[i] = s.scaledA * xi + falseNorthing;
+    }
+}
+
+void inverseScalar(const Series& s, double lon0, double falseNorthing,
+                   const double* easting, const double* northing, double* lon,
+                   double* lat, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        const double xi = (northing[i] - falseNorthing) / s.scaledA;
+        const double eta = (easting[i] - kFalseEasting) / s.scaledA;
+        double xip, etap;
+        clenshaw(s.beta, xi, eta, &xip, &etap);
+        const double sxip = std::sin(xip), cxip = std::cos(xip);
+        const double shetap = std::sinh(etap);
+        const double taup = sxip / std::sqrt(shetap * shetap + cxip * cxip);
+        const double lam = std::atan2(shetap, cxip);
+        double tau = taup / s.e2m;
+        for (int k = 0; k < kNewtonIterations; k++) {
+            const double t1 = std::sqrt(1 + tau * tau);
+            const double sig = std::sinh(s.e * std::atanh(s.e * tau / t1));
+            const double taupa = tau * std::sqrt(1 + sig * sig) - sig * t1;
+            tau += (taup - taupa) * (1 + s.e2m * tau * tau) /
+                   (s.e2m * t1 * std::sqrt(1 + taupa * taupa));
+        }
+        lat[i] = std::atan(tau) / kDegree;
+        lon[i] = lon0 + lam / kDegree;
+    }
+}
+
+}  // namespace utm
+
+UtmZone utmZoneFor(double lon, double lat) {
+    UtmZone zone;
+    zone.number = static_cast<int>(std::floor((lon + 180) / 6)) + 1;
+    zone.number = std::min(60, std::max(1, zone.number));
+    zone.north = lat >= 0;
+    return zone;
+}
+
+UtmTransform::UtmTransform(UtmZone zone)
+    : zone_(zone),
+      centralMeridian_(6.0 * zone.number - 183),
+      falseNorthing_(zone.north ? 0 : utm::kSouthFalseNorthing) {}
+
+bool UtmTransform::vectorized() {
+#ifdef SNAKE_SORT_HAVE_LIBMVEC
+    static const bool supported =
+        __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    return supported;
+#else
+    return false;
+#endif
+}
+
+void UtmTransform::forward(const double* lon, const double* lat, double* easting,
+                           double* northing, size_t n) const {
+    const utm::Series& s = utm::wgs84Series();
+    size_t done = 0;
+#ifdef SNAKE_SORT_HAVE_LIBMVEC
+    if (vectorized())
+        done = utm::forwardAvx2(s, centralMeridian_, falseNorthing_, lon, lat,
+                                easting, northing, n);
+#endif
+    utm::forwardScalar(s, centralMeridian_, falseNorthing_, lon + done, lat + done,
+                       easting + done, northing + done, n - done);
+}
+
+void UtmTransform::inverse(const double* easting, const double* northing, double* lon,
+                           double* lat, size_t n) const {
+    const utm::Series& s = utm::wgs84Series();
+    size_t done = 0;
+#ifdef SNAKE_SORT_HAVE_LIBMVEC
+    if (vectorized())
+        done = utm::inverseAvx2(s, centralMeridian_, falseNorthing_, easting,
+                                northing, lon, lat, n);
+#endif
+    utm::inverseScalar(s, centralMeridian_, falseNorthing_, easting + done,
+                       northing + done, lon + done, lat + done, n - done);
+}
+
+UtmConsistency checkUtmConsistency(const WaypointCloud& cloud, double tolerance) {
+    UtmConsistency result;
+    const size_t n = cloud.size();
+    if (n == 0) return result;
+    double lonSum = 0, latSum = 0;
+    for (size_t i = 0; i < n; i++) {
+        lonSum += cloud.waypointLon[i];
+        latSum += cloud.waypointLat[i];
+    }
+    result.zone = utmZoneFor(lonSum / n, latSum / n);
+    const UtmTransform transform(result.zone);
+
+    // 分块换算,临时数组留在缓存里
+    const size_t kBlock = 4096;
+    std::vector<double> east(kBlock), north(kBlock);
+    auto compare = [&](const std::vector<double>& lon, const std::vector<double>& lat,
+                       const std::vector<double>& x, const std::vector<double>& y) {
+        for (size_t begin = 0; begin < n; begin += kBlock) {
+            const size_t count = std::min(kBlock, n - begin);
+            transform.forward(lon.data() + begin, lat.data() + begin, east.data(),
+                              north.data(), count);
+            for (size_t i = 0; i < count; i++) {
+                const double error =
+                    std::hypot(east[i] - x[begin + i], north[i] - y[begin + i]);
+                if (!(error <= tolerance)) ++result.outliers;
+                if (error > result.maxError || std::isnan(error)) {
+                    result.maxError = std::isnan(error) ? INFINITY : error;
+                    result.worstRow = begin + i;
+                }
+            }
+        }
+    };
+    compare(cloud.waypointLon, cloud.waypointLat, cloud.waypointUtmX,
+            cloud.waypointUtmY);
+    compare(cloud.targetLon, cloud.targetLat, cloud.targetUtmX, cloud.targetUtmY);
+    return result;
+}
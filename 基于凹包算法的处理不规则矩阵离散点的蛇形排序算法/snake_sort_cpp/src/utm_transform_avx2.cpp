@@ -0,0 +1,139 @@
+// UtmTransform的AVX2内核,本文件以 -mavx2 -mfma 编译,只在运行时检测到AVX2后调用.
+// 超越函数使用glibc libmvec的4路双精度版本(向量函数ABI名,误差不超过4ulp).
+
+#include "utm_series.h"
+
+#include <immintrin.h>
+
+extern "C" {
+__m256d _ZGVdN4v_sin(__m256d);
+__m256d _ZGVdN4v_cos(__m256d);
+__m256d _ZGVdN4v_exp(__m256d);
+__m256d _ZGVdN4v_sinh(__m256d);
+__m256d _ZGVdN4v_asinh(__m256d);
+__m256d _ZGVdN4v_atanh(__m256d);
+__m256d _ZGVdN4v_atan(__m256d);
+__m256d _ZGVdN4vv_atan2(__m256d, __m256d);
+}
+
+namespace utm {
+
+namespace {
+
+const double kDegree = 3.14159265358979323846 / 180;
+
+inline __m256d square(__m256d x) { return _mm256_mul_pd(x, x); }
+
+// sqrt(1 + x²)
+inline __m256d hypot1(__m256d x) {
+    return _mm256_sqrt_pd(_mm256_fmadd_pd(x, x, _mm256_set1_pd(1)));
+}
+
+// 与标量版 clenshaw 相同: ζ + Σ c_j sin(2jζ)
+inline void clenshaw(const double* c, __m256d xi, __m256d eta, __m256d* outXi,
+                     __m256d* outEta) {
+    const __m256d two = _mm256_set1_pd(2), half = _mm256_set1_pd(0.5);
+    const __m256d xi2 = _mm256_mul_pd(two, xi);
+    const __m256d s2 = _ZGVdN4v_sin(xi2), c2 = _ZGVdN4v_cos(xi2);
+    const __m256d ex = _ZGVdN4v_exp(_mm256_mul_pd(two, eta));
+    const __m256d inv = _mm256_div_pd(_mm256_set1_pd(1), ex);
+    const __m256d sh2 = _mm256_mul_pd(half, _mm256_sub_pd(ex, inv));
+    const __m256d ch2 = _mm256_mul_pd(half, _mm256_add_pd(ex, inv));
+    const __m256d ar = _mm256_mul_pd(two, _mm256_mul_pd(c2, ch2));
+    const __m256d ai = _mm256_mul_pd(_mm256_set1_pd(-2), _mm256_mul_pd(s2, sh2));
+
+    __m256d y1r = _mm256_setzero_pd(), y1i = _mm256_setzero_pd();
+    __m256d y2r = _mm256_setzero_pd(), y2i = _mm256_setzero_pd();
+    for (int j = kOrder - 1; j >= 0; j--) {
+        // yr = c_j + ar*y1r - ai*y1i - y2r;  yi = ar*y1i + ai*y1r - y2i
+        const __m256d yr = _mm256_sub_pd(
+            _mm256_fmsub_pd(ar, y1r, _mm256_fmsub_pd(ai, y1i, _mm256_set1_pd(c[j]))),
+            y2r);
+        const __m256d yi = _mm256_sub_pd(_mm256_fmadd_pd(ar, y1i, _mm256_mul_pd(ai, y1r)),
+                                         y2i);
+        y2r = y1r;
+        y2i = y1i;
+        y1r = yr;
+        y1i = yi;
+    }
+    const __m256d sr = _mm256_mul_pd(s2, ch2), si = _mm256_mul_pd(c2, sh2);
+    *outXi = _mm256_add_pd(xi, _mm256_fmsub_pd(sr, y1r, _mm256_mul_pd(si, y1i)));
+    *outEta = _mm256_add_pd(eta, _mm256_fmadd_pd(sr, y1i, _mm256_mul_pd(si, y1r)));
+}
+
+}  // namespace
+
+size_t forwardAvx2(const Series& s, double lon0, double falseNorthing,
+                   const double* lon, const double* lat, double* easting,
+                   double* northing, size_t n) {
+    const __m256d degree = _mm256_set1_pd(kDegree);
+    const __m256d e = _mm256_set1_pd(s.e);
+    const __m256d vlon0 = _mm256_set1_pd(lon0);
+    const __m256d scaledA = _mm256_set1_pd(s.scaledA);
+    const __m256d fe = _mm256_set1_pd(kFalseEasting);
+    const __m256d fn = _mm256_set1_pd(falseNorthing);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const __m256d phi = _mm256_mul_pd(_mm256_loadu_pd(lat + i), degree);
+        const __m256d lam =
+            _mm256_mul_pd(_mm256_sub_pd(_mm256_loadu_pd(lon + i), vlon0), degree);
+        const __m256d sphi = _ZGVdN4v_sin(phi), cphi = _ZGVdN4v_cos(phi);
+        const __m256d sig =
+            _ZGVdN4v_sinh(_mm256_mul_pd(e, _ZGVdN4v_atanh(_mm256_mul_pd(e, sphi))));
+        const __m256d taup =
+            _mm256_div_pd(_mm256_fmsub_pd(sphi, hypot1(sig), sig), cphi);
+        const __m256d slam = _ZGVdN4v_sin(lam), clam = _ZGVdN4v_cos(lam);
+        const __m256d xip = _ZGVdN4vv_atan2(taup, clam);
+        const __m256d etap = _ZGVdN4v_asinh(_mm256_div_pd(
+            slam, _mm256_sqrt_pd(_mm256_fmadd_pd(taup, taup, square(clam)))));
+        __m256d xi, eta;
+        clenshaw(s.alpha, xip, etap, &xi, &eta);
+        _mm256_storeu_pd(easting + i, _mm256_fmadd_pd(scaledA, eta, fe));
+        _mm256_storeu_pd(northing + i, _mm256_fmadd_pd(scaledA, xi, fn));
+    }
+    return i;
+}
+
+size_t inverseAvx2(const Series& s, double lon0, double falseNorthing,
+                   const double* easting, const double* northing, double* lon,
+                   double* lat, size_t n) {
+    const __m256d invDegree = _mm256_set1_pd(1 / kDegree);
+    const __m256d one = _mm256_set1_pd(1);
+    const __m256d e = _mm256_set1_pd(s.e);
+    const __m256d e2m = _mm256_set1_pd(s.e2m);
+    const __m256d vlon0 = _mm256_set1_pd(lon0);
+    const __m256d invA = _mm256_set1_pd(1 / s.scaledA);
+    const __m256d fe = _mm256_set1_pd(kFalseEasting);
+    const __m256d fn = _mm256_set1_pd(falseNorthing);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const __m256d xi = _mm256_mul_pd(_mm256_sub_pd(_mm256_loadu_pd(northing + i), fn),
+                                         invA);
+        const __m256d eta = _mm256_mul_pd(_mm256_sub_pd(_mm256_loadu_pd(easting + i), fe),
+                                          invA);
+        __m256d xip, etap;
+        clenshaw(s.beta, xi, eta, &xip, &etap);
+        const __m256d sxip = _ZGVdN4v_sin(xip), cxip = _ZGVdN4v_cos(xip);
+        const __m256d shetap = _ZGVdN4v_sinh(etap);
+        const __m256d taup = _mm256_div_pd(
+            sxip, _mm256_sqrt_pd(_mm256_fmadd_pd(shetap, shetap, square(cxip))));
+        const __m256d lam = _ZGVdN4vv_atan2(shetap, cxip);
+
+        __m256d tau = _mm256_div_pd(taup, e2m);
+        for (int k = 0; k < kNewtonIterations; k++) {
+            const __m256d t1 = hypot1(tau);
+            const __m256d sig = _ZGVdN4v_sinh(
+                _mm256_mul_pd(e, _ZGVdN4v_atanh(_mm256_div_pd(_mm256_mul_pd(e, tau), t1))));
+            const __m256d taupa = _mm256_fmsub_pd(tau, hypot1(sig), _mm256_mul_pd(sig, t1));
+            const __m256d num = _mm256_mul_pd(_mm256_sub_pd(taup, taupa),
+                                              _mm256_fmadd_pd(e2m, square(tau), one));
+            const __m256d den = _mm256_mul_pd(_mm256_mul_pd(e2m, t1), hypot1(taupa));
+            tau = _mm256_add_pd(tau, _mm256_div_pd(num, den));
+        }
+        _mm256_storeu_pd(lat + i, _mm256_mul_pd(_ZGVdN4v_atan(tau), invDegree));
+        _mm256_storeu_pd(lon + i, _mm256_fmadd_pd(lam, invDegree, vlon0));
+    }
+    return i;
+}
+
+}  // namespace utm
@@ -0,0 +1,398 @@
+#include "waypoint_csv.h"
+
+#include <cerrno>
+#include <cfloat>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// ---- MappedFile ----
+
+MappedFile::~MappedFile() {
+    if (data_ && size_ > 0) munmap(const_cast<char*>(data_), size_);
+    if (fd_ >= 0) close(fd_);
+}
+
+bool MappedFile::open(const std::string& path, std::string* error) {
+    fd_ = ::open(path.c_str(), O_RDONLY);
+    if (fd_ < 0) {
+        *error = path + ": " + std::strerror(errno);
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd_, &st) != 0) {
+        *error = path + ": " + std::strerror(errno);
+        return false;
+    }
+    size_ = static_cast<size_t>(st.st_size);
+    if (size_ == 0) {
+        data_ = "";
+        return true;
+    }
+    void* p = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+    if (p == MAP_FAILED) {
+        *error = path + ": mmap failed: " + std::strerror(errno);
+        size_ = 0;
+        return false;
+    }
+    // 顺序读取,让内核提前预读
+    madvise(p, size_, MADV_SEQUENTIAL | MADV_WILLNEED);
+    data_ = static_cast<const char*>(p);
+    return true;
+}
+
+namespace {
+
+// 浮点列下标 -> 成员指针
+std::vector<double> WaypointCloud::* const kDoubleColumns[] = {
+    &WaypointCloud::waypointUtmX, &WaypointCloud::waypointUtmY,
+    &WaypointCloud::waypointUtmZ, &WaypointCloud::targetUtmX,
+    &WaypointCloud::targetUtmY,   &WaypointCloud::targetUtmZ,
+    &WaypointCloud::waypointLon,  &WaypointCloud::waypointLat,
+    &WaypointCloud::waypointZ,    &WaypointCloud::targetLon,
+    &WaypointCloud::targetLat,    &WaypointCloud::targetZ,
+    &WaypointCloud::avgHeading,   &WaypointCloud::avgPitch,
+};
+
+// [begin, end)中下一行的结束位置(不含换行符)
+inline const char* lineEnd(const char* begin, const char* end) {
+    const void* nl = std::memchr(begin, '\n', static_cast<size_t>(end - begin));
+    return nl ? static_cast<const char*>(nl) : end;
+}
+
+// 去掉行尾的'\r'
+inline const char* trimCr(const char* begin, const char* end) {
+    return (end > begin && end[-1] == '\r') ? end - 1 : end;
+}
+
+// 统计[begin, end)中非空行数与总行数
+void countLines(const char* begin, const char* end, size_t* rows,
+                size_t* lines) {
+    size_t r = 0, l = 0;
+    const char* p = begin;
+    while (p < end) {
+        const char* e = lineEnd(p, end);
+        if (trimCr(p, e) > p) ++r;
+        ++l;
+        p = e + 1;
+    }
+    *rows = r;
+    *lines = l;
+}
+
+// ---- 浮点数解析 ----
+// 坐标带20位小数,有效数字超过19位时libstdc++的from_chars走慢路径.
+// 这里先取前19位有效数字m与十进制指数e:
+//   没有截断且 m <= 2^53、|e| <= 22 时,double(m) 乘除 10^|e| 只有一次舍入,结果精确;
+//   否则(x86上long double有64位尾数)用long double计算 m*10^e 与 (m+1)*10^e,
+//   两者舍入到同一个double、且都不靠近两个double的中点时结果同样精确;
+//   其余情况交给from_chars.
+
+const double kExactPow10[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                              1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+                              1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+#if LDBL_MANT_DIG == 64
+// 10^27 = 2^27 * 5^27, 5^27 < 2^64, 在64位尾数内都是精确值
+const long double kExactPow10L[] = {
+    1e0L,  1e1L,  1e2L,  1e3L,  1e4L,  1e5L,  1e6L,  1e7L,  1e8L,  1e9L,
+    1e10L, 1e11L, 1e12L, 1e13L, 1e14L, 1e15L, 1e16L, 1e17L, 1e18L, 1e19L,
+    1e20L, 1e21L, 1e22L, 1e23L, 1e24L, 1e25L, 1e26L, 1e27L};
+
+inline long double scaleL(unsigned long long m, int e) {
+    long double v = static_cast<long double>(m);
+    return e >= 0 ? v * kExactPow10L[e] : v / kExactPow10L[-e];
+}
+
+// long double结果舍入到double;离中点太近(可能二次舍入出错)时返回false
+inline bool roundChecked(long double r, double* out) {
+    double d = static_cast<double>(r);
+    // 相邻的下一个double: 正数的位模式加一
+    uint64_t bits;
+    std::memcpy(&bits, &d, sizeof(bits));
+    ++bits;
+    double next;
+    std::memcpy(&next, &bits, sizeof(next));
+    long double ulp = static_cast<long double>(next) - d;
+    long double distance = std::fabs(std::fabs(r - d) - ulp / 2);
+    if (distance <= std::fabs(r) * 0x1p-61L) return false;
+    *out = d;
+    return true;
+}
+#endif
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+// 8个字符是否都是数字
+inline bool isEightDigits(uint64_t chunk) {
+    return ((chunk & 0xF0F0F0F0F0F0F0F0ULL) |
+            (((chunk + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4)) ==
+           0x3333333333333333ULL;
+}
+
+// 一次把8个数字字符转成整数(小端)
+inline uint32_t parseEightDigits(uint64_t chunk) {
+    chunk -= 0x3030303030303030ULL;
+    chunk = chunk * 10 + (chunk >> 8);
+    chunk = (((chunk & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32))) +
+             (((chunk >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32)))) >>
+            32;
+    return static_cast<uint32_t>(chunk);
+}
+#define WAYPOINT_CSV_SWAR 1
+#endif
+
+bool parseDouble(const char* begin, const char* end, double* out) {
+    const char* p = begin;
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = (*p == '-');
+        ++p;
+    }
+    unsigned long long m = 0;
+    int digits = 0;      // m中的有效数字个数
+    int exponent = 0;    // 十进制指数
+    bool truncated = false;
+    bool any = false;
+    for (; p < end && *p >= '0' && *p <= '9'; ++p) {
+        any = true;
+        if (digits < 19) {
+            m = m * 10 + static_cast<unsigned>(*p - '0');
+            if (m) ++digits;
+        } else {
+            ++exponent;
+            truncated |= (*p != '0');
+        }
+    }
+    if (p < end && *p == '.') {
+        ++p;
+#ifdef WAYPOINT_CSV_SWAR
+        // 已有有效数字后,小数部分每次取8位
+        while (m != 0 && digits + 8 <= 19 && end - p >= 8) {
+            uint64_t chunk;
+            std::memcpy(&chunk, p, sizeof(chunk));
+            if (!isEightDigits(chunk)) break;
+            m = m * 100000000ULL + parseEightDigits(chunk);
+            digits += 8;
+            exponent -= 8;
+            any = true;
+            p += 8;
+        }
+#endif
+        for (; p < end && *p >= '0' && *p <= '9'; ++p) {
+            any = true;
+            if (digits < 19) {
+                m = m * 10 + static_cast<unsigned>(*p - '0');
+                if (m) ++digits;
+                --exponent;
+            } else {
+                truncated |= (*p != '0');
+            }
+        }
+    }
+    // 指数形式等不常见的写法交给from_chars
+    if (!any || p != end) {
+        auto r = std::from_chars(begin, end, *out);
+        return r.ec == std::errc() && r.ptr == end;
+    }
+
+    double value;
+    if (!truncated && m <= (1ULL << 53) && exponent >= -22 && exponent <= 22) {
+        value = static_cast<double>(m);
+        value = exponent >= 0 ? value * kExactPow10[exponent]
+                              : value / kExactPow10[-exponent];
+        *out = negative ? -value : value;
+        return true;
+    }
+#if LDBL_MANT_DIG == 64
+    if (exponent >= -27 && exponent <= 27 && m < ~0ULL) {
+        double low, high;
+        if (roundChecked(scaleL(m, exponent), &low) &&
+            (!truncated ||
+             (roundChecked(scaleL(m + 1, exponent), &high) && high == low))) {
+            *out = negative ? -low : low;
+            return true;
+        }
+    }
+#endif
+    auto r = std::from_chars(begin, end, *out);
+    return r.ec == std::errc() && r.ptr == end;
+}
+
+}  // namespace
+
+// ---- WaypointCloud ----
+
+std::string_view WaypointCloud::name(size_t i) const {
+    if (!nameBase) return std::string_view();
+    return std::string_view(nameBase + nameOffset[i], nameLength[i]);
+}
+
+void WaypointCloud::resize(size_t n) {
+    id.resize(n);
+    nameOffset.resize(n);
+    nameLength.resize(n);
+    for (auto member : kDoubleColumns) (this->*member).resize(n);
+}
+
+double* WaypointCloud::column(int k) {
+    return (this->*kDoubleColumns[k]).data();
+}
+
+const double* WaypointCloud::column(int k) const {
+    return (this->*kDoubleColumns[k]).data();
+}
+
+// ---- WaypointCsvLoader ----
+
+bool WaypointCsvLoader::load(const std::string& path, int threads) {
+    auto file = std::make_shared<MappedFile>();
+    if (!file->open(path, &errorString_)) return false;
+    if (!parse(file->data(), file->size(), threads)) return false;
+    cloud_.source = file;
+    return true;
+}
+
+bool WaypointCsvLoader::parse(const char* text, size_t size, int threads) {
+    errorString_.clear();
+    cloud_ = WaypointCloud();
+    base_ = text;
+    if (threads <= 0) {
+        threads = static_cast<int>(std::thread::hardware_concurrency());
+        if (threads <= 0) threads = 1;
+    }
+
+    const char* begin = text;
+    const char* end = text + size;
+    size_t firstLine = 1;
+    // UTF-8 BOM
+    if (size >= 3 && std::memcmp(begin, "\xEF\xBB\xBF", 3) == 0) begin += 3;
+    // 表头: 第一行不以数字开头
+    if (begin < end && !(*begin >= '0' && *begin <= '9') && *begin != '-') {
+        const char* e = lineEnd(begin, end);
+        begin = e < end ? e + 1 : end;
+        ++firstLine;
+    }
+
+    // 按换行边界切块,太小的文件不拆分
+    const size_t kMinChunk = size_t(1) << 20;
+    size_t bytes = static_cast<size_t>(end - begin);
+    size_t chunkCount = static_cast<size_t>(threads);
+    if (bytes / kMinChunk + 1 < chunkCount) chunkCount = bytes / kMinChunk + 1;
+
+    std::vector<Chunk> chunks(chunkCount);
+    const char* p = begin;
+    for (size_t i = 0; i < chunkCount; i++) {
+        const char* e = (i + 1 == chunkCount) ? end : begin + bytes * (i + 1) / chunkCount;
+        if (e < p) e = p;
+        if (e < end) e = lineEnd(e, end);
+        if (e < end) ++e;  // 包含换行符
+        chunks[i].begin = p;
+        chunks[i].end = e;
+        p = e;
+    }
+
+    // 第一遍: 各块并行数行数,得到每块写入的起始下标
+    std::vector<size_t> rows(chunkCount), lines(chunkCount);
+    {
+        std::vector<std::thread> pool;
+        for (size_t i = 1; i < chunkCount; i++)
+            pool.emplace_back(countLines, chunks[i].begin, chunks[i].end,
+                              &rows[i], &lines[i]);
+        countLines(chunks[0].begin, chunks[0].end, &rows[0], &lines[0]);
+        for (auto& t : pool) t.join();
+    }
+    size_t total = 0;
+    for (size_t i = 0; i < chunkCount; i++) {
+        chunks[i].firstRow = total;
+        chunks[i].firstLine = firstLine;
+        total += rows[i];
+        firstLine += lines[i];
+    }
+    cloud_.resize(total);
+    cloud_.nameBase = text;
+
+    // 第二遍: 各块并行解析,直接写入最终位置
+    {
+        std::vector<std::thread> pool;
+        for (size_t i = 1; i < chunkCount; i++)
+            pool.emplace_back(&WaypointCsvLoader::parseChunk, this, &chunks[i]);
+        parseChunk(&chunks[0]);
+        for (auto& t : pool) t.join();
+    }
+    for (const Chunk& c : chunks) {
+        if (!c.error.empty()) {
+            errorString_ = c.error;
+            cloud_ = WaypointCloud();
+            return false;
+        }
+    }
+    return true;
+}
+
+void WaypointCsvLoader::parseChunk(Chunk* chunk) {
+    size_t row = chunk->firstRow;
+    size_t line = chunk->firstLine;
+    const char* p = chunk->begin;
+    while (p < chunk->end) {
+        const char* e = lineEnd(p, chunk->end);
+        const char* content = trimCr(p, e);
+        if (content > p) {
+            std::string error;
+            if (!parseRow(p, content, row, &error)) {
+                chunk->error = "line " + std::to_string(line) + ": " + error;
+                return;
+            }
+            ++row;
+        }
+        ++line;
+        p = e + 1;
+    }
+}
+
+bool WaypointCsvLoader::parseRow(const char* begin, const char* end, size_t row,
+                                 std::string* error) {
+    const char* p = begin;
+    for (int k = 0; k < kColumns; k++) {
+        if (p > end) {
+            *error = "expected " + std::to_string(kColumns) + " columns, got " +
+                     std::to_string(k);
+            return false;
+        }
+        const void* comma = std::memchr(p, ',', static_cast<size_t>(end - p));
+        const char* fieldEnd = comma ? static_cast<const char*>(comma) : end;
+        if (k + 1 < kColumns && !comma) {
+            *error = "expected " + std::to_string(kColumns) + " columns, got " +
+                     std::to_string(k + 1);
+            return false;
+        }
+        if (k + 1 == kColumns && comma) {
+            *error = "too many columns";
+            return false;
+        }
+
+        if (k == 0) {
+            auto r = std::from_chars(p, fieldEnd, cloud_.id[row]);
+            if (r.ec != std::errc() || r.ptr != fieldEnd) {
+                *error = "bad ID";
+                return false;
+            }
+        } else if (k == 1) {
+            cloud_.nameOffset[row] = static_cast<uint64_t>(p - base_);
+            cloud_.nameLength[row] = static_cast<uint32_t>(fieldEnd - p);
+        } else {
+            double* column = cloud_.column(k - 2);
+            if (!parseDouble(p, fieldEnd, &column[row])) {
+                *error = "bad number in column " + std::to_string(k + 1);
+                return false;
+            }
+        }
+        p = fieldEnd + 1;
+    }
+    return true;
+}
@@ -0,0 +1,79 @@
+/**
+ * 公历日期运算(仅头文件,全部constexpr)
+ *
+ * DaysFromCivil 把(年,月,日)换算成距1970-01-01的天数,常数时间,
+ * 没有按天/按月的循环: 以3月为一年之首,闰日落在年末,
+ * 400年一个周期共146097天.
+ * 两个日期的差值即两者天数之差,不依赖日期先后与跨越的年数.
+ *
+ * 计算部分不做任何输入输出,批量接口只读写调用方给的数组.
+ */
+#ifndef CIVIL_DATE_H
+#define CIVIL_DATE_H
+
+#include <cstddef>
+
+namespace civil {
+
+// 每月天数,第一维0为平年、1为闰年,下标1~12为月份
+constexpr int kMonthDays[2][13] = {
+    {0, 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31},
+    {0, 31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31}};
+
+constexpr bool IsLeap(int year) {
+  return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+}
+
+constexpr int MonthDays(int year, int month) {
+  return kMonthDays[IsLeap(year) ? 1 : 0][month];
+}
+
+// 检查年月日是否构成合法日期
+constexpr bool Valid(int year, int month, int day) {
+  return month >= 1 && month <= 12 && day >= 1 &&
+         day <= MonthDays(year, month);
+}
+
+// 距1970-01-01的天数(可为负)
+constexpr long long DaysFromCivil(int year, int month, int day) {
+  const long long y = static_cast<long long>(year) - (month <= 2 ? 1 : 0);
+  const long long era = (y >= 0 ? y : y - 399) / 400;
+  const long long yoe = y - era * 400;                                // [0, 399]
+  const long long mp = month > 2 ? month - 3 : month + 9;             // 3月为0
+  const long long doy = (153 * mp + 2) / 5 + day - 1;                 // [0, 365]
+  const long long doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;        // [0, 146096]
+  return era * 146097 + doe - 719468;
+}
+
+// YYYYMMDD形式的整数
+constexpr long long DaysFromYmd(int ymd) {
+  return DaysFromCivil(ymd / 10000, ymd % 10000 / 100, ymd % 100);
+}
+
+constexpr bool ValidYmd(int ymd) {
+  return Valid(ymd / 10000, ymd % 10000 / 100, ymd % 100);
+}
+
+// 题目规定的差值: 包含首尾两天,连续两天为2
+constexpr long long InclusiveDifference(int ymd1, int ymd2) {
+  const long long d = DaysFromYmd(ymd2) - DaysFromYmd(ymd1);
+  return (d < 0 ? -d : d) + 1;
+}
+
+static_assert(DaysFromCivil(1970, 1, 1) == 0, "epoch");
+static_assert(DaysFromCivil(2000, 3, 1) - DaysFromCivil(2000, 2, 28) == 2,
+              "2000 is leap");
+static_assert(DaysFromCivil(1900, 3, 1) - DaysFromCivil(1900, 2, 28) == 1,
+              "1900 is not leap");
+static_assert(InclusiveDifference(20130101, 20130105) == 5, "sample");
+static_assert(InclusiveDifference(20130105, 20130101) == 5, "order");
+
+// 批量计算 out[i] = InclusiveDifference(a[i], b[i])
+inline void InclusiveDifferenceBatch(const int *a, const int *b,
+                                     long long *out, size_t n) {
+  for (size_t i = 0; i < n; i++) out[i] = InclusiveDifference(a[i], b[i]);
+}
+
+}  // namespace civil
+
+#endif  // CIVIL_DATE_H
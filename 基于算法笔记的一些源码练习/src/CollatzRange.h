@@ -0,0 +1,202 @@
+/**
+ * PATB1001 (3n+1)猜想的区间统计(仅头文件)
+ *
+ * 按题目规则: n为偶数时 n/2, 为奇数时 (3n+1)/2, 各记一步, 直到 n = 1.
+ * 对[1, M]内每个n求步数, 支持最大步数及其最小的n、步数直方图两种查询.
+ *
+ * 备忘表: n < L 的步数存在uint16_t数组里(L默认min(M+1, 2^27)).
+ *   表按 [B, 2B) 的区间倍增填充, 区间内的n只需走到 < B 就能查表,
+ *   同一区间内互不依赖, 可并行.
+ * 区间部分: n >= L 的n一路走到 < L 再查表.奇数步用 n + n/2 + 1 代替 (3n+1)/2,
+ *   之后的连续偶数步用ctz一次除掉.
+ * 多线程: 各线程从原子计数器领取固定大小的块, 先做完的线程自然多领,
+ *   不同n的步数差异很大时也能保持负载均衡.
+ * 全部使用64位运算, 中间值超出64位时改用128位继续.
+ */
+#ifndef COLLATZ_RANGE_H
+#define COLLATZ_RANGE_H
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace collatz {
+
+struct RangeResult {
+  uint64_t max_steps = 0;
+  uint64_t argmax = 1;               // 步数最多的最小n
+  std::vector<uint64_t> histogram;   // histogram[k] = 步数为k的n的个数
+  uint64_t total_steps = 0;
+};
+
+// 单个n的步数(逐步模拟,64位)
+inline uint64_t Steps(uint64_t n) {
+  uint64_t steps = 0;
+  while (n > 1) {
+    n = (n & 1) ? n + (n >> 1) + 1 : n >> 1;
+    ++steps;
+  }
+  return steps;
+}
+
+namespace detail {
+
+// 奇数n做一步不会溢出的上界
+const uint64_t kSafeOdd = (UINT64_MAX - 1) / 3 * 2;
+
+// 128位继续走,直到 < limit
+inline uint32_t WalkWide(unsigned __int128 n, uint64_t limit,
+                         const uint16_t *memo) {
+  uint32_t steps = 0;
+  while (n >= limit) {
+    n = (n & 1) ? n + (n >> 1) + 1 : n >> 1;
+    ++steps;
+  }
+  return steps + memo[static_cast<uint64_t>(n)];
+}
+
+// 从n走到 < limit 后查表
+inline uint32_t WalkTo(uint64_t n, uint64_t limit, const uint16_t *memo) {
+  uint32_t steps = 0;
+  if (!(n & 1)) {
+    int t = __builtin_ctzll(n);
+    n >>= t;
+    steps += t;
+  }
+  while (n >= limit) {
+    if (n > kSafeOdd) return steps + WalkWide(n, limit, memo);
+    // 奇数: (3n+1)/2 = n + (n+1)/2
+    n = n + (n >> 1) + 1;
+    ++steps;
+    int t = __builtin_ctzll(n);
+    n >>= t;
+    steps += t;
+  }
+  return steps + memo[n];
+}
+
+// 线程局部的统计
+struct Tally {
+  uint64_t max_steps = 0;
+  uint64_t argmax = 1;
+  uint64_t total = 0;
+  std::vector<uint64_t> histogram = std::vector<uint64_t>(1024, 0);
+
+  void Add(uint64_t n, uint32_t steps) {
+    // 同一线程内n递增,严格大于才更新即得最小的n
+    if (steps > max_steps) {
+      max_steps = steps;
+      argmax = n;
+    }
+    if (steps >= histogram.size()) histogram.resize(steps * 2, 0);
+    ++histogram[steps];
+    total += steps;
+  }
+
+  void Merge(const Tally &o) {
+    if (o.max_steps > max_steps ||
+        (o.max_steps == max_steps && o.argmax < argmax)) {
+      max_steps = o.max_steps;
+      argmax = o.argmax;
+    }
+    if (o.histogram.size() > histogram.size())
+      histogram.resize(o.histogram.size(), 0);
+    for (size_t i = 0; i < o.histogram.size(); i++)
+      histogram[i] += o.histogram[i];
+    total += o.total;
+  }
+};
+
+// 用threads个线程处理[begin, end),每次领取chunk个n
+template <typename F>
+void ParallelChunks(uint64_t begin, uint64_t end, int threads, uint64_t chunk,
+                    F f) {
+  std::atomic<uint64_t> next(begin);
+  auto worker = [&](int id) {
+    while (true) {
+      uint64_t lo = next.fetch_add(chunk, std::memory_order_relaxed);
+      if (lo >= end) break;
+      uint64_t hi = end - lo < chunk ? end : lo + chunk;
+      f(id, lo, hi);
+    }
+  };
+  if (threads <= 1) {
+    worker(0);
+    return;
+  }
+  std::vector<std::thread> pool;
+  for (int t = 0; t < threads; t++) pool.emplace_back(worker, t);
+  for (std::thread &th : pool) th.join();
+}
+
+}  // namespace detail
+
+class RangeEngine {
+public:
+  // 默认备忘表上限: 2^27项(256MB)
+  static const uint64_t kDefaultMemo = uint64_t(1) << 27;
+  static const uint64_t kChunk = uint64_t(1) << 16;
+
+  explicit RangeEngine(int threads = 1, uint64_t memo_limit = kDefaultMemo)
+      : threads_(threads < 1 ? 1 : threads), memo_limit_(memo_limit) {
+    if (memo_limit_ < 2) memo_limit_ = 2;
+  }
+
+  // 统计[1, m]内全部n
+  RangeResult Run(uint64_t m) {
+    const uint64_t limit = m + 1 < memo_limit_ ? m + 1 : memo_limit_;
+    BuildMemo(limit < 2 ? 2 : limit);
+
+    std::vector<detail::Tally> tallies(threads_);
+    const uint16_t *memo = memo_.data();
+    // 备忘表内的部分直接读表
+    detail::ParallelChunks(
+        1, limit, threads_, kChunk, [&](int id, uint64_t lo, uint64_t hi) {
+          detail::Tally &t = tallies[id];
+          for (uint64_t n = lo; n < hi; n++) t.Add(n, memo[n]);
+        });
+    const uint64_t l = memo_.size();
+    detail::ParallelChunks(
+        limit, m + 1, threads_, kChunk, [&](int id, uint64_t lo, uint64_t hi) {
+          detail::Tally &t = tallies[id];
+          for (uint64_t n = lo; n < hi; n++)
+            t.Add(n, detail::WalkTo(n, l, memo));
+        });
+
+    for (int i = 1; i < threads_; i++) tallies[0].Merge(tallies[i]);
+    RangeResult result;
+    result.max_steps = tallies[0].max_steps;
+    result.argmax = tallies[0].argmax;
+    result.total_steps = tallies[0].total;
+    result.histogram.swap(tallies[0].histogram);
+    while (!result.histogram.empty() && result.histogram.back() == 0)
+      result.histogram.pop_back();
+    return result;
+  }
+
+private:
+  // 按[B, 2B)倍增填表,区间内的n走到 < B 即可查表
+  void BuildMemo(uint64_t limit) {
+    if (memo_.size() >= limit) return;
+    memo_.assign(limit, 0);
+    uint16_t *memo = memo_.data();
+    for (uint64_t b = 2; b < limit; b *= 2) {
+      const uint64_t e = 2 * b < limit ? 2 * b : limit;
+      detail::ParallelChunks(b, e, threads_, kChunk,
+                             [&](int, uint64_t lo, uint64_t hi) {
+                               for (uint64_t n = lo; n < hi; n++)
+                                 memo[n] = static_cast<uint16_t>(
+                                     detail::WalkTo(n, b, memo));
+                             });
+    }
+  }
+
+  int threads_;
+  uint64_t memo_limit_;
+  std::vector<uint16_t> memo_;
+};
+
+}  // namespace collatz
+
+#endif  // COLLATZ_RANGE_H
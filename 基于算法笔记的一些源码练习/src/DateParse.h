@@ -0,0 +1,261 @@
+/**
+ * 批量解析YYYYMMDD日期字段(仅头文件)
+ *
+ * 输入为连续的"8位数字 + 分隔符"(分隔符为','或单个空白字符,其后可再跟任意个
+ * 空白字符,最后一条可以没有),因此每行一个日期、每行"日期1 日期2"、
+ * "\r\n"换行和空行都能直接解析;
+ * 直接输出年、月、日三个数组,不先解析成整数再做 /10000、%10000/100、%100.
+ *
+ * 向量路径每次取4条(AVX2)或2条(SSSE3)记录的8字节数字:
+ *   减'0'后检查每个字节都不超过9,
+ *   maddubs按(10,1)两两合并,得到每条记录的 [年前两位][年后两位][月][日];
+ *   月在1~12且日在1~28的记录直接通过,日为29~31的记录再按平闰年查表.
+ * 分隔符不规则("\r\n"、连续空白)或组内有非法字段的位置逐条标量解析,之后继续按组;
+ * 剩余不足一组时也用标量解析.
+ * 指令集在运行时检测,也可用 ParseYmdBulkWith 指定.
+ */
+#ifndef DATE_PARSE_H
+#define DATE_PARSE_H
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define DATE_PARSE_X86 1
+#endif
+
+#include "CivilDate.h"
+
+namespace civil {
+
+enum class ParseIsa { Auto, Scalar, Sse, Avx2 };
+
+struct ParseResult {
+  size_t count = 0;       // 成功解析的日期数
+  size_t consumed = 0;    // 已消耗的字节数
+  bool ok = true;         // 遇到非法字段时为false
+  size_t error_offset = 0;  // 非法字段的起始偏移
+};
+
+namespace detail {
+
+inline bool IsSpace(char c) {
+  return c == '\n' || c == ' ' || c == '\t' || c == '\r';
+}
+
+// 向量路径只认单字节分隔符,"\r\n"和连续空白走标量路径
+inline bool IsDelimiter(char c) { return c == ',' || IsSpace(c); }
+
+// 解析p处的一条记录,返回记录加分隔符的长度,非法时返回0
+inline size_t ParseOne(const char *p, const char *end, int *year, int *month,
+                       int *day) {
+  if (end - p < 8) return 0;
+  int v[8];
+  for (int i = 0; i < 8; i++) {
+    unsigned d = static_cast<unsigned char>(p[i]) - '0';
+    if (d > 9) return 0;
+    v[i] = static_cast<int>(d);
+  }
+  const int y = v[0] * 1000 + v[1] * 100 + v[2] * 10 + v[3];
+  const int m = v[4] * 10 + v[5];
+  const int d = v[6] * 10 + v[7];
+  if (!Valid(y, m, d)) return 0;
+
+  size_t len = 8;
+  if (p + len < end) {
+    if (!IsDelimiter(p[len])) return 0;
+    // 分隔符之后的空白("\r\n"、连续空格、空行)一并跳过
+    len += 1;
+    while (p + len < end && IsSpace(p[len])) len++;
+  }
+  *year = y;
+  *month = m;
+  *day = d;
+  return len;
+}
+
+// 向量路径算出的一条记录:月、日粗检不通过时按平闰年精确检查
+inline bool Finish(const uint16_t *lanes, bool fast, int *year, int *month,
+                   int *day) {
+  const int y = lanes[0] * 100 + lanes[1];
+  const int m = lanes[2];
+  const int d = lanes[3];
+  if (!fast && !Valid(y, m, d)) return false;
+  *year = y;
+  *month = m;
+  *day = d;
+  return true;
+}
+
+// 4条(或2条)记录的分隔符都在第8字节且为单字节分隔符
+inline bool RegularStride(const char *p, int records) {
+  for (int i = 0; i < records; i++)
+    if (!IsDelimiter(p[i * 9 + 8])) return false;
+  return true;
+}
+
+inline ParseResult ParseScalar(const char *data, size_t size, int *year,
+                               int *month, int *day, size_t capacity,
+                               ParseResult r) {
+  const char *end = data + size;
+  const char *p = data + r.consumed;
+  while (p < end && r.count < capacity) {
+    size_t len = ParseOne(p, end, year + r.count, month + r.count,
+                          day + r.count);
+    if (len == 0) {
+      r.ok = false;
+      r.error_offset = p - data;
+      break;
+    }
+    p += len;
+    ++r.count;
+  }
+  r.consumed = p - data;
+  return r;
+}
+
+// 标量解析一条记录并前进;非法时记下错误位置并返回false
+inline bool StepScalar(const char *data, const char **p, const char *end,
+                       ParseResult *r, int *year, int *month, int *day) {
+  size_t len = ParseOne(*p, end, year + r->count, month + r->count,
+                        day + r->count);
+  if (len == 0) {
+    r->ok = false;
+    r->error_offset = *p - data;
+    r->consumed = *p - data;
+    return false;
+  }
+  *p += len;
+  ++r->count;
+  return true;
+}
+
+#ifdef DATE_PARSE_X86
+// 解析p处4条记录写入out+count;任一条不是合法日期时返回false
+__attribute__((target("avx2"))) inline bool ParseGroupAvx2(
+    const char *p, size_t count, int *year, int *month, int *day) {
+  const __m256i zero = _mm256_set1_epi8('0');
+  const __m256i nine = _mm256_set1_epi8(9);
+  const __m256i tens = _mm256_set1_epi16(0x010a);  // 字节序为(10,1)
+  // 每条记录4个16位通道: 年前两位、年后两位、月、日
+  const __m256i lower = _mm256_set1_epi64x(0x0001000100000000LL);
+  const __m256i upper = _mm256_set1_epi64x(0x001c000c00630063LL);
+
+  __m128i a = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(p));
+  __m128i b = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(p + 9));
+  __m128i c = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(p + 18));
+  __m128i d = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(p + 27));
+  __m256i v = _mm256_inserti128_si256(
+      _mm256_castsi128_si256(_mm_unpacklo_epi64(a, b)),
+      _mm_unpacklo_epi64(c, d), 1);
+  v = _mm256_sub_epi8(v, zero);
+  // 无符号比较: 不是数字的字节减'0'后大于9
+  __m256i digit = _mm256_cmpeq_epi8(_mm256_max_epu8(v, nine), nine);
+  if (_mm256_movemask_epi8(digit) != -1) return false;
+
+  __m256i t = _mm256_maddubs_epi16(v, tens);
+  __m256i out_of_range = _mm256_or_si256(_mm256_cmpgt_epi16(t, upper),
+                                         _mm256_cmpgt_epi16(lower, t));
+  const unsigned range_mask =
+      static_cast<unsigned>(_mm256_movemask_epi8(out_of_range));
+  alignas(32) uint16_t lanes[16];
+  _mm256_store_si256(reinterpret_cast<__m256i *>(lanes), t);
+
+  for (int i = 0; i < 4; i++) {
+    const bool fast = ((range_mask >> (i * 8)) & 0xff) == 0;
+    if (!Finish(lanes + i * 4, fast, year + count + i, month + count + i,
+                day + count + i))
+      return false;
+  }
+  return true;
+}
+
+// 解析p处2条记录
+__attribute__((target("ssse3"))) inline bool ParseGroupSse(
+    const char *p, size_t count, int *year, int *month, int *day) {
+  const __m128i zero = _mm_set1_epi8('0');
+  const __m128i nine = _mm_set1_epi8(9);
+  const __m128i tens = _mm_set1_epi16(0x010a);
+  const __m128i lower = _mm_set1_epi64x(0x0001000100000000LL);
+  const __m128i upper = _mm_set1_epi64x(0x001c000c00630063LL);
+
+  __m128i v = _mm_unpacklo_epi64(
+      _mm_loadl_epi64(reinterpret_cast<const __m128i *>(p)),
+      _mm_loadl_epi64(reinterpret_cast<const __m128i *>(p + 9)));
+  v = _mm_sub_epi8(v, zero);
+  __m128i digit = _mm_cmpeq_epi8(_mm_max_epu8(v, nine), nine);
+  if (_mm_movemask_epi8(digit) != 0xffff) return false;
+
+  __m128i t = _mm_maddubs_epi16(v, tens);
+  __m128i out_of_range =
+      _mm_or_si128(_mm_cmpgt_epi16(t, upper), _mm_cmpgt_epi16(lower, t));
+  const unsigned range_mask =
+      static_cast<unsigned>(_mm_movemask_epi8(out_of_range));
+  alignas(16) uint16_t lanes[8];
+  _mm_store_si128(reinterpret_cast<__m128i *>(lanes), t);
+
+  for (int i = 0; i < 2; i++) {
+    const bool fast = ((range_mask >> (i * 8)) & 0xff) == 0;
+    if (!Finish(lanes + i * 4, fast, year + count + i, month + count + i,
+                day + count + i))
+      return false;
+  }
+  return true;
+}
+
+// 按组向量解析;分隔符不规则或组内有非法字段时,该位置退回标量解析一条
+template <int kGroup, bool (*Group)(const char *, size_t, int *, int *, int *)>
+inline ParseResult ParseGrouped(const char *data, size_t size, int *year,
+                                int *month, int *day, size_t capacity) {
+  ParseResult r;
+  const char *end = data + size;
+  const char *p = data;
+  // 一组占kGroup*9字节(含最后一条的分隔符)
+  while (end - p >= kGroup * 9 && r.count + kGroup <= capacity) {
+    if (RegularStride(p, kGroup) && Group(p, r.count, year, month, day)) {
+      r.count += kGroup;
+      p += kGroup * 9;
+      // 最后一条的分隔符后面可能还有空白
+      while (p < end && IsSpace(*p)) ++p;
+    } else if (!StepScalar(data, &p, end, &r, year, month, day)) {
+      return r;
+    }
+  }
+  r.consumed = p - data;
+  return ParseScalar(data, size, year, month, day, capacity, r);
+}
+#endif
+
+}  // namespace detail
+
+// 用指定指令集解析;机器不支持时退回标量
+inline ParseResult ParseYmdBulkWith(ParseIsa isa, const char *data,
+                                    size_t size, int *year, int *month,
+                                    int *day, size_t capacity) {
+#ifdef DATE_PARSE_X86
+  if (isa == ParseIsa::Auto)
+    isa = __builtin_cpu_supports("avx2")    ? ParseIsa::Avx2
+          : __builtin_cpu_supports("ssse3") ? ParseIsa::Sse
+                                            : ParseIsa::Scalar;
+  if (isa == ParseIsa::Avx2 && __builtin_cpu_supports("avx2"))
+    return detail::ParseGrouped<4, detail::ParseGroupAvx2>(
+        data, size, year, month, day, capacity);
+  if (isa == ParseIsa::Sse && __builtin_cpu_supports("ssse3"))
+    return detail::ParseGrouped<2, detail::ParseGroupSse>(
+        data, size, year, month, day, capacity);
+#endif
+  return detail::ParseScalar(data, size, year, month, day, capacity,
+                             ParseResult());
+}
+
+// 解析[data, data+size)中最多capacity个日期;遇到非法字段即停止,ok为false
+inline ParseResult ParseYmdBulk(const char *data, size_t size, int *year,
+                                int *month, int *day, size_t capacity) {
+  return ParseYmdBulkWith(ParseIsa::Auto, data, size, year, month, day,
+                          capacity);
+}
+
+}  // namespace civil
+
+#endif  // DATE_PARSE_H
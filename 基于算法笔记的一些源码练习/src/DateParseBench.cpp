@@ -0,0 +1,167 @@
+/**
+ * DateParse.h 的吞吐量(GB/s)与 scanf 对比
+ *
+ * 先检查若干合法/非法日期的判定与"日期1 日期2"逐行格式,再生成N个随机合法日期(换行或逗号分隔),
+ * 分别用 scanf、标量、SSSE3、AVX2 解析,核对结果一致并输出吞吐量.
+ *
+ * 编译: g++ -O2 -o DateParseBench DateParseBench.cpp
+ * 运行: ./DateParseBench [N]   (默认N=10^7)
+ */
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "DateParse.h"
+
+namespace {
+
+double Seconds(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+// 单个字段的合法性必须与标量/向量路径一致
+bool CheckValidation() {
+  struct Case {
+    const char *text;
+    bool valid;
+  } cases[] = {
+      {"20130101\n", true},  {"20000229\n", true},  {"19000229\n", false},
+      {"20130230\n", false}, {"20131301\n", false}, {"20130001\n", false},
+      {"20130100\n", false}, {"20130132\n", false}, {"2013a101\n", false},
+      {"20130431\n", false}, {"20131231,", true},   {"20240229\r\n", true},
+  };
+  bool ok = true;
+  for (const Case &c : cases) {
+    // 重复成足够长的输入,使向量路径也被覆盖
+    std::string text;
+    for (int i = 0; i < 8; i++) text += "20130101\n";
+    text += c.text;
+    for (int i = 0; i < 8; i++) text += "20130101\n";
+    const civil::ParseIsa isas[] = {civil::ParseIsa::Scalar,
+                                    civil::ParseIsa::Sse,
+                                    civil::ParseIsa::Avx2};
+    for (civil::ParseIsa isa : isas) {
+      int y[32], m[32], d[32];
+      civil::ParseResult r = civil::ParseYmdBulkWith(
+          isa, text.data(), text.size(), y, m, d, 32);
+      bool valid = r.ok && r.count == 17;
+      bool stopped_right = r.ok || r.error_offset == 8 * 9;
+      if (valid != c.valid || !stopped_right) {
+        printf("validation failed: %.8s isa=%d\n", c.text,
+               static_cast<int>(isa));
+        ok = false;
+      }
+    }
+  }
+  return ok;
+}
+
+// codeup1928的"日期1 日期2"逐行格式与各种空白分隔必须和逐条解析结果一致
+bool CheckPairs() {
+  const char *separators[] = {" ", "\t", "  ", " \r\n", "\n\n"};
+  bool ok = true;
+  for (const char *separator : separators) {
+    // 两种行尾交替,足够长使向量路径也被覆盖
+    std::string text;
+    std::vector<int> expect;
+    for (int i = 0; i < 24; i++) {
+      const int a = i % 2 ? 20200228 : 20130101;
+      const int b = i % 2 ? 20200301 : 20130105;
+      text += std::to_string(a) + separator + std::to_string(b);
+      text += i % 3 ? "\n" : "\r\n";
+      expect.push_back(a);
+      expect.push_back(b);
+    }
+    const civil::ParseIsa isas[] = {civil::ParseIsa::Scalar,
+                                    civil::ParseIsa::Sse,
+                                    civil::ParseIsa::Avx2};
+    for (civil::ParseIsa isa : isas) {
+      int y[64], m[64], d[64];
+      civil::ParseResult r = civil::ParseYmdBulkWith(
+          isa, text.data(), text.size(), y, m, d, 64);
+      bool match = r.ok && r.count == expect.size() &&
+                   r.consumed == text.size();
+      for (size_t i = 0; match && i < expect.size(); i++)
+        match = y[i] * 10000 + m[i] * 100 + d[i] == expect[i];
+      if (!match) {
+        printf("pair check failed: separator=%zu bytes isa=%d\n",
+               strlen(separator), static_cast<int>(isa));
+        ok = false;
+      }
+    }
+  }
+  return ok;
+}
+
+std::string Generate(size_t n, char delimiter) {
+  std::mt19937 rng(1928);
+  std::string text;
+  text.reserve(n * 9);
+  char buf[32];
+  for (size_t i = 0; i < n; i++) {
+    int y = 1900 + static_cast<int>(rng() % 300);
+    int m = 1 + static_cast<int>(rng() % 12);
+    int d = 1 + static_cast<int>(rng() % civil::MonthDays(y, m));
+    snprintf(buf, sizeof(buf), "%04d%02d%02d%c", y, m, d, delimiter);
+    text += buf;
+  }
+  return text;
+}
+
+void Report(const char *name, double sec, size_t bytes, size_t count,
+            bool match) {
+  printf("%-8s %9.2f ms  %7.3f GB/s  %8.1f Mdates/s  %s\n", name, sec * 1000,
+         bytes / sec / 1e9, count / sec / 1e6, match ? "ok" : "MISMATCH");
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  size_t n = argc > 1 ? strtoull(argv[1], nullptr, 10) : 10000000;
+  if (!CheckValidation() || !CheckPairs()) return 1;
+  printf("validation ok\n");
+
+  std::vector<int> ref_y(n), ref_m(n), ref_d(n);
+  std::vector<int> y(n), m(n), d(n);
+
+  const char delimiters[] = {'\n', ','};
+  for (char delimiter : delimiters) {
+    std::string text = Generate(n, delimiter);
+    printf("N=%zu delimiter=%s size=%.1f MB\n", n,
+           delimiter == '\n' ? "\\n" : ",", text.size() / 1e6);
+
+    // scanf: 把整块文本当作内存流
+    {
+      FILE *fp = fmemopen(&text[0], text.size(), "r");
+      char fmt[16];
+      snprintf(fmt, sizeof(fmt), "%%4d%%2d%%2d%c", delimiter);
+      auto start = std::chrono::steady_clock::now();
+      size_t count = 0;
+      while (count < n &&
+             fscanf(fp, fmt, &ref_y[count], &ref_m[count], &ref_d[count]) == 3)
+        ++count;
+      Report("scanf", Seconds(start), text.size(), count, count == n);
+      fclose(fp);
+    }
+
+    const civil::ParseIsa isas[] = {civil::ParseIsa::Scalar,
+                                    civil::ParseIsa::Sse,
+                                    civil::ParseIsa::Avx2};
+    const char *names[] = {"scalar", "ssse3", "avx2"};
+    for (int k = 0; k < 3; k++) {
+      auto start = std::chrono::steady_clock::now();
+      civil::ParseResult r = civil::ParseYmdBulkWith(
+          isas[k], text.data(), text.size(), y.data(), m.data(), d.data(), n);
+      double sec = Seconds(start);
+      bool match = r.ok && r.count == n && y == ref_y && m == ref_m &&
+                   d == ref_d;
+      Report(names[k], sec, text.size(), r.count, match);
+    }
+  }
+  return 0;
+}
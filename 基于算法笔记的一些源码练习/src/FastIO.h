@@ -0,0 +1,351 @@
+/**
+ * 练习程序共用的快速输入输出(仅头文件)
+ *
+ * Reader: 标准输入是普通文件时直接mmap整个文件,否则按64KB大块read;
+ *         整数和浮点数手工解析,不经过scanf的格式串解释.
+ * Writer: 输出先写入缓冲区,缓冲区满或析构时用一次write系统调用刷出;
+ *         写出失败(EPIPE/ENOSPC等)记录在Ok()/Error()里,需要时由调用方检查.
+ *
+ * 用法:
+ *   fastio::Reader in;  int n; in.ReadInt(n);
+ *   fastio::Writer out; out.WriteInt(n); out.WriteChar('\n');
+ */
+#ifndef FASTIO_H
+#define FASTIO_H
+
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace fastio {
+
+class Reader {
+public:
+  explicit Reader(int fd = 0) : fd_(fd) {
+    struct stat st;
+    // 普通文件整体映射,省去read的拷贝
+    if (fstat(fd_, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+      off_t offset = lseek(fd_, 0, SEEK_CUR);
+      if (offset < 0) offset = 0;
+      void *p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd_, 0);
+      if (p != MAP_FAILED) {
+        madvise(p, st.st_size, MADV_SEQUENTIAL);
+        map_ = static_cast<char *>(p);
+        map_len_ = st.st_size;
+        buf_ = map_;
+        len_ = map_len_;
+        pos_ = offset;
+        eof_ = true;  // 没有更多数据需要read
+        return;
+      }
+    }
+    buf_ = new char[kBlock];
+  }
+
+  ~Reader() {
+    if (map_) {
+      munmap(map_, map_len_);
+    } else {
+      delete[] buf_;
+    }
+  }
+
+  Reader(const Reader &) = delete;
+  Reader &operator=(const Reader &) = delete;
+
+  // 读取一个整数,没有更多输入时返回false
+  template <typename T>
+  bool ReadInt(T &x) {
+    int c = SkipSpace();
+    if (c < 0) return false;
+    bool neg = false;
+    if (c == '-' || c == '+') {
+      neg = (c == '-');
+      ++pos_;
+      c = Peek();
+    }
+    if (c < '0' || c > '9') return false;
+    T v = 0;
+    while (c >= '0' && c <= '9') {
+      v = v * 10 + (c - '0');
+      ++pos_;
+      c = Peek();
+    }
+    x = neg ? -v : v;
+    return true;
+  }
+
+  bool ReadInt(int &x) { return ReadInt<int>(x); }
+  bool ReadLong(long long &x) { return ReadInt<long long>(x); }
+
+  // 读取一个浮点数(支持小数和指数)
+  bool ReadDouble(double &x) {
+    int c = SkipSpace();
+    if (c < 0) return false;
+    bool neg = false;
+    if (c == '-' || c == '+') {
+      neg = (c == '-');
+      ++pos_;
+      c = Peek();
+    }
+    // 前19位有效数字累加到整数里,其余只计数量级
+    unsigned long long mantissa = 0;
+    int digits = 0, exp10 = 0;
+    bool any = false;
+    while (c >= '0' && c <= '9') {
+      any = true;
+      if (digits < 19) {
+        mantissa = mantissa * 10 + (c - '0');
+        if (mantissa) ++digits;
+      } else {
+        ++exp10;
+      }
+      ++pos_;
+      c = Peek();
+    }
+    if (c == '.') {
+      ++pos_;
+      c = Peek();
+      while (c >= '0' && c <= '9') {
+        any = true;
+        if (digits < 19) {
+          mantissa = mantissa * 10 + (c - '0');
+          if (mantissa) ++digits;
+          --exp10;
+        }
+        ++pos_;
+        c = Peek();
+      }
+    }
+    if (!any) return false;
+    if (c == 'e' || c == 'E') {
+      ++pos_;
+      int e = 0;
+      if (!ReadInt(e)) return false;
+      exp10 += e;
+    }
+    double v = static_cast<double>(mantissa);
+    if (exp10 > 0) {
+      v *= Pow10(exp10);
+    } else if (exp10 < 0) {
+      v /= Pow10(-exp10);
+    }
+    x = neg ? -v : v;
+    return true;
+  }
+
+  // 读取一个非空白字符
+  bool ReadChar(char &ch) {
+    int c = SkipSpace();
+    if (c < 0) return false;
+    ch = static_cast<char>(c);
+    ++pos_;
+    return true;
+  }
+
+private:
+  static const size_t kBlock = 1 << 16;
+
+  static double Pow10(int e) {
+    static const double table[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,
+                                   1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                   1e12, 1e13, 1e14, 1e15, 1e16, 1e17,
+                                   1e18, 1e19, 1e20, 1e21, 1e22};
+    double r = 1;
+    while (e > 22) {
+      r *= 1e22;
+      e -= 22;
+    }
+    return r * table[e];
+  }
+
+  int Peek() {
+    if (pos_ < len_) return static_cast<unsigned char>(buf_[pos_]);
+    if (eof_) return -1;
+    ssize_t n = read(fd_, buf_, kBlock);
+    if (n <= 0) {
+      eof_ = true;
+      return -1;
+    }
+    len_ = n;
+    pos_ = 0;
+    return static_cast<unsigned char>(buf_[0]);
+  }
+
+  int SkipSpace() {
+    int c = Peek();
+    while (c == ' ' || c == '\n' || c == '\r' || c == '\t') {
+      ++pos_;
+      c = Peek();
+    }
+    return c;
+  }
+
+  int fd_;
+  char *buf_ = nullptr;
+  size_t len_ = 0, pos_ = 0;
+  bool eof_ = false;
+  char *map_ = nullptr;
+  size_t map_len_ = 0;
+};
+
+class Writer {
+public:
+  explicit Writer(int fd = 1, size_t capacity = 1 << 20)
+      : fd_(fd), buf_(new char[capacity]), cap_(capacity) {}
+
+  ~Writer() {
+    Flush();
+    delete[] buf_;
+  }
+
+  Writer(const Writer &) = delete;
+  Writer &operator=(const Writer &) = delete;
+
+  void WriteChar(char c) {
+    if (len_ == cap_) Flush();
+    buf_[len_++] = c;
+  }
+
+  void WriteStr(const char *s, size_t n) {
+    while (n > 0) {
+      if (len_ == cap_) Flush();
+      size_t k = n < cap_ - len_ ? n : cap_ - len_;
+      memcpy(buf_ + len_, s, k);
+      len_ += k;
+      s += k;
+      n -= k;
+    }
+  }
+
+  void WriteStr(const char *s) { WriteStr(s, strlen(s)); }
+
+  // 连续写n个相同字符
+  void Fill(char c, size_t n) {
+    while (n > 0) {
+      if (len_ == cap_) Flush();
+      size_t k = n < cap_ - len_ ? n : cap_ - len_;
+      memset(buf_ + len_, c, k);
+      len_ += k;
+      n -= k;
+    }
+  }
+
+  // 在缓冲区中预留n个字节供调用方直接填写(n不能超过容量)
+  char *Reserve(size_t n) {
+    if (cap_ - len_ < n) Flush();
+    char *p = buf_ + len_;
+    len_ += n;
+    return p;
+  }
+
+  size_t Capacity() const { return cap_; }
+
+  void WriteInt(long long x) {
+    char tmp[24];
+    int n = 0;
+    unsigned long long v = x < 0 ? 0ULL - static_cast<unsigned long long>(x)
+                                 : static_cast<unsigned long long>(x);
+    do {
+      tmp[n++] = static_cast<char>('0' + v % 10);
+      v /= 10;
+    } while (v);
+    if (x < 0) tmp[n++] = '-';
+    if (cap_ - len_ < static_cast<size_t>(n)) Flush();
+    while (n > 0) buf_[len_++] = tmp[--n];
+  }
+
+  // 定点输出,与printf("%.*f")逐字节一致: 按double的精确二进制值舍入,
+  // 恰好一半时取偶(0.125保留两位为0.12),负数和-0.0都带负号.
+  // 精度超过9、|x|>=1e9或非有限值时退回snprintf
+  void WriteDouble(double x, int precision = 6) {
+    static const unsigned long long scale[] = {
+        1ULL,      10ULL,      100ULL,      1000ULL,      10000ULL,
+        100000ULL, 1000000ULL, 10000000ULL, 100000000ULL, 1000000000ULL};
+    double ax = std::fabs(x);
+    if (precision < 0 || precision > 9 || !(ax < 1e9)) {
+      char tmp[512];
+      int n = snprintf(tmp, sizeof(tmp), "%.*f", precision, x);
+      if (n < 0) n = 0;
+      WriteStr(tmp, static_cast<size_t>(n) < sizeof(tmp) ? n : sizeof(tmp) - 1);
+      return;
+    }
+    unsigned long long s = scale[precision];
+    unsigned long long v = RoundScaled(ax, s);
+    if (std::signbit(x)) WriteChar('-');
+    WriteInt(static_cast<long long>(v / s));
+    if (precision > 0) {
+      WriteChar('.');
+      unsigned long long frac = v % s;
+      char tmp[10];
+      for (int i = precision - 1; i >= 0; --i) {
+        tmp[i] = static_cast<char>('0' + frac % 10);
+        frac /= 10;
+      }
+      WriteStr(tmp, precision);
+    }
+  }
+
+  // 刷出缓冲区: 部分写入时接着写,被信号打断(EINTR)时重试;
+  // 其他失败记下errno,此后的输出全部丢弃.返回至今是否都已写出
+  bool Flush() {
+    size_t done = 0;
+    while (error_ == 0 && done < len_) {
+      ssize_t n = write(fd_, buf_ + done, len_ - done);
+      if (n < 0 && errno == EINTR) continue;
+      if (n <= 0) {
+        error_ = n < 0 ? errno : EIO;
+        break;
+      }
+      done += n;
+    }
+    written_ += done;
+    len_ = 0;
+    return error_ == 0;
+  }
+
+  // 至今没有写出失败(缓冲区里尚未刷出的部分不算)
+  bool Ok() const { return error_ == 0; }
+  // 第一次写出失败时的errno,没有失败时为0
+  int Error() const { return error_; }
+  // 已经写到fd的字节数
+  unsigned long long Written() const { return written_; }
+
+private:
+  // ax*s按精确值舍入到整数,恰好一半时取偶.ax = m*2^(exp-53),
+  // m*s不超过2^83,用128位整数精确计算(ax<1e9且s<=1e9,结果不超过1e18)
+  static unsigned long long RoundScaled(double ax, unsigned long long s) {
+    if (ax == 0) return 0;
+    int exp = 0;
+    const double fr = std::frexp(ax, &exp);
+    const unsigned long long m =
+        static_cast<unsigned long long>(std::ldexp(fr, 53));
+    const unsigned __int128 p = static_cast<unsigned __int128>(m) * s;
+    const int shift = 53 - exp;
+    if (shift <= 0) return static_cast<unsigned long long>(p << -shift);
+    if (shift > 100) return 0;  // 不到0.5
+    unsigned __int128 q = p >> shift;
+    const unsigned __int128 rem = p - (q << shift);
+    const unsigned __int128 half = static_cast<unsigned __int128>(1)
+                                   << (shift - 1);
+    if (rem > half || (rem == half && (q & 1))) ++q;
+    return static_cast<unsigned long long>(q);
+  }
+
+  int fd_;
+  char *buf_;
+  size_t cap_;
+  size_t len_ = 0;
+  int error_ = 0;
+  unsigned long long written_ = 0;
+};
+
+}  // namespace fastio
+
+#endif  // FASTIO_H
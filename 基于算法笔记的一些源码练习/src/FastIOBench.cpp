@@ -0,0 +1,233 @@
+/**
+ * FastIO.h 与 scanf / cin / printf 的性能对比
+ *
+ * 先核对 Writer::WriteDouble 与 snprintf("%.*f") 逐字节一致
+ * (恰好一半的值、负数与-0.0、接近1e9的值、随机值,精度0~12),
+ * 以及写到/dev/full或读端已关闭的管道时Writer报告失败而不是静默截断.
+ *
+ * 编译: g++ -O2 -o FastIOBench FastIOBench.cpp
+ * 运行: ./FastIOBench [N]   (默认N=10^6,生成N个整数和N个浮点数)
+ */
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <csignal>
+
+#include "FastIO.h"
+
+namespace {
+
+double Seconds(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+// 生成测试输入文件
+void Generate(const char *path, int n) {
+  std::mt19937 rng(1032);
+  std::uniform_int_distribution<int> ints(-1000000000, 1000000000);
+  std::uniform_real_distribution<double> reals(0, 100);
+  int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  {
+    fastio::Writer out(fd);
+    out.WriteInt(n);
+    out.WriteChar('\n');
+    for (int i = 0; i < n; i++) {
+      out.WriteInt(ints(rng));
+      out.WriteChar(' ');
+      out.WriteDouble(reals(rng), 2);
+      out.WriteChar('\n');
+    }
+  }
+  close(fd);
+}
+
+// WriteDouble写入临时文件,与snprintf拼出的期望文本比较
+bool CheckWriteDouble() {
+  std::vector<double> values = {
+      0.0,      -0.0,       0.125,     0.375,     2.5,        -2.5,
+      0.5,      1.5,        -0.001,    0.005,     0.015,      1.005,
+      999999999.5, 999999999.9999, 1e9,  -1e9,     1e300,      5e-324,
+      123456.789, 0.1,      0.7,       1e-7,      4.35,       2.675};
+  std::mt19937_64 rng(31);
+  std::uniform_real_distribution<double> unit(0, 1);
+  for (int i = 0; i < 20000; i++) {
+    const double scale_exp = static_cast<double>(rng() % 19) - 9;  // 1e-9 ~ 1e9
+    double v = unit(rng) * std::pow(10.0, scale_exp);
+    // k/2^j 形式的值在较低精度下恰好落在一半上
+    if (i % 4 == 0) v = std::ldexp(static_cast<double>(rng() % 100000), -(i % 20));
+    values.push_back(i % 3 == 0 ? -v : v);
+  }
+  values.push_back(std::numeric_limits<double>::infinity());
+  values.push_back(std::numeric_limits<double>::quiet_NaN());
+
+  const char *path = "/tmp/fastio_double_check.txt";
+  std::string expect;
+  char buf[512];
+  int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  {
+    fastio::Writer out(fd);
+    for (double v : values) {
+      for (int precision = 0; precision <= 12; precision++) {
+        out.WriteDouble(v, precision);
+        out.WriteChar('\n');
+        snprintf(buf, sizeof(buf), "%.*f\n", precision, v);
+        expect += buf;
+      }
+    }
+  }
+  close(fd);
+
+  std::ifstream in(path);
+  std::string got((std::istreambuf_iterator<char>(in)),
+                  std::istreambuf_iterator<char>());
+  remove(path);
+  if (got == expect) return true;
+  size_t i = 0;
+  while (i < got.size() && i < expect.size() && got[i] == expect[i]) ++i;
+  size_t line = expect.rfind('\n', i);
+  line = line == std::string::npos ? 0 : line + 1;
+  printf("WriteDouble mismatch: expected \"%s\" got \"%s\"\n",
+         expect.substr(line, expect.find('\n', line) - line).c_str(),
+         got.substr(line, got.find('\n', line) - line).c_str());
+  return false;
+}
+
+// 写出失败必须体现在Flush()/Ok()上: /dev/full返回ENOSPC,关闭读端的管道返回EPIPE
+bool CheckWriteFailure() {
+  signal(SIGPIPE, SIG_IGN);
+  struct Case {
+    const char *name;
+    int fd;
+    int expect;
+  };
+  int pipefd[2] = {-1, -1};
+  if (pipe(pipefd) != 0) return false;
+  close(pipefd[0]);
+  const Case cases[] = {{"/dev/full", open("/dev/full", O_WRONLY), ENOSPC},
+                        {"closed pipe", pipefd[1], EPIPE}};
+  bool ok = true;
+  for (const Case &c : cases) {
+    if (c.fd < 0) continue;  // 没有/dev/full的系统跳过
+    bool flushed;
+    {
+      fastio::Writer out(c.fd, 64);
+      out.Fill('x', 1000);
+      flushed = out.Flush();
+      if (flushed || out.Ok() || out.Error() != c.expect) {
+        printf("Writer on %s: Flush() = %d, Error() = %d, expected %d\n",
+               c.name, flushed, out.Error(), c.expect);
+        ok = false;
+      }
+    }
+    close(c.fd);
+  }
+  return ok;
+}
+
+void Report(const char *name, double sec, long long checksum) {
+  printf("%-18s %9.3f ms   checksum %lld\n", name, sec * 1000, checksum);
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  int n = argc > 1 ? atoi(argv[1]) : 1000000;
+  if (!CheckWriteDouble() || !CheckWriteFailure()) return 1;
+  printf("WriteDouble matches snprintf\n");
+
+  const char *path = "/tmp/fastio_bench_input.txt";
+  Generate(path, n);
+
+  // scanf
+  {
+    FILE *fp = fopen(path, "r");
+    auto start = std::chrono::steady_clock::now();
+    int cnt = 0;
+    long long sum = 0;
+    if (fscanf(fp, "%d", &cnt) == 1) {
+      for (int i = 0; i < cnt; i++) {
+        int a = 0;
+        double b = 0;
+        if (fscanf(fp, "%d %lf", &a, &b) != 2) break;
+        sum += a + static_cast<long long>(b * 100 + 0.5);
+      }
+    }
+    Report("scanf", Seconds(start), sum);
+    fclose(fp);
+  }
+
+  // iostream(关闭同步后的cin等价于文件流)
+  {
+    std::ios::sync_with_stdio(false);
+    std::ifstream in(path);
+    auto start = std::chrono::steady_clock::now();
+    int cnt = 0;
+    long long sum = 0;
+    in >> cnt;
+    for (int i = 0; i < cnt; i++) {
+      int a = 0;
+      double b = 0;
+      in >> a >> b;
+      sum += a + static_cast<long long>(b * 100 + 0.5);
+    }
+    Report("ifstream/cin", Seconds(start), sum);
+  }
+
+  // fastio::Reader(mmap)
+  {
+    int fd = open(path, O_RDONLY);
+    auto start = std::chrono::steady_clock::now();
+    long long sum = 0;
+    {
+      fastio::Reader in(fd);
+      int cnt = 0;
+      in.ReadInt(cnt);
+      for (int i = 0; i < cnt; i++) {
+        int a = 0;
+        double b = 0;
+        in.ReadInt(a);
+        in.ReadDouble(b);
+        sum += a + static_cast<long long>(b * 100 + 0.5);
+      }
+    }
+    Report("fastio::Reader", Seconds(start), sum);
+    close(fd);
+  }
+
+  // 输出: printf 与 Writer 都写到/dev/null
+  {
+    FILE *fp = fopen("/dev/null", "w");
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < n; i++) fprintf(fp, "%d %f\n", i, i * 0.5);
+    fclose(fp);
+    Report("printf", Seconds(start), n);
+  }
+  {
+    int fd = open("/dev/null", O_WRONLY);
+    auto start = std::chrono::steady_clock::now();
+    {
+      fastio::Writer out(fd);
+      for (int i = 0; i < n; i++) {
+        out.WriteInt(i);
+        out.WriteChar(' ');
+        out.WriteDouble(i * 0.5);
+        out.WriteChar('\n');
+      }
+    }
+    Report("fastio::Writer", Seconds(start), n);
+    close(fd);
+  }
+
+  remove(path);
+  return 0;
+}
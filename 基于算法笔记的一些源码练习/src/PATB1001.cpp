@@ -1,24 +1,91 @@
 #include<iostream>
+#include<cstdlib>
+#include<cstring>
+#include<chrono>
+
+#include "FastIO.h"
+#include "CollatzRange.h"
 
 void Callatz(){
-  int i=0;
+  fastio::Reader in;
+  fastio::Writer out;
+  // 64位,避免较大的n在3n+1时溢出
+  long long i=0;
   int step = 0;
-  printf("please input your number: \n");
-  scanf("%d",&i);
+  out.WriteStr("please input your number: \n");
+  out.Flush();
+  if(!in.ReadLong(i) || i<1) return;
   while(i!=1){
-    printf("%d",i);
+    out.WriteInt(i);
     if(i%2 == 0){
       i = i/2;
     }else {
       i = (3*i+1)/2;
     }
-    printf(" -> ");
+    out.WriteStr(" -> ");
     step++;
   }
-  printf("step: %d\n",step);
+  out.WriteStr("step: ");
+  out.WriteInt(step);
+  out.WriteChar('\n');
+}
+
+
+/**
+ * 区间模式: 统计[1, M]内每个n的步数
+ * 用法: PATB1001 range M [线程数] [hist]
+ * 输出步数最多的最小n及其步数;带hist时再输出每个步数的n的个数
+ */
+int Range(int argc,char *argv[]){
+  if(argc<3){
+    fprintf(stderr,"usage: %s range M [threads] [hist]\n",argv[0]);
+    return 1;
+  }
+  uint64_t m = strtoull(argv[2],nullptr,10);
+  int threads = static_cast<int>(std::thread::hardware_concurrency());
+  bool hist = false;
+  for(int i=3;i<argc;i++){
+    if(strcmp(argv[i],"hist")==0) hist = true;
+    else threads = atoi(argv[i]);
+  }
+  if(m<1) m = 1;
 
+  auto start = std::chrono::steady_clock::now();
+  collatz::RangeEngine engine(threads);
+  collatz::RangeResult r = engine.Run(m);
+  double sec = std::chrono::duration<double>(
+      std::chrono::steady_clock::now()-start).count();
+
+  fastio::Writer out;
+  out.WriteStr("max steps: ");
+  out.WriteInt(static_cast<long long>(r.max_steps));
+  out.WriteStr(" at n = ");
+  out.WriteInt(static_cast<long long>(r.argmax));
+  out.WriteChar('\n');
+  if(hist){
+    for(size_t k=0;k<r.histogram.size();k++){
+      if(!r.histogram[k]) continue;
+      out.WriteInt(static_cast<long long>(k));
+      out.WriteChar(' ');
+      out.WriteInt(static_cast<long long>(r.histogram[k]));
+      out.WriteChar('\n');
+    }
+  }
+  if(!out.Flush()){
+    errno = out.Error();
+    perror("write");
+    return 1;
+  }
+  fprintf(stderr,"M=%llu threads=%d %.3f s\n",
+          static_cast<unsigned long long>(m),threads,sec);
+  return 0;
 }
-int main(){
+
+
+int main(int argc,char *argv[]){
+  if(argc>1 && strcmp(argv[1],"range")==0){
+    return Range(argc,argv);
+  }
   Callatz();
   return 0;
-}
\ No newline at end of file
+}
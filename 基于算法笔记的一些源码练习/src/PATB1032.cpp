@@ -12,6 +12,16 @@
 #include<algorithm>
 #include<unordered_map>
 
+#include <cstring>
+
+#include "FastIO.h"
+#include "SchoolScoreEngine.h"
+#include "SchoolScoreParallel.h"
+#include "SchoolScoreExternal.h"
+
+// 三种实现共用一个输出缓冲,程序结束时一次写出
+static fastio::Writer out;
+
 void MyLogic(){
 
   // 学生总数
@@ -33,7 +43,8 @@ void MyLogic(){
   // 对容器内序号进行排序
   std::sort(vec_bound_IC.begin(),vec_bound_IC.end(),
         [](const std::pair<int,double> &a,const std::pair<int,double> &b){
-          return a.first <= b.first;
+          // 比较必须是严格弱序,使用<=在大数据量下是未定义行为
+          return a.first < b.first;
         });
 
     
@@ -70,7 +81,11 @@ void MyLogic(){
     best_school = current_school;
   }
   //输出学校ID,学校总成绩
-  printf("School: %d, Score: %f \n",best_school,max_score);
+  out.WriteStr("School: ");
+  out.WriteInt(best_school);
+  out.WriteStr(", Score: ");
+  out.WriteDouble(max_score);
+  out.WriteStr(" \n");
 }
 
 
@@ -105,7 +120,11 @@ void HashMap(){
   }
 
   if(max_score != -1){
-    printf("[Sc So]:[%d %f]\n",best_school,max_score);
+    out.WriteStr("[Sc So]:[");
+    out.WriteInt(best_school);
+    out.WriteChar(' ');
+    out.WriteDouble(max_score);
+    out.WriteStr("]\n");
   }
 
 
@@ -140,11 +159,126 @@ void AnsWer(){
       k = i;
     }
   }
-  printf("%d %f",k,MAX);
+  out.WriteInt(k);
+  out.WriteChar(' ');
+  out.WriteDouble(MAX);
 }
 
 
-int main(int argv,char *argc[]){
+/**
+ * 流式引擎: 从标准输入或文件读取N条记录
+ * 用法: PATB1032 engine [auto|dense|hash|radix] [文件]
+ */
+int Engine(int argc,char *argv[]){
+  school::Strategy strategy = school::Strategy::Auto;
+  const char *path = nullptr;
+  for(int i=2;i<argc;i++){
+    if(strcmp(argv[i],"dense")==0) strategy = school::Strategy::Dense;
+    else if(strcmp(argv[i],"hash")==0) strategy = school::Strategy::Hash;
+    else if(strcmp(argv[i],"radix")==0) strategy = school::Strategy::Radix;
+    else if(strcmp(argv[i],"auto")!=0) path = argv[i];
+  }
+
+  int fd = 0;
+  if(path){
+    fd = open(path,O_RDONLY);
+    if(fd<0){
+      perror(path);
+      return 1;
+    }
+  }
+  school::Result result;
+  {
+    fastio::Reader in(fd);
+    result = school::AggregateStream(in,strategy);
+  }
+  if(fd>0) close(fd);
+
+  school::WriteResult(out,result);
+  return 0;
+}
+
+
+/**
+ * 多线程模式: 每个线程私有稠密数组,树形归约后SIMD求最大
+ * 用法: PATB1032 parallel [线程数] [文件]
+ * 只给一个参数时,全为数字视为线程数,否则视为文件;不给文件时读标准输入.
+ * 编号不适合稠密数组或输入不是普通文件时退回单线程引擎
+ */
+int Parallel(int argc,char *argv[]){
+  int threads = static_cast<int>(std::thread::hardware_concurrency());
+  const char *path = nullptr;
+  if(argc>3){
+    threads = atoi(argv[2]);
+    path = argv[3];
+  }else if(argc>2){
+    const char *arg = argv[2];
+    bool digits = *arg!='\0';
+    for(const char *c=arg;*c;c++) digits = digits && *c>='0' && *c<='9';
+    if(digits) threads = atoi(arg);
+    else path = arg;
+  }
+  if(threads<1) threads = 1;
+
+  int fd = path ? open(path,O_RDONLY) : 0;
+  if(fd<0){
+    perror(path);
+    return 1;
+  }
+  school::Result result;
+  if(!school::AggregateFileParallel(fd,threads,&result)){
+    lseek(fd,0,SEEK_SET);
+    fastio::Reader in(fd);
+    result = school::AggregateStream(in);
+  }
+  if(fd>0) close(fd);
+
+  school::WriteResult(out,result);
+  return 0;
+}
+
+
+/**
+ * 外存模式: 内存预算内哈希分区溢出到临时文件,逐分区聚合后合并最大值
+ * 用法: PATB1032 external 预算MB [文件]
+ * 溢出目录取环境变量TMPDIR(默认/tmp),进度输出到标准错误
+ */
+int External(int argc,char *argv[]){
+  school::ExternalOptions options;
+  const char *path = nullptr;
+  if(argc>2) options.memory_budget = static_cast<size_t>(atoll(argv[2]))<<20;
+  if(argc>3) path = argv[3];
+  if(options.memory_budget==0) options.memory_budget = size_t(1)<<20;
+  const char *tmp = getenv("TMPDIR");
+  if(tmp && *tmp) options.temp_dir = tmp;
+
+  int fd = path ? open(path,O_RDONLY) : 0;
+  if(fd<0){
+    perror(path);
+    return 1;
+  }
+  school::Result result;
+  {
+    fastio::Reader in(fd);
+    result = school::AggregateExternal(in,options,school::PrintProgress);
+  }
+  if(fd>0) close(fd);
+
+  school::WriteResult(out,result);
+  return 0;
+}
+
+
+int main(int argc,char *argv[]){
+  if(argc>1 && strcmp(argv[1],"engine")==0){
+    return Engine(argc,argv);
+  }
+  if(argc>1 && strcmp(argv[1],"parallel")==0){
+    return Parallel(argc,argv);
+  }
+  if(argc>1 && strcmp(argv[1],"external")==0){
+    return External(argc,argv);
+  }
   MyLogic();
   HashMap();
   AnsWer();
@@ -12,53 +12,18 @@
 */
 #include <iostream>
 
+#include "FastIO.h"
+#include "SquareCanvas.h"
+
+// 读入任意多组"边长 字符",全部画进同一块缓冲后一次写出
 void Squre(){
-  int i;char j;
+  fastio::Reader in;
+  canvas::Canvas out;
+  long long i;char j;
   // 输入数字与符号
-  std::cin>> i >> j;
-
-  // 偶数列
-  if(i%2==0)
-  {
-    for(int a=0;a<i;a++){
-      printf("%c",j);
-    }
-    printf("\n");
-    for(int a=2;a<i/2;a++){
-      
-      printf("%c",j);
-
-      for(int b = 0;b<i-2;b++){
-        printf(" ");
-      }
-      printf("%c\n",j);
-    }
-    for(int a=0;a<i;a++){
-      printf("%c",j);
-    }
-    printf("\n");
-  }else{
-    for(int a=0;a<i;a++){
-      printf("%c",j);
-    }
-    printf("\n");
-    for(int a=2;a<i/2+1;a++){
-      printf("%c",j);
-      for(int b = 0;b<i-2;b++){
-        printf(" ");
-      }
-      printf("%c\n",j);
-
-    }
-    for(int a=0;a<i;a++){
-      printf("%c",j);
-    }
-    printf("\n");
-  } 
-
-
-
-
+  while(in.ReadLong(i) && in.ReadChar(j)){
+    out.AddSquare(i,j);
+  }
 }
 
 
@@ -67,4 +32,4 @@ int main(){
   Squre();
 
   return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,425 @@
+/**
+ * PATB1032 三种实现(排序/哈希表/稠密数组)与流式引擎各策略的对比测试
+ *
+ * 数据: 学校编号 稠密(1..S) / 稀疏(随机63位),学校规模 均匀 / Zipf(s=1),
+ *       每校平均记录数 2 / 10 / 100,记录数N从10^3到10^max
+ *       (默认10^7,内存足够时可指定8),学校数S=N/每校记录数.
+ * 流式引擎的 dense/hash/radix 三种策略各自强制运行一遍,再运行auto,
+ * 用来检验 ScoreAggregator 的Auto判据(编号在稠密范围内用Dense,否则Hash,
+ * 不选Radix)与实测交叉点是否吻合: auto所选策略强制运行的耗时超过
+ * 最快强制策略的kAutoTolerance倍,或任一实现结果不一致时,程序以1退出.
+ * (比较的是同一组强制测量,不受auto与强制运行之间的测量抖动影响.)
+ * 每个策略在fork出的子进程里运行,报告:
+ *   单次耗时(小N时重复多次取平均,引擎策略取kEngineRuns轮中最快一轮)、
+ *   峰值RSS增量、缓存未命中数
+ *   (perf_event_open可用时,否则为NA).
+ * 所有策略结果必须一致(并列取编号最小),否则标记mismatch.
+ *
+ * 输出: 明细CSV写到文件,标准输出打印两张交叉点表:
+ *   每种数据下各N最快的实现;
+ *   auto所选策略与最快强制策略的耗时之比、auto选中的策略与实测最快的
+ *   引擎策略(超出容差时标*).
+ *
+ * 编译: g++ -O2 -o SchoolScoreBench SchoolScoreBench.cpp
+ * 运行: ./SchoolScoreBench [最大指数] [CSV路径]   (默认 7 school_bench.csv)
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "SchoolScoreEngine.h"
+
+namespace {
+
+// auto所选策略的耗时允许超出最快强制策略的比例;另加绝对余量,
+// 避免N=10^3时几微秒的抖动被判为失败
+const double kAutoTolerance = 1.25;
+const double kAutoSlackMs = 0.01;
+// 引擎各策略测量的轮数,取最快一轮(单核机器上同一代码两次运行可差30%以上)
+const int kEngineRuns = 3;
+
+struct Answer {
+  long long school = -1;
+  double score = -1;
+  // 流式引擎实际使用的策略(auto时为Decide的选择)
+  school::Strategy strategy = school::Strategy::Auto;
+};
+
+// ---- 被测策略,与PATB1032.cpp中的三种写法对应 ----
+
+// MyLogic: 绑定成pair后按编号排序,顺序扫描累加
+Answer SortBased(const std::vector<school::Record> &recs) {
+  std::vector<std::pair<long long, double>> v;
+  v.reserve(recs.size());
+  for (const school::Record &r : recs) v.emplace_back(r.id, r.score);
+  std::sort(v.begin(), v.end(),
+            [](const std::pair<long long, double> &a,
+               const std::pair<long long, double> &b) {
+              return a.first < b.first;
+            });
+  Answer best;
+  size_t i = 0;
+  while (i < v.size()) {
+    long long id = v[i].first;
+    double sum = 0;
+    for (; i < v.size() && v[i].first == id; ++i) sum += v[i].second;
+    if (best.school < 0 || sum > best.score) {
+      best.school = id;
+      best.score = sum;
+    }
+  }
+  return best;
+}
+
+// HashMap: unordered_map累加后扫描
+Answer UnorderedMap(const std::vector<school::Record> &recs) {
+  std::unordered_map<long long, double> total;
+  for (const school::Record &r : recs) total[r.id] += r.score;
+  Answer best;
+  for (const auto &kv : total)
+    if (best.school < 0 || kv.second > best.score ||
+        (kv.second == best.score && kv.first < best.school)) {
+      best.school = kv.first;
+      best.score = kv.second;
+    }
+  return best;
+}
+
+// AnsWer: 编号即下标的数组(只适用于稠密编号)
+Answer DenseArray(const std::vector<school::Record> &recs, long long max_id) {
+  std::vector<double> total(max_id + 1, 0.0);
+  for (const school::Record &r : recs) total[r.id] += r.score;
+  Answer best;
+  for (long long i = 0; i <= max_id; i++)
+    if (total[i] > best.score) {
+      best.school = i;
+      best.score = total[i];
+    }
+  return best;
+}
+
+// 流式引擎(指定策略,或auto自动选择)
+Answer Engine(const std::vector<school::Record> &recs,
+              school::Strategy strategy) {
+  school::ScoreAggregator aggregator(strategy);
+  for (const school::Record &r : recs) aggregator.Add(r.id, r.score);
+  school::Result r = aggregator.Finish();
+  return Answer{r.school, r.score, r.strategy};
+}
+
+enum Kernel {
+  kSort,
+  kUnorderedMap,
+  kDense,
+  kEngineDense,
+  kEngineHash,
+  kEngineRadix,
+  kEngineAuto,
+  kKernelCount
+};
+const char *const kKernelName[] = {"sort",        "unordered_map", "dense",
+                                   "engine-dense", "engine-hash",  "engine-radix",
+                                   "engine-auto"};
+
+// ---- 数据生成 ----
+
+struct Dataset {
+  bool sparse;
+  bool zipf;
+  long long per_school;
+  long long n;
+  long long max_id;
+  std::vector<school::Record> recs;
+};
+
+void Generate(Dataset *d) {
+  const long long schools = std::max(1LL, d->n / d->per_school);
+  std::mt19937_64 rng(1032 + d->n);
+
+  // 第k所学校的编号
+  std::vector<long long> ids(schools);
+  for (long long k = 0; k < schools; k++)
+    ids[k] = d->sparse ? static_cast<long long>(rng() >> 1) : k + 1;
+  d->max_id = d->sparse ? 0 : schools;
+
+  // Zipf: 第k所学校的概率与1/(k+1)成正比,按累积分布二分查找
+  std::vector<double> cdf;
+  if (d->zipf) {
+    cdf.resize(schools);
+    double sum = 0;
+    for (long long k = 0; k < schools; k++) {
+      sum += 1.0 / (k + 1);
+      cdf[k] = sum;
+    }
+    for (double &c : cdf) c /= sum;
+  }
+
+  std::uniform_int_distribution<long long> uniform(0, schools - 1);
+  std::uniform_real_distribution<double> unit(0, 1);
+  std::uniform_int_distribution<int> score(0, 100);
+  d->recs.resize(d->n);
+  for (school::Record &r : d->recs) {
+    long long k;
+    if (d->zipf) {
+      k = std::lower_bound(cdf.begin(), cdf.end(), unit(rng)) - cdf.begin();
+      if (k >= schools) k = schools - 1;
+    } else {
+      k = uniform(rng);
+    }
+    r.id = ids[k];
+    r.score = score(rng);
+  }
+}
+
+// ---- 测量 ----
+
+struct Measurement {
+  double ms = 0;             // 单次耗时
+  long long rss_kb = 0;      // 峰值RSS增量
+  long long cache_misses = -1;
+  Answer answer;
+};
+
+int OpenCacheMissCounter() {
+  perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.size = sizeof(attr);
+  attr.config = PERF_COUNT_HW_CACHE_MISSES;
+  attr.disabled = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+}
+
+long long MaxRssKb() {
+  rusage ru;
+  getrusage(RUSAGE_SELF, &ru);
+  return ru.ru_maxrss;
+}
+
+Answer RunKernel(Kernel k, const Dataset &d) {
+  switch (k) {
+    case kSort: return SortBased(d.recs);
+    case kUnorderedMap: return UnorderedMap(d.recs);
+    case kDense: return DenseArray(d.recs, d.max_id);
+    case kEngineDense: return Engine(d.recs, school::Strategy::Dense);
+    case kEngineHash: return Engine(d.recs, school::Strategy::Hash);
+    case kEngineRadix: return Engine(d.recs, school::Strategy::Radix);
+    default: return Engine(d.recs, school::Strategy::Auto);
+  }
+}
+
+// 在子进程里运行,使峰值RSS互不影响
+bool Measure(Kernel k, const Dataset &d, Measurement *m) {
+  int fds[2];
+  if (pipe(fds) != 0) return false;
+  pid_t pid = fork();
+  if (pid < 0) return false;
+  if (pid == 0) {
+    close(fds[0]);
+    Measurement r;
+    long long rss_before = MaxRssKb();
+    int perf = OpenCacheMissCounter();
+    // 小数据重复多次,使总时间可测
+    const long long reps = std::max(1LL, 1000000 / d.n);
+    if (perf >= 0) {
+      ioctl(perf, PERF_EVENT_IOC_RESET, 0);
+      ioctl(perf, PERF_EVENT_IOC_ENABLE, 0);
+    }
+    auto start = std::chrono::steady_clock::now();
+    for (long long i = 0; i < reps; i++) r.answer = RunKernel(k, d);
+    double sec = std::chrono::duration<double>(
+                     std::chrono::steady_clock::now() - start).count();
+    if (perf >= 0) {
+      ioctl(perf, PERF_EVENT_IOC_DISABLE, 0);
+      long long count = 0;
+      if (read(perf, &count, sizeof(count)) == sizeof(count))
+        r.cache_misses = count / reps;
+      close(perf);
+    }
+    r.ms = sec * 1000 / reps;
+    r.rss_kb = MaxRssKb() - rss_before;
+    ssize_t w = write(fds[1], &r, sizeof(r));
+    _exit(w == sizeof(r) ? 0 : 1);
+  }
+  close(fds[1]);
+  ssize_t got = read(fds[0], m, sizeof(*m));
+  close(fds[0]);
+  int status = 0;
+  waitpid(pid, &status, 0);
+  return got == sizeof(*m) && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+// 运行runs轮,保留耗时最短的一轮
+bool MeasureBest(Kernel k, const Dataset &d, int runs, Measurement *m) {
+  bool any = false;
+  for (int i = 0; i < runs; i++) {
+    Measurement r;
+    if (!Measure(k, d, &r)) return false;
+    if (!any || r.ms < m->ms) *m = r;
+    any = true;
+  }
+  return any;
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  int max_exp = argc > 1 ? atoi(argv[1]) : 7;
+  const char *csv_path = argc > 2 ? argv[2] : "school_bench.csv";
+  if (max_exp < 3) max_exp = 3;
+  if (max_exp > 8) max_exp = 8;
+
+  FILE *csv = fopen(csv_path, "w");
+  if (!csv) {
+    perror(csv_path);
+    return 1;
+  }
+  fprintf(csv, "ids,sizes,per_school,n,strategy,ms,peak_rss_kb,cache_misses,"
+               "school,score,picked,ok\n");
+
+  // 交叉点表: [数据种类][指数] -> 最快的实现 / auto的选择与最快的引擎策略
+  const long long kPerSchool[] = {2, 10, 100};
+  std::vector<std::string> rows, engine_rows;
+  int failures = 0;
+  for (int sparse = 0; sparse < 2; sparse++) {
+    for (int zipf = 0; zipf < 2; zipf++) {
+      for (long long per_school : kPerSchool) {
+        char label[32];
+        snprintf(label, sizeof(label), "%s %s x%-3lld",
+                 sparse ? "sparse" : "dense ", zipf ? "zipf   " : "uniform",
+                 per_school);
+        std::string row = label, engine_row = label;
+        for (int e = 3; e <= max_exp; e++) {
+          Dataset d;
+          d.sparse = sparse;
+          d.zipf = zipf;
+          d.per_school = per_school;
+          d.n = 1;
+          for (int i = 0; i < e; i++) d.n *= 10;
+          Generate(&d);
+
+          Answer expect;
+          bool have_expect = false;
+          int fastest = -1, fastest_engine = -1;
+          double fastest_ms = 0, fastest_engine_ms = 0;
+          double kernel_ms[kKernelCount];
+          std::fill(kernel_ms, kernel_ms + kKernelCount, -1.0);
+          school::Strategy picked = school::Strategy::Auto;
+          for (int k = 0; k < kKernelCount; k++) {
+            // 稀疏编号放不进数组;强制dense的引擎会在第一条记录迁移到哈希表
+            if ((k == kDense || k == kEngineDense) && d.sparse) continue;
+            Measurement m;
+            const int runs = k >= kEngineDense ? kEngineRuns : 1;
+            if (!MeasureBest(static_cast<Kernel>(k), d, runs, &m)) {
+              fprintf(stderr, "%s failed at N=%lld\n", kKernelName[k], d.n);
+              continue;
+            }
+            if (!have_expect) {
+              expect = m.answer;
+              have_expect = true;
+            }
+            bool ok = m.answer.school == expect.school &&
+                      m.answer.score == expect.score;
+            char misses[32] = "NA";
+            if (m.cache_misses >= 0)
+              snprintf(misses, sizeof(misses), "%lld", m.cache_misses);
+            kernel_ms[k] = m.ms;
+            if (k == kEngineAuto) picked = m.answer.strategy;
+            fprintf(csv, "%s,%s,%lld,%lld,%s,%.4f,%lld,%s,%lld,%.0f,%s,%s\n",
+                    sparse ? "sparse" : "dense", zipf ? "zipf" : "uniform",
+                    per_school, d.n, kKernelName[k], m.ms, m.rss_kb, misses,
+                    m.answer.school, m.answer.score,
+                    k == kEngineAuto ? school::StrategyName(picked) : "",
+                    ok ? "ok" : "mismatch");
+            fflush(csv);
+            if (!ok) {
+              fprintf(stderr, "%s mismatch at N=%lld\n", kKernelName[k], d.n);
+              ++failures;
+            }
+            if (fastest < 0 || m.ms < fastest_ms) {
+              fastest = k;
+              fastest_ms = m.ms;
+            }
+            const bool forced = k == kEngineDense || k == kEngineHash ||
+                                k == kEngineRadix;
+            if (forced && (fastest_engine < 0 || m.ms < fastest_engine_ms)) {
+              fastest_engine = k;
+              fastest_engine_ms = m.ms;
+            }
+          }
+          char cell[40];
+          snprintf(cell, sizeof(cell), " %-14s",
+                   fastest >= 0 ? kKernelName[fastest] : "-");
+          row += cell;
+
+          // "所选策略耗时/最快策略耗时 auto选择/最快策略",超出容差时标*
+          const char *best = fastest_engine >= 0
+                                 ? kKernelName[fastest_engine] + strlen("engine-")
+                                 : "-";
+          const char *chose = school::StrategyName(picked);
+          const int chosen = picked == school::Strategy::Dense   ? kEngineDense
+                             : picked == school::Strategy::Hash  ? kEngineHash
+                             : picked == school::Strategy::Radix ? kEngineRadix
+                                                                 : -1;
+          const double chosen_ms = chosen >= 0 ? kernel_ms[chosen] : -1;
+          const double ratio =
+              chosen_ms >= 0 && fastest_engine >= 0 ? chosen_ms / fastest_engine_ms
+                                                    : 0;
+          const bool slow =
+              chosen_ms < 0 || (ratio > kAutoTolerance &&
+                                chosen_ms - fastest_engine_ms > kAutoSlackMs);
+          if (slow) {
+            fprintf(stderr, "%s N=%lld: auto picked %s (%.3f ms), fastest %s %.3f ms\n",
+                    label, d.n, chose, chosen_ms, best, fastest_engine_ms);
+            ++failures;
+          }
+          snprintf(cell, sizeof(cell), " %.2f %s/%s%s", ratio, chose, best,
+                   slow ? "*" : " ");
+          engine_row += cell;
+          while (engine_row.size() < strlen(label) + (e - 2) * 19)
+            engine_row += ' ';
+          fprintf(stderr, "done: %s N=10^%d\n", label, e);
+        }
+        rows.push_back(row);
+        engine_rows.push_back(engine_row);
+      }
+    }
+  }
+  fclose(csv);
+
+  printf("fastest implementation (details in %s)\n", csv_path);
+  printf("%-19s", "data");
+  for (int e = 3; e <= max_exp; e++) printf(" N=10^%-9d", e);
+  printf("\n");
+  for (const std::string &row : rows) printf("%s\n", row.c_str());
+
+  printf("\nengine: picked ms / fastest forced ms, auto picked/fastest forced "
+         "strategy (* = slower than %.2fx)\n",
+         kAutoTolerance);
+  printf("%-19s", "data");
+  for (int e = 3; e <= max_exp; e++) printf(" N=10^%-13d", e);
+  printf("\n");
+  for (const std::string &row : engine_rows) printf("%s\n", row.c_str());
+  if (failures) {
+    printf("\n%d failure(s)\n", failures);
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,337 @@
+/**
+ * PATB1032 外存聚合(仅头文件): 输入远大于内存、学校编号为稀疏64位整数
+ *
+ * 第一遍: 记录先进入内存中的合并哈希表(相同编号就地相加),表(含扩容瞬间)
+ *         将超过预算的3/4时,按编号哈希把表中条目写入P个溢出文件后清空;
+ *         其余1/4预算平分给P个溢出文件的写缓冲.
+ *         如果从未溢出,直接由内存表得出结果.
+ * 第二遍: 释放写缓冲后逐个读取溢出文件,在内存里聚合该分区并求分区最大值,
+ *         所有分区最大值合并即为答案.分区的不同编号数超出预算时
+ *         换哈希种子再分区,子分区的写缓冲只用读缓冲之外剩下的预算.
+ * 任一时刻的主要内存(合并表、写缓冲、读缓冲、分区哈希表)不超过预算.
+ *
+ * 溢出文件创建后立即unlink,进程退出时自动回收.
+ * 溢出文件写出或读回失败(如磁盘写满)时报告错误并以1退出,不会给出缺了分区的结果.
+ */
+#ifndef SCHOOL_SCORE_EXTERNAL_H
+#define SCHOOL_SCORE_EXTERNAL_H
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "FastIO.h"
+#include "SchoolScoreEngine.h"
+
+namespace school {
+
+struct ExternalOptions {
+  // 内存预算(字节)
+  size_t memory_budget = size_t(256) << 20;
+  // 分区数
+  int partitions = 64;
+  // 溢出文件目录
+  std::string temp_dir = "/tmp";
+  // 每读入多少条记录报告一次进度(0表示不报告)
+  long long progress_interval = 10000000;
+};
+
+struct ExternalProgress {
+  const char *phase;       // "scan" 或 "merge"
+  long long records;       // 已读入的记录数
+  long long spilled;       // 已写入溢出文件的条目数
+  int partition;           // merge阶段当前分区
+  int partitions;          // 分区总数
+};
+
+namespace detail {
+
+// 单个分区最多再分区的层数
+const int kMaxRepartitionDepth = 3;
+// 读取溢出文件的缓冲上限
+const size_t kMaxReadBufferBytes = size_t(256) << 10;
+
+inline uint64_t PartitionHash(long long id, uint64_t seed) {
+  uint64_t x = static_cast<uint64_t>(id) ^ seed;
+  x ^= x >> 31;
+  x *= 0x9e3779b97f4a7c15ULL;
+  x ^= x >> 29;
+  return x;
+}
+
+// 溢出文件读写失败: 报告后退出,避免给出缺了分区的错误结果
+[[noreturn]] inline void SpillFailure(const char *what, int err) {
+  errno = err;
+  perror(what);
+  exit(1);
+}
+
+// ForEachRecord的结果
+enum class ReadStatus { Done, Stopped, Failed };
+
+// 一组分区溢出文件
+class SpillSet {
+public:
+  SpillSet(int partitions, const std::string &dir, size_t buffer_bytes)
+      : fds_(partitions, -1), counts_(partitions, 0) {
+    if (buffer_bytes < 4096) buffer_bytes = 4096;
+    for (int i = 0; i < partitions; i++) {
+      std::string tmpl = dir + "/pat1032_spill_XXXXXX";
+      std::vector<char> path(tmpl.begin(), tmpl.end());
+      path.push_back('\0');
+      fds_[i] = mkstemp(path.data());
+      if (fds_[i] < 0) {
+        perror("mkstemp");
+        exit(1);
+      }
+      unlink(path.data());
+      writers_.emplace_back(new fastio::Writer(fds_[i], buffer_bytes));
+    }
+  }
+
+  ~SpillSet() {
+    writers_.clear();
+    for (int fd : fds_)
+      if (fd >= 0) close(fd);
+  }
+
+  SpillSet(const SpillSet &) = delete;
+  SpillSet &operator=(const SpillSet &) = delete;
+
+  int Size() const { return static_cast<int>(fds_.size()); }
+
+  void Write(int partition, long long id, double sum) {
+    Record r{id, sum};
+    fastio::Writer &out = *writers_[partition];
+    out.WriteStr(reinterpret_cast<const char *>(&r), sizeof(r));
+    if (!out.Ok()) SpillFailure("spill write", out.Error());
+    ++counts_[partition];
+  }
+
+  // 刷出并释放写缓冲,之后只能读取.
+  // 每个分区文件的大小必须正好是记录数*sizeof(Record)
+  void Finish() {
+    for (size_t p = 0; p < writers_.size(); p++) {
+      fastio::Writer &out = *writers_[p];
+      if (!out.Flush()) SpillFailure("spill write", out.Error());
+      struct stat st;
+      if (fstat(fds_[p], &st) != 0) SpillFailure("spill fstat", errno);
+      const unsigned long long expect =
+          static_cast<unsigned long long>(counts_[p]) * sizeof(Record);
+      if (static_cast<unsigned long long>(st.st_size) != expect) {
+        fprintf(stderr,
+                "spill partition %zu: %lld bytes on disk, expected %llu\n", p,
+                static_cast<long long>(st.st_size), expect);
+        exit(1);
+      }
+    }
+    writers_.clear();
+  }
+
+  long long Count(int partition) const { return counts_[partition]; }
+
+  // 用buffer_bytes的读缓冲依次回调分区p中的记录.
+  // 回调返回false时提前停止并返回Stopped;read出错(EINTR重试)
+  // 或读到的记录数与写入的不一致时返回Failed,errno说明原因
+  template <typename F>
+  ReadStatus ForEachRecord(int partition, size_t buffer_bytes, F f) const {
+    int fd = fds_[partition];
+    if (lseek(fd, 0, SEEK_SET) < 0) return ReadStatus::Failed;
+    std::vector<Record> buf(buffer_bytes / sizeof(Record) + 1);
+    long long records = 0;
+    while (true) {
+      ssize_t n = read(fd, buf.data(), buf.size() * sizeof(Record));
+      if (n < 0 && errno == EINTR) continue;
+      if (n < 0) return ReadStatus::Failed;
+      if (n == 0) break;
+      size_t k = static_cast<size_t>(n) / sizeof(Record);
+      records += static_cast<long long>(k);
+      for (size_t i = 0; i < k; i++)
+        if (!f(buf[i])) return ReadStatus::Stopped;
+      if (static_cast<size_t>(n) % sizeof(Record)) {
+        lseek(fd, -(n % static_cast<ssize_t>(sizeof(Record))), SEEK_CUR);
+      }
+    }
+    if (records != counts_[partition]) {
+      errno = EIO;
+      return ReadStatus::Failed;
+    }
+    return ReadStatus::Done;
+  }
+
+private:
+  std::vector<int> fds_;
+  std::vector<long long> counts_;
+  std::vector<std::unique_ptr<fastio::Writer>> writers_;
+};
+
+class ExternalAggregator {
+public:
+  ExternalAggregator(const ExternalOptions &options,
+                     std::function<void(const ExternalProgress &)> progress)
+      : options_(options), progress_(progress) {
+    if (options_.partitions < 1) options_.partitions = 1;
+  }
+
+  void Add(long long id, double score) {
+    if (combiner_.PeakBytes() > options_.memory_budget - WriteBufferBytes())
+      SpillCombiner();
+    combiner_.Add(id, score);
+    ++records_;
+    if (options_.progress_interval > 0 &&
+        records_ % options_.progress_interval == 0)
+      Report("scan", 0);
+  }
+
+  Result Finish() {
+    Result result;
+    result.records = records_;
+    result.strategy = Strategy::Hash;
+
+    // 数据全部装得下,不需要外存
+    if (!spills_) {
+      Best best = combiner_.Finish();
+      if (best.valid) {
+        result.school = best.id;
+        result.score = best.score;
+      }
+      return result;
+    }
+
+    SpillCombiner();
+    spills_->Finish();
+    Best best;
+    for (int p = 0; p < spills_->Size(); p++) {
+      Report("merge", p);
+      best.Merge(AggregatePartition(*spills_, p, 1));
+    }
+    spills_.reset();
+    if (best.valid) {
+      result.school = best.id;
+      result.score = best.score;
+    }
+    return result;
+  }
+
+private:
+  void SpillCombiner() {
+    if (!spills_) {
+      spills_.reset(new SpillSet(options_.partitions, options_.temp_dir,
+                                 WriteBufferBytes() / options_.partitions));
+    }
+    const int partitions = spills_->Size();
+    combiner_.ForEach([&](long long id, double sum) {
+      spills_->Write(static_cast<int>(PartitionHash(id, 0) % partitions), id,
+                     sum);
+      ++spilled_;
+    });
+    combiner_.Clear();
+  }
+
+  // 第一遍的写缓冲共占预算的1/4
+  size_t WriteBufferBytes() const { return options_.memory_budget / 4; }
+
+  // 读缓冲取预算的1/8,不超过kMaxReadBufferBytes
+  size_t ReadBufferBytes() const {
+    size_t bytes = options_.memory_budget / 8;
+    if (bytes > kMaxReadBufferBytes) bytes = kMaxReadBufferBytes;
+    return bytes < 4096 ? 4096 : bytes;
+  }
+
+  // 聚合一个分区;不同编号数超出预算时换种子再分区.
+  // 上层的写缓冲都已释放,本层可用读缓冲之外的全部预算
+  Best AggregatePartition(const SpillSet &set, int p, int depth) {
+    const size_t read_bytes = ReadBufferBytes();
+    const size_t available = options_.memory_budget > read_bytes
+                                 ? options_.memory_budget - read_bytes
+                                 : 0;
+    const bool can_split = depth <= kMaxRepartitionDepth;
+    {
+      // 每轮溢出前已按编号合并,同一编号在分区里每轮出现一次,
+      // 记录数只是不同编号数的上界;按表的实际条目数判断是否装得下
+      HashTable table;
+      auto add = [&](const Record &r) {
+        if (can_split && table.PeakBytes() > available) return false;
+        table.Add(r.id, r.score);
+        return true;
+      };
+      ReadStatus status = set.ForEachRecord(p, read_bytes, add);
+      if (status == ReadStatus::Failed) SpillFailure("spill read", errno);
+      if (status == ReadStatus::Done) return table.Finish();
+    }
+
+    const int sub = options_.partitions;
+    SpillSet children(sub, options_.temp_dir, available / sub);
+    const uint64_t seed = 0x5bd1e995ULL * static_cast<uint64_t>(depth);
+    ReadStatus status = set.ForEachRecord(p, read_bytes, [&](const Record &r) {
+      children.Write(static_cast<int>(PartitionHash(r.id, seed) % sub), r.id,
+                     r.score);
+      return true;
+    });
+    if (status != ReadStatus::Done) SpillFailure("spill read", errno);
+    children.Finish();
+    Best best;
+    for (int c = 0; c < sub; c++)
+      best.Merge(AggregatePartition(children, c, depth + 1));
+    return best;
+  }
+
+  void Report(const char *phase, int partition) {
+    if (!progress_) return;
+    ExternalProgress progress;
+    progress.phase = phase;
+    progress.records = records_;
+    progress.spilled = spilled_;
+    progress.partition = partition;
+    progress.partitions = spills_ ? spills_->Size() : 0;
+    progress_(progress);
+  }
+
+  ExternalOptions options_;
+  std::function<void(const ExternalProgress &)> progress_;
+  HashTable combiner_;
+  std::unique_ptr<SpillSet> spills_;
+  long long records_ = 0;
+  long long spilled_ = 0;
+};
+
+}  // namespace detail
+
+// 从输入流读取"N + N行记录",在内存预算内完成聚合
+inline Result AggregateExternal(
+    fastio::Reader &in, const ExternalOptions &options,
+    std::function<void(const ExternalProgress &)> progress = nullptr) {
+  detail::ExternalAggregator aggregator(options, progress);
+  long long n = 0;
+  if (in.ReadLong(n)) {
+    long long id;
+    double score;
+    for (long long i = 0; i < n && in.ReadLong(id) && in.ReadDouble(score); i++)
+      aggregator.Add(id, score);
+  }
+  return aggregator.Finish();
+}
+
+// 进度输出到标准错误
+inline void PrintProgress(const ExternalProgress &p) {
+  if (p.phase[0] == 's') {
+    fprintf(stderr, "[scan] records %lld, spilled entries %lld\n", p.records,
+            p.spilled);
+  } else {
+    fprintf(stderr, "[merge] partition %d/%d\n", p.partition + 1,
+            p.partitions);
+  }
+}
+
+}  // namespace school
+
+#endif  // SCHOOL_SCORE_EXTERNAL_H
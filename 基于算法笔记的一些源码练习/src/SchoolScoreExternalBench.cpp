@@ -0,0 +1,116 @@
+/**
+ * SchoolScoreExternal.h 吞吐量与内存预算的关系
+ *
+ * 生成稀疏64位学校编号的输入文件,在不同内存预算下做外存聚合,
+ * 输出每个预算的耗时、吞吐量(MB/s与记录/秒)、溢出条目数,并与纯内存哈希表对照.
+ *
+ * 编译: g++ -O2 -o SchoolScoreExternalBench SchoolScoreExternalBench.cpp
+ * 运行: ./SchoolScoreExternalBench [N] [不同编号数] [预算MB...]
+ *       (默认N=5*10^6,不同编号数=10^6,预算 1 4 16 64 256)
+ */
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "FastIO.h"
+#include "SchoolScoreEngine.h"
+#include "SchoolScoreExternal.h"
+
+namespace {
+
+double Seconds(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+// 生成测试输入: distinct个随机64位编号,每条记录随机取一个
+void Generate(const char *path, long long n, long long distinct) {
+  std::mt19937_64 rng(1032);
+  std::vector<long long> ids(distinct);
+  for (long long &id : ids)
+    id = static_cast<long long>(rng() >> 2) + 1000000000LL;
+  std::uniform_int_distribution<long long> pick(0, distinct - 1);
+  std::uniform_int_distribution<int> score(0, 100);
+  int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  {
+    fastio::Writer out(fd);
+    out.WriteInt(n);
+    out.WriteChar('\n');
+    for (long long i = 0; i < n; i++) {
+      out.WriteInt(ids[pick(rng)]);
+      out.WriteChar(' ');
+      out.WriteInt(score(rng));
+      out.WriteChar('\n');
+    }
+  }
+  close(fd);
+}
+
+long long FileSize(const char *path) {
+  struct stat st;
+  return stat(path, &st) == 0 ? static_cast<long long>(st.st_size) : 0;
+}
+
+void Report(const char *name, double sec, long long bytes, long long records,
+            long long spilled, const school::Result &r) {
+  printf("%-12s %9.1f ms %8.1f MB/s %8.2f Mrec/s  spilled %10lld   %lld %.0f\n",
+         name, sec * 1000, bytes / sec / 1e6, records / sec / 1e6, spilled,
+         r.school, r.score);
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  long long n = argc > 1 ? atoll(argv[1]) : 5000000;
+  long long distinct = argc > 2 ? atoll(argv[2]) : 1000000;
+  std::vector<long long> budgets;
+  for (int i = 3; i < argc; i++) budgets.push_back(atoll(argv[i]));
+  if (budgets.empty()) budgets = {1, 4, 16, 64, 256};
+
+  const char *path = "/tmp/school_external_bench.txt";
+  Generate(path, n, distinct);
+  const long long bytes = FileSize(path);
+  printf("N=%lld distinct=%lld input=%.1f MB\n", n, distinct, bytes / 1e6);
+
+  // 对照: 不限内存的哈希表
+  {
+    int fd = open(path, O_RDONLY);
+    auto start = std::chrono::steady_clock::now();
+    school::Result r;
+    {
+      fastio::Reader in(fd);
+      r = school::AggregateStream(in, school::Strategy::Hash);
+    }
+    Report("in-memory", Seconds(start), bytes, r.records, 0, r);
+    close(fd);
+  }
+
+  for (long long mb : budgets) {
+    school::ExternalOptions options;
+    options.memory_budget = static_cast<size_t>(mb) << 20;
+    const char *tmp = getenv("TMPDIR");
+    if (tmp && *tmp) options.temp_dir = tmp;
+    long long spilled = 0;
+    auto progress = [&spilled](const school::ExternalProgress &p) {
+      spilled = p.spilled;
+    };
+    options.progress_interval = 1 << 20;
+
+    int fd = open(path, O_RDONLY);
+    auto start = std::chrono::steady_clock::now();
+    school::Result r;
+    {
+      fastio::Reader in(fd);
+      r = school::AggregateExternal(in, options, progress);
+    }
+    char name[32];
+    snprintf(name, sizeof(name), "budget %lldM", mb);
+    Report(name, Seconds(start), bytes, r.records, spilled, r);
+    close(fd);
+  }
+
+  remove(path);
+  return 0;
+}
@@ -0,0 +1,304 @@
+/**
+ * PATB1032 多线程分片聚合(仅头文件)
+ *
+ * 输入文件mmap后按换行边界切成与线程数相同的分片,每个线程把自己分片里的
+ * 记录累加进私有的稠密数组,线程之间没有共享写入和原子操作.
+ * 各线程的部分和按二叉树两两合并,最后用SIMD(AVX2/SSE4.2,运行时检测)
+ * 找出最大值及其最小下标.
+ *
+ * 成绩按 kScoreScale 定点化为整数累加,整数加法满足结合律,
+ * 因此结果与线程数、分片方式无关,完全确定.
+ * 与单线程引擎一样只聚合首行给出的N条记录: 各分片先全部累加并计数,
+ * 总数超过N时丢弃第N条之后的分片,跨过第N条的分片再只累加到第N条为止.
+ * 编号为负或超出稠密范围、成绩无法解析时返回false,由调用方退回单线程引擎.
+ *
+ * 编译需要 -pthread.
+ */
+#ifndef SCHOOL_SCORE_PARALLEL_H
+#define SCHOOL_SCORE_PARALLEL_H
+
+#include <climits>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SCHOOL_SCORE_X86 1
+#endif
+
+#include "SchoolScoreEngine.h"
+
+namespace school {
+
+// 成绩定点化精度: 保留6位小数
+const int64_t kScoreScale = 1000000;
+
+namespace detail {
+
+// 从[p,end)解析一个整数,跳过前导空白
+inline bool ParseId(const char *&p, const char *end, long long &x) {
+  while (p < end && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t')) ++p;
+  if (p == end) return false;
+  bool neg = false;
+  if (*p == '-') {
+    neg = true;
+    ++p;
+  }
+  if (p == end || *p < '0' || *p > '9') return false;
+  long long v = 0;
+  while (p < end && *p >= '0' && *p <= '9') v = v * 10 + (*p++ - '0');
+  x = neg ? -v : v;
+  return true;
+}
+
+// 直接把十进制文本解析成定点整数,避免经过double
+inline bool ParseScore(const char *&p, const char *end, int64_t &x) {
+  while (p < end && (*p == ' ' || *p == '\t')) ++p;
+  if (p == end) return false;
+  bool neg = false;
+  if (*p == '-') {
+    neg = true;
+    ++p;
+  }
+  int64_t v = 0;
+  bool any = false;
+  while (p < end && *p >= '0' && *p <= '9') {
+    v = v * 10 + (*p++ - '0');
+    any = true;
+  }
+  v *= kScoreScale;
+  if (p < end && *p == '.') {
+    ++p;
+    int64_t unit = kScoreScale / 10;
+    while (p < end && *p >= '0' && *p <= '9') {
+      v += (*p++ - '0') * unit;
+      unit /= 10;
+      any = true;
+    }
+  }
+  x = neg ? -v : v;
+  return any;
+}
+
+// 单个线程的私有部分和
+struct Partial {
+  std::vector<int64_t> sums;
+  std::vector<unsigned char> seen;
+  long long records = 0;
+  bool ok = true;
+
+  void Add(long long id, int64_t score) {
+    if (id >= static_cast<long long>(sums.size())) {
+      size_t n = sums.empty() ? 1024 : sums.size();
+      while (static_cast<long long>(n) <= id) n *= 2;
+      sums.resize(n, 0);
+      seen.resize(n, 0);
+    }
+    sums[id] += score;
+    seen[id] = 1;
+    ++records;
+  }
+
+  // 把o合并进来
+  void Merge(const Partial &o) {
+    if (o.sums.size() > sums.size()) {
+      sums.resize(o.sums.size(), 0);
+      seen.resize(o.sums.size(), 0);
+    }
+    for (size_t i = 0; i < o.sums.size(); i++) {
+      sums[i] += o.sums[i];
+      seen[i] |= o.seen[i];
+    }
+    records += o.records;
+    ok = ok && o.ok;
+  }
+};
+
+// 累加[p,end)中最多limit条记录
+inline void AccumulateRange(const char *p, const char *end, long long limit,
+                            Partial *out) {
+  long long id;
+  int64_t score;
+  while (out->records < limit && ParseId(p, end, id)) {
+    if (!DenseTable::Fits(id) || !ParseScore(p, end, score)) {
+      out->ok = false;
+      return;
+    }
+    out->Add(id, score);
+  }
+}
+
+// ---- 最大值/首个下标 内核 ----
+
+inline int64_t MaxScalar(const int64_t *a, size_t n) {
+  int64_t m = INT64_MIN;
+  for (size_t i = 0; i < n; i++)
+    if (a[i] > m) m = a[i];
+  return m;
+}
+
+inline size_t FindFirstScalar(const int64_t *a, size_t n, int64_t value) {
+  for (size_t i = 0; i < n; i++)
+    if (a[i] == value) return i;
+  return n;
+}
+
+#ifdef SCHOOL_SCORE_X86
+__attribute__((target("avx2"))) inline int64_t MaxAvx2(const int64_t *a,
+                                                        size_t n) {
+  __m256i m = _mm256_set1_epi64x(INT64_MIN);
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i));
+    m = _mm256_blendv_epi8(m, v, _mm256_cmpgt_epi64(v, m));
+  }
+  alignas(32) int64_t lanes[4];
+  _mm256_store_si256(reinterpret_cast<__m256i *>(lanes), m);
+  int64_t best = MaxScalar(lanes, 4);
+  int64_t tail = MaxScalar(a + i, n - i);
+  return tail > best ? tail : best;
+}
+
+__attribute__((target("avx2"))) inline size_t FindFirstAvx2(const int64_t *a,
+                                                             size_t n,
+                                                             int64_t value) {
+  const __m256i target = _mm256_set1_epi64x(value);
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i));
+    int mask = _mm256_movemask_pd(
+        _mm256_castsi256_pd(_mm256_cmpeq_epi64(v, target)));
+    if (mask) return i + __builtin_ctz(mask);
+  }
+  return i + FindFirstScalar(a + i, n - i, value);
+}
+
+__attribute__((target("sse4.2"))) inline int64_t MaxSse42(const int64_t *a,
+                                                           size_t n) {
+  __m128i m = _mm_set1_epi64x(INT64_MIN);
+  size_t i = 0;
+  for (; i + 2 <= n; i += 2) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i));
+    m = _mm_blendv_epi8(m, v, _mm_cmpgt_epi64(v, m));
+  }
+  alignas(16) int64_t lanes[2];
+  _mm_store_si128(reinterpret_cast<__m128i *>(lanes), m);
+  int64_t best = MaxScalar(lanes, 2);
+  int64_t tail = MaxScalar(a + i, n - i);
+  return tail > best ? tail : best;
+}
+#endif
+
+// 返回最大值的最小下标(n为0时返回n)
+inline size_t ArgMax(const int64_t *a, size_t n) {
+  if (n == 0) return 0;
+#ifdef SCHOOL_SCORE_X86
+  if (__builtin_cpu_supports("avx2")) {
+    return FindFirstAvx2(a, n, MaxAvx2(a, n));
+  }
+  if (__builtin_cpu_supports("sse4.2")) {
+    return FindFirstScalar(a, n, MaxSse42(a, n));
+  }
+#endif
+  return FindFirstScalar(a, n, MaxScalar(a, n));
+}
+
+}  // namespace detail
+
+// 对[data, data+size)中的"N + 记录"文本做多线程聚合
+inline bool AggregateParallel(const char *data, size_t size, int threads,
+                              Result *result) {
+  if (threads < 1) threads = 1;
+  const char *begin = data, *end = data + size;
+
+  // 第一行的记录数
+  long long n = 0;
+  if (!detail::ParseId(begin, end, n) || n < 0) return false;
+  while (begin < end && *begin != '\n') ++begin;
+
+  // 按换行边界切分
+  std::vector<const char *> cuts(threads + 1, end);
+  cuts[0] = begin;
+  for (int t = 1; t < threads; t++) {
+    const char *p = begin + (end - begin) * t / threads;
+    if (p < cuts[t - 1]) p = cuts[t - 1];
+    while (p < end && *p != '\n') ++p;
+    cuts[t] = p;
+  }
+
+  std::vector<detail::Partial> partials(threads);
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; t++)
+    workers.emplace_back(detail::AccumulateRange, cuts[t], cuts[t + 1],
+                         LLONG_MAX, &partials[t]);
+  for (std::thread &w : workers) w.join();
+
+  // 只保留前N条记录: 之后的分片不参与归约,跨过第N条的分片重新累加
+  int used = 0;
+  long long before = 0;
+  while (used < threads && before + partials[used].records <= n) {
+    if (!partials[used].ok) return false;
+    before += partials[used++].records;
+  }
+  if (used < threads && before < n) {
+    partials[used] = detail::Partial();
+    detail::AccumulateRange(cuts[used], cuts[used + 1], n - before,
+                            &partials[used]);
+    if (!partials[used].ok) return false;
+    ++used;
+  }
+  if (used == 0) {
+    used = 1;
+    partials[0] = detail::Partial();
+  }
+
+  // 树形归约: 每一层内的合并互不相交,可并行执行
+  for (int step = 1; step < used; step *= 2) {
+    workers.clear();
+    for (int t = 0; t + step < used; t += 2 * step)
+      workers.emplace_back([&partials, t, step] {
+        partials[t].Merge(partials[t + step]);
+      });
+    for (std::thread &w : workers) w.join();
+  }
+
+  detail::Partial &total = partials[0];
+  if (!total.ok) return false;
+
+  // 没有记录的编号不参与比较
+  for (size_t i = 0; i < total.sums.size(); i++)
+    if (!total.seen[i]) total.sums[i] = INT64_MIN;
+
+  result->records = total.records;
+  result->strategy = Strategy::Dense;
+  size_t best = detail::ArgMax(total.sums.data(), total.sums.size());
+  if (best < total.sums.size() && total.seen[best]) {
+    result->school = static_cast<long long>(best);
+    result->score = static_cast<double>(total.sums[best]) / kScoreScale;
+  }
+  return true;
+}
+
+// mmap文件后并行聚合;不是普通文件或编号不适合稠密数组时返回false
+inline bool AggregateFileParallel(int fd, int threads, Result *result) {
+  struct stat st;
+  if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size == 0)
+    return false;
+  void *p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (p == MAP_FAILED) return false;
+  madvise(p, st.st_size, MADV_SEQUENTIAL);
+  bool ok = AggregateParallel(static_cast<const char *>(p), st.st_size,
+                              threads, result);
+  munmap(p, st.st_size);
+  return ok;
+}
+
+}  // namespace school
+
+#endif  // SCHOOL_SCORE_PARALLEL_H
@@ -0,0 +1,97 @@
+/**
+ * SearchIndex.h 三种策略的交叉点
+ *
+ * 对每个数组规模n与查询数Q,分别测量 linear / eytzinger / hash 的
+ * 构建时间与批量查询时间,输出包含构建在内的每次查询平均耗时和最快策略,
+ * 以及 Index::Choose 给出的选择.查询一半命中、一半不命中.
+ *
+ * 编译: g++ -O2 -o SearchIndexBench SearchIndexBench.cpp
+ * 运行: ./SearchIndexBench [最大n]   (默认2^22)
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "SearchIndex.h"
+
+namespace {
+
+double Seconds(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  size_t max_n = argc > 1 ? strtoull(argv[1], nullptr, 10) : (size_t(1) << 22);
+  std::mt19937 rng(1934);
+  const search::Strategy strategies[] = {search::Strategy::Linear,
+                                         search::Strategy::Eytzinger,
+                                         search::Strategy::Hash};
+
+  printf("%10s %10s %12s %12s %12s   %-10s %-10s\n", "n", "queries",
+         "linear ns/q", "eytz ns/q", "hash ns/q", "fastest", "chosen");
+  for (size_t n = 8; n <= max_n; n *= 4) {
+    // 互不相同的偶数;奇数查询必然不命中
+    std::vector<int> a(n);
+    for (size_t i = 0; i < n; i++) a[i] = static_cast<int>(2 * i);
+    std::shuffle(a.begin(), a.end(), rng);
+
+    const size_t query_counts[] = {n / 16, n, 16 * n};
+    for (size_t q : query_counts) {
+      if (q == 0) continue;
+      // 查询总量太大时只测一部分,按比例折算
+      const size_t run = std::min<size_t>(q, 1 << 22);
+      std::vector<int> queries(run), ans(run);
+      std::uniform_int_distribution<int> pick(0, static_cast<int>(2 * n - 1));
+      for (int &x : queries) x = pick(rng);
+
+      // 前一部分查询的正确答案
+      const size_t checked = std::min<size_t>(run, 256);
+      std::vector<int> want(checked);
+      for (size_t i = 0; i < checked; i++) {
+        size_t k = std::find(a.begin(), a.end(), queries[i]) - a.begin();
+        want[i] = k == n ? -1 : static_cast<int>(k);
+      }
+
+      double cost[3];
+      for (int s = 0; s < 3; s++) {
+        // 线性扫描在n很大时逐次查询太慢,只在可接受时测量
+        if (s == 0 && static_cast<double>(n) * run > 4e9) {
+          cost[s] = -1;
+          continue;
+        }
+        auto start = std::chrono::steady_clock::now();
+        search::Index index(a.data(), n, q, strategies[s]);
+        double build = Seconds(start);
+        start = std::chrono::steady_clock::now();
+        index.FindBatch(queries.data(), ans.data(), run);
+        double query = Seconds(start) * (static_cast<double>(q) / run);
+        cost[s] = (build + query) / q * 1e9;
+
+
+        if (!std::equal(want.begin(), want.end(), ans.begin())) {
+          printf("mismatch: %s n=%zu\n", search::StrategyName(strategies[s]),
+                 n);
+          return 1;
+        }
+      }
+
+      int fastest = -1;
+      for (int s = 0; s < 3; s++)
+        if (cost[s] >= 0 && (fastest < 0 || cost[s] < cost[fastest]))
+          fastest = s;
+      char linear[16];
+      if (cost[0] < 0) snprintf(linear, sizeof(linear), "-");
+      else snprintf(linear, sizeof(linear), "%.1f", cost[0]);
+      printf("%10zu %10zu %12s %12.1f %12.1f   %-10s %-10s\n", n, q, linear,
+             cost[1], cost[2], search::StrategyName(strategies[fastest]),
+             search::StrategyName(search::Index::Choose(n, q)));
+    }
+  }
+  return 0;
+}
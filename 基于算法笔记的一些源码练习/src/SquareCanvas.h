@@ -0,0 +1,114 @@
+/**
+ * PATB1036 方框的缓冲绘制(仅头文件)
+ *
+ * 所有方框先画进一块预先分配的缓冲区,缓冲区满或Flush时用一次write写出.
+ * 每个方框:
+ *   上下两条边各memset一次;
+ *   中间行只构造一行模板(两端字符、中间空格),其余行按 1,2,4,... 行倍增memcpy.
+ * 一个方框比缓冲区还大时按整行分块写出,缓冲区最多扩到两行宽,不随行数增长.
+ *
+ * 用法:
+ *   canvas::Canvas c;  c.AddSquare(10, 'a');  c.AddSquare(5, '#');  c.Flush();
+ */
+#ifndef SQUARE_CANVAS_H
+#define SQUARE_CANVAS_H
+
+#include <cstring>
+#include <vector>
+
+#include <unistd.h>
+
+namespace canvas {
+
+class Canvas {
+public:
+  explicit Canvas(int fd = 1, size_t capacity = 1 << 22)
+      : fd_(fd), buf_(capacity) {}
+
+  ~Canvas() { Flush(); }
+
+  Canvas(const Canvas &) = delete;
+  Canvas &operator=(const Canvas &) = delete;
+
+  // 行数为列数的50%(四舍五入),至少包含上下两条边
+  static long long Rows(long long n) {
+    long long rows = (n + 1) / 2;
+    return rows < 2 ? 2 : rows;
+  }
+
+  // 一个方框输出的字节数
+  static size_t FrameBytes(long long n) {
+    return static_cast<size_t>(Rows(n)) * static_cast<size_t>(n + 1);
+  }
+
+  void AddSquare(long long n, char c) {
+    if (n < 1) return;
+    const size_t width = static_cast<size_t>(n) + 1;  // 含换行
+    if (width * 2 > buf_.size()) buf_.resize(width * 2);
+    if (FrameBytes(n) > buf_.size() - len_) Flush();
+
+    const long long rows = Rows(n);
+    // 上边
+    char *top = Reserve(width);
+    memset(top, c, n);
+    top[n] = '\n';
+
+    // 中间行: 先放一行模板,再在缓冲区内倍增复制
+    long long left = rows - 2;
+    while (left > 0) {
+      size_t room = (buf_.size() - len_) / width;
+      if (room == 0) {
+        Flush();
+        room = buf_.size() / width;
+      }
+      const size_t k = static_cast<size_t>(left) < room
+                           ? static_cast<size_t>(left) : room;
+      char *p = Reserve(k * width);
+      p[0] = c;
+      if (n > 1) {
+        memset(p + 1, ' ', n - 2);
+        p[n - 1] = c;
+      }
+      p[n] = '\n';
+      size_t done = 1;
+      while (done < k) {
+        size_t copy = done < k - done ? done : k - done;
+        memcpy(p + done * width, p, copy * width);
+        done += copy;
+      }
+      left -= static_cast<long long>(k);
+    }
+
+    // 下边
+    if (buf_.size() - len_ < width) Flush();
+    char *bottom = Reserve(width);
+    memset(bottom, c, n);
+    bottom[n] = '\n';
+  }
+
+  // 一次write写出缓冲区(处理被信号打断的部分写入)
+  void Flush() {
+    size_t done = 0;
+    while (done < len_) {
+      ssize_t n = write(fd_, buf_.data() + done, len_ - done);
+      if (n <= 0) break;
+      done += n;
+    }
+    len_ = 0;
+  }
+
+private:
+  char *Reserve(size_t n) {
+    char *p = buf_.data() + len_;
+    len_ += n;
+    return p;
+  }
+
+  int fd_;
+  std::vector<char> buf_;
+  size_t len_ = 0;
+};
+
+}  // namespace canvas
+
+#endif  // SQUARE_CANVAS_H
@@ -17,23 +17,16 @@
 #include<iostream>
 #include<string>
 #include<algorithm>
+#include<vector>
+#include<cstring>
+
+#include "FastIO.h"
+#include "CivilDate.h"
+#include "DateParse.h"
 
 class DateDifference
 {
 private:
-  // 平年闰年枚举
-  // 第一维度表示平年，第二维度表示闰年
-  int date[13][2] = {
-    {0,0},
-    // 1,2,3
-    {31,31},{28,29},{31,31},
-    // 4,5,6
-    {30,30},{31,31},{30,30},
-    // 7,8,9
-    {31,31},{31,31},{30,30},
-    // 10,11,12
-    {31,31},{30,30},{31,31}
-  };
   // 日期输入
   int num1_={},num2_={};
   // 日期相差
@@ -43,43 +36,30 @@ private:
 
   bool leapyear(const int &year);
   public:
-  DateDifference();
-  ~DateDifference();
+  DateDifference() = default;
+  ~DateDifference() = default;
 
   void SetDate(int d1,int d2){
     num1_ = d1;
     num2_ = d2;
   }
 
-  // 运行
-  void Run(){
+  // 运行,返回包含首尾的天数
+  int Run(){
     Calculation();
+    return day_diff_;
   };
 
 public:
 
 };
 
-DateDifference::DateDifference()
-{
-  std::cout<<"Start..."<<std::endl;
-}
-
-DateDifference::~DateDifference()
-{
-  std::cout<<"Ending...."<<std::endl;
-}
+// 逐天推进的参考实现,用来核对常数时间的批量引擎
 void DateDifference::Calculation(){
 
   // 比较输入的两个数的大小(默认num2_大)
   if(num1_> num2_){
-    printf("numbers are :[%d]<->[%d]\n",num1_,num2_);
-    int temp = 0;
-    temp = num1_;
-    num1_ = num2_;
-    num2_ = temp;
-
-    printf("smaller num1_,swap numbers:[%d]<->[%d]\n",num1_,num2_);
+    std::swap(num1_,num2_);
   }
 
   // 计算年月日；
@@ -92,17 +72,13 @@ void DateDifference::Calculation(){
   month2 = (num2_ % 10000)/100;
   day2 = num2_ % 100;
 
-  printf("[%d %d %d];;;;;[%d %d %d]\n",year1,month1,day1,year2,month2,day2);
-  // 判断两个年份的平闰年
-  leapyear(year1);
-  leapyear(year2);
-
-  int num = num1_;
-  // 开始计算，直至num1_递增到与num_2相同
-  if(num != num2_){
+  // 起止两天都计入
+  day_diff_ = 1;
+  // 开始计算，直至日期1递增到与日期2相同
+  while(year1!=year2 || month1!=month2 || day1!=day2){
     day1++;
-    // 闰年
-    if(day1==date[month2][leapyear(year2)]+1){
+    // 超过当月天数(按日期1所在的年月查表)
+    if(day1==civil::kMonthDays[leapyear(year1)][month1]+1){
       month1++;
       day1 = 1;
     }
@@ -114,23 +90,177 @@ void DateDifference::Calculation(){
     day_diff_++;
 
   }
-  printf("out number is: %d \n", day_diff_);
 }
 
 bool DateDifference::leapyear(const int &year){
+  return civil::IsLeap(year);
+}
+
 
-  if(year%4 == 0&&year%100 != 0&&year%3323 !=0||year%400==0){
-    printf("[%d] year is leap year;\n",year);
-    return true;
+// 批量模式共用: 解析出的日期,相邻两个为一组写出包含首尾的天数.
+// 组可以跨越两次Feed(前一半暂存在数组第0位)
+struct DatePairs{
+  // 每次ParseYmdBulk解析的日期数
+  static const size_t kChunk = 1<<17;
+  std::vector<int> y,m,d;
+  std::vector<long long> diff;
+  // 尚未配对的日期数(0或1)
+  size_t carry = 0;
 
-  }else{
-    printf("[%d] year isn't leap year;\n",year);
-    return false;
+  DatePairs():y(kChunk+1),m(kChunk+1),d(kChunk+1),diff(kChunk/2+1){}
+
+  // 解析data[0,size)并写出凑成组的差值,分隔符为','或空白(见DateParse.h).
+  // 返回第一个非法字段的偏移,全部合法时返回size
+  size_t Feed(const char *data,size_t size,fastio::Writer &out){
+    size_t offset = 0;
+    while(offset<size && civil::detail::IsSpace(data[offset])) offset++;
+    while(offset<size){
+      civil::ParseResult r = civil::ParseYmdBulk(data+offset,size-offset,
+                                                 y.data()+carry,m.data()+carry,
+                                                 d.data()+carry,kChunk);
+      const size_t total = carry+r.count;
+      const size_t pairs = total/2;
+      for(size_t i=0;i<pairs;i++){
+        long long t = civil::DaysFromCivil(y[2*i+1],m[2*i+1],d[2*i+1]) -
+                      civil::DaysFromCivil(y[2*i],m[2*i],d[2*i]);
+        diff[i] = (t<0 ? -t : t) + 1;
+      }
+      for(size_t i=0;i<pairs;i++){
+        out.WriteInt(diff[i]);
+        out.WriteChar('\n');
+      }
+      carry = total%2;
+      if(carry){
+        y[0] = y[total-1];
+        m[0] = m[total-1];
+        d[0] = d[total-1];
+      }
+      if(!r.ok){
+        // 末尾多余的空白不算错误
+        size_t rest = offset+r.error_offset;
+        while(rest<size && civil::detail::IsSpace(data[rest])) rest++;
+        return rest<size ? offset+r.error_offset : size;
+      }
+      if(r.count==0) break;
+      offset += r.consumed;
+    }
+    return size;
   }
+};
+
+// 写出失败(如管道关闭、磁盘写满)时报告并返回1
+int FinishOutput(fastio::Writer &out,int ret){
+  if(out.Flush()) return ret;
+  errno = out.Error();
+  perror("write");
+  return 1;
+}
+
+
+/**
+ * 批量模式(普通文件): mmap后用向量化解析直接得到年月日,
+ * 相邻两个日期为一组(每行一个日期或每行"日期1 日期2"均可).遇到非法日期时报告行号并返回1
+ */
+int BatchMapped(int fd,const char *name){
+  struct stat st;
+  if(fstat(fd,&st)!=0 || !S_ISREG(st.st_mode) || st.st_size==0) return -1;
+  void *map = mmap(nullptr,st.st_size,PROT_READ,MAP_PRIVATE,fd,0);
+  if(map==MAP_FAILED) return -1;
+  madvise(map,st.st_size,MADV_SEQUENTIAL);
+  const char *data = static_cast<const char *>(map);
+  size_t size = st.st_size;
+
+  int ret = 0;
+  {
+    fastio::Writer out;
+    DatePairs pairs;
+    const size_t bad = pairs.Feed(data,size,out);
+    if(bad<size){
+      fprintf(stderr,"%s: invalid date at line %zu\n",name,
+              1+static_cast<size_t>(std::count(data,data+bad,'\n')));
+      ret = 1;
+    }
+    ret = FinishOutput(out,ret);
+  }
+  munmap(map,size);
+  return ret;
+}
+
+
+/**
+ * 批量模式(管道等): 按块read进缓冲区,与mmap路径一样用ParseYmdBulk解析,
+ * 分隔符规则相同.每块只解析到最后一个分隔符,被块尾截断的记录留到下一块.
+ * 遇到非法日期时报告行号并返回1
+ */
+int BatchStream(int fd,const char *name){
+  const size_t kBlock = 1<<20;
+  std::vector<char> buf(kBlock);
+  size_t len = 0;
+  // 缓冲区开头所在的行号
+  size_t line = 1;
+  bool eof = false;
+  fastio::Writer out;
+  DatePairs pairs;
+  while(true){
+    while(!eof && len<buf.size()){
+      ssize_t n = read(fd,buf.data()+len,buf.size()-len);
+      if(n<0 && errno==EINTR) continue;
+      if(n<0){
+        perror(name);
+        return 1;
+      }
+      if(n==0) eof = true;
+      len += static_cast<size_t>(n);
+    }
+    size_t end = len;
+    if(!eof){
+      while(end>0 && !civil::detail::IsDelimiter(buf[end-1])) end--;
+      // 整块都没有分隔符,不可能是日期
+      if(end==0) end = len;
+    }
+    const size_t bad = pairs.Feed(buf.data(),end,out);
+    if(bad<end){
+      fprintf(stderr,"%s: invalid date at line %zu\n",name,
+              line+static_cast<size_t>(std::count(buf.data(),buf.data()+bad,'\n')));
+      return FinishOutput(out,1);
+    }
+    line += static_cast<size_t>(std::count(buf.data(),buf.data()+end,'\n'));
+    memmove(buf.data(),buf.data()+end,len-end);
+    len -= end;
+    if(eof) break;
+  }
+  return FinishOutput(out,0);
+}
+
+
+/**
+ * 批量模式: 读入任意多组"日期1 日期2"(YYYYMMDD),每组输出一行差值
+ * 用法: codeup1928 batch [文件]
+ * 标准输入或文件是普通文件时mmap,否则按块读取;两条路径分隔符规则相同
+ * (','或空白),遇到不存在的日期(如20201301)或非日期字段时报告行号并返回1
+ */
+int Batch(int argc,char *argv[]){
+  int fd = 0;
+  const char *name = "stdin";
+  if(argc>2){
+    name = argv[2];
+    fd = open(name,O_RDONLY);
+    if(fd<0){
+      perror(name);
+      return 1;
+    }
+  }
+  int ret = BatchMapped(fd,name);
+  if(ret<0) ret = BatchStream(fd,name);
+  if(fd>0) close(fd);
+  return ret;
 }
 
 
 int main(int argc,char *argv[]){
+  if(argc>1 && strcmp(argv[1],"batch")==0){
+    return Batch(argc,argv);
+  }
 
   DateDifference date;
 
@@ -139,6 +269,12 @@ int main(int argc,char *argv[]){
   int n2 = 20140105;
 
   date.SetDate(n1,n2);
-  date.Run();
+  fastio::Writer out;
+  out.WriteStr("out number is: ");
+  out.WriteInt(date.Run());
+  out.WriteStr(" \n");
+  out.WriteStr("days-from-civil: ");
+  out.WriteInt(civil::InclusiveDifference(n1,n2));
+  out.WriteStr(" \n");
   return 0;
-}
\ No newline at end of file
+}
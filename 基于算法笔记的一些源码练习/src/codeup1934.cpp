@@ -10,26 +10,73 @@
  */
 
 #include<iostream>
+#include<vector>
+#include<cstring>
 
+#include "FastIO.h"
+#include "SearchIndex.h"
+
+// 多组数据: 每组"n n个数 x",输出x的下标或-1
 void getIndex(){
-  int N[] = {18,15,1,2,4,39,20,47,3,33};
-  int n = sizeof(N)/sizeof(int);
-  int k;
+  fastio::Reader in;
+  fastio::Writer out;
+  std::vector<int> N;
+  int n;
   int x;
-  std::cin >> x;
-  for(k=0;k<n;k++){
-    if(x==N[k]){
-      printf("x in arr-index is: %d,and input x-number is: %d \n",k,x);
-      break;
-    }
+  while(in.ReadInt(n) && n>=0){
+    N.resize(n);
+    for(int k=0;k<n;k++) in.ReadInt(N[k]);
+    if(!in.ReadInt(x)) break;
+    // 每组只查询一次,按规模会选到线性扫描
+    search::Index index(N.data(),N.size(),1);
+    out.WriteInt(index.Find(x));
+    out.WriteChar('\n');
+  }
+}
+
 
+/**
+ * 批量模式: 一个数组,大量查询
+ * 输入: n, n个数, m, m个查询;每个查询输出一行下标
+ * 用法: codeup1934 batch [linear|eytzinger|hash] < 输入
+ */
+int Batch(int argc,char *argv[]){
+  search::Strategy strategy = search::Strategy::Auto;
+  if(argc>2){
+    if(strcmp(argv[2],"linear")==0) strategy = search::Strategy::Linear;
+    else if(strcmp(argv[2],"eytzinger")==0) strategy = search::Strategy::Eytzinger;
+    else if(strcmp(argv[2],"hash")==0) strategy = search::Strategy::Hash;
   }
-  if(k==n){
-    printf("%d \n",-1);
+  fastio::Reader in;
+  fastio::Writer out;
+  int n=0,m=0;
+  if(!in.ReadInt(n) || n<0) return 1;
+  std::vector<int> a(n);
+  for(int i=0;i<n;i++) in.ReadInt(a[i]);
+  if(!in.ReadInt(m) || m<0) m = 0;
+  std::vector<int> q(m),ans(m);
+  for(int i=0;i<m;i++) in.ReadInt(q[i]);
+
+  search::Index index(a.data(),a.size(),q.size(),strategy);
+  index.FindBatch(q.data(),ans.data(),q.size());
+
+  for(int i=0;i<m;i++){
+    out.WriteInt(ans[i]);
+    out.WriteChar('\n');
+  }
+  if(!out.Flush()){
+    errno = out.Error();
+    perror("write");
+    return 1;
   }
+  return 0;
 }
-int main(){
 
+
+int main(int argc,char *argv[]){
+  if(argc>1 && strcmp(argv[1],"batch")==0){
+    return Batch(argc,argv);
+  }
   getIndex();
   return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,109 @@
+// 大栅格上A*与跳点搜索的耗时
+//
+// 生成边长为size的空地图与随机障碍地图(障碍率density),各跑queries个随机起终点,
+// 分别用A*与JPS规划,输出每次查询的平均耗时、平均扩展节点数,
+// 并核对两者的路径代价一致、路径连续且不穿障碍.
+//
+// 用法: astar_bench [边长] [查询数] [障碍率]   (默认 10000 20 0.2)
+
+#include "a_star.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace {
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+        .count();
+}
+
+struct Query {
+    int sx, sy, gx, gy;
+};
+
+// 路径相邻两格八邻接、不穿拐角、不经障碍
+bool validPath(const GridMap& map, const std::vector<std::pair<int, int>>& path) {
+    for (size_t i = 0; i < path.size(); i++) {
+        if (map.isObstacle(path[i].first, path[i].second)) return false;
+        if (i == 0) continue;
+        const int dx = path[i].first - path[i - 1].first;
+        const int dy = path[i].second - path[i - 1].second;
+        if (std::abs(dx) > 1 || std::abs(dy) > 1 || (dx == 0 && dy == 0)) return false;
+        if (dx != 0 && dy != 0 &&
+            (map.isObstacle(path[i - 1].first + dx, path[i - 1].second) ||
+             map.isObstacle(path[i - 1].first, path[i - 1].second + dy)))
+            return false;
+    }
+    return true;
+}
+
+bool run(const char* name, AStar& planner, const std::vector<Query>& queries) {
+    double seconds[2] = {0, 0};
+    size_t expanded[2] = {0, 0};
+    int found = 0;
+    bool ok = true;
+    for (const Query& q : queries) {
+        double cost[2];
+        for (int mode = 0; mode < 2; mode++) {
+            planner.setSearchMode(mode ? SearchMode::JumpPoint : SearchMode::AStar);
+            auto start = std::chrono::steady_clock::now();
+            const auto path = planner.findPath(q.sx, q.sy, q.gx, q.gy);
+            seconds[mode] += secondsSince(start);
+            expanded[mode] += planner.stats().expanded;
+            cost[mode] = planner.stats().cost;
+            if (!path.empty() && !validPath(planner.map(), path)) ok = false;
+        }
+        if (cost[0] >= 0) found++;
+        // 浮点累加顺序不同,按相对误差比较
+        if (std::fabs(cost[0] - cost[1]) > 1e-5 * std::max(1.0, cost[0])) {
+            std::fprintf(stderr, "cost mismatch (%d,%d)->(%d,%d): astar %.4f jps %.4f\n", q.sx,
+                         q.sy, q.gx, q.gy, cost[0], cost[1]);
+            ok = false;
+        }
+    }
+    const double n = static_cast<double>(queries.size());
+    std::printf("%-8s %6d/%-4zu %12.2f %12.0f %12.2f %12.0f %8.1fx  %s\n", name, found,
+                queries.size(), seconds[0] / n * 1e3, expanded[0] / n, seconds[1] / n * 1e3,
+                expanded[1] / n, seconds[0] / seconds[1], ok ? "ok" : "FAILED");
+    return ok;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    const int size = argc > 1 ? std::atoi(argv[1]) : 10000;
+    const int queryCount = argc > 2 ? std::atoi(argv[2]) : 20;
+    const double density = argc > 3 ? std::atof(argv[3]) : 0.2;
+
+    std::mt19937 rng(45);
+    std::uniform_int_distribution<int> coord(0, size - 1);
+    AStar planner(size, size);
+
+    std::printf("%-8s %11s %12s %12s %12s %12s %9s\n", "map", "found", "astar ms",
+                "astar exp", "jps ms", "jps exp", "speedup");
+
+    auto makeQueries = [&]() {
+        std::vector<Query> queries;
+        while (static_cast<int>(queries.size()) < queryCount) {
+            Query q = {coord(rng), coord(rng), coord(rng), coord(rng)};
+            if (!planner.isObstacle(q.sx, q.sy) && !planner.isObstacle(q.gx, q.gy))
+                queries.push_back(q);
+        }
+        return queries;
+    };
+
+    bool ok = run("open", planner, makeQueries());
+
+    std::bernoulli_distribution blocked(density);
+    for (int y = 0; y < size; y++)
+        for (int x = 0; x < size; x++)
+            if (blocked(rng)) planner.setObstacle(x, y, true);
+    ok = run("random", planner, makeQueries()) && ok;
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,455 @@
+// 栅格规划器基准测试
+//
+// 场景: 迷宫(maze)、随机障碍(random)、房间(rooms)、开阔地(open),
+// 边长从100到16000;也可以用--map读入map.txt(或MovingAI .map)格式的地图.
+// 每个场景用固定种子在最大连通域里抽一组起终点,依次交给各规划器,输出:
+//   每次查询耗时的p50/p90/p99/最大值(ms)、平均扩展节点数、
+//   规划器运行期间的峰值常驻内存增量(MB)、路径代价与最优值之比的最大值,
+//   以及路径是否连续、不穿障碍.
+// 最优值取A*的代价(八方向距离是可采纳的启发式);读入的查询文件带代价时以文件为准,
+// 用来发现回归.
+//
+// 用法: planner_bench [选项]
+//   --sizes 100,1000,4000       边长列表(默认 100,1000,4000)
+//   --kinds maze,random,rooms,open
+//   --planners astar,jps,dstar
+//   --queries N                 每个场景的查询数(默认 10)
+//   --save DIR                  把生成的地图与查询写成 DIR/<场景>_<边长>.txt 与 .queries.txt
+//   --map FILE [--query-file FILE]  只测给定的地图(与查询)
+// 16000的迷宫与随机地图上A*几乎要铺满整幅地图,状态数组约4GB,D* Lite约6GB.
+
+#include "a_star.h"
+#include "d_star_lite.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+        .count();
+}
+
+struct Query {
+    int sx, sy, gx, gy;
+    double cost;  // 已知的最优代价,未知为-1
+};
+
+std::vector<std::string> split(const std::string& text) {
+    std::vector<std::string> items;
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ','))
+        if (!item.empty()) items.push_back(item);
+    return items;
+}
+
+// ---- 内存 ----
+
+// /proc/self/status中某一项(kB)
+long statusKb(const char* key) {
+    std::ifstream in("/proc/self/status");
+    std::string line;
+    const size_t n = std::strlen(key);
+    while (std::getline(in, line))
+        if (line.compare(0, n, key) == 0 && line[n] == ':') return std::atol(line.c_str() + n + 1);
+    return 0;
+}
+
+// 把峰值常驻内存重置为当前值(Linux 4.0起)
+void resetPeakRss() {
+    std::ofstream out("/proc/self/clear_refs");
+    out << "5";
+}
+
+// ---- 场景生成 ----
+
+void fill(GridMap& map, int x0, int y0, int x1, int y1, bool obstacle) {
+    x0 = std::max(x0, 0);
+    y0 = std::max(y0, 0);
+    x1 = std::min(x1, map.width());
+    y1 = std::min(y1, map.height());
+    for (int y = y0; y < y1; y++)
+        for (int x = x0; x < x1; x++) map.setObstacle(x, y, obstacle);
+}
+
+// 深度优先生成的完美迷宫;通道与墙宽都为width
+void makeMaze(GridMap& map, int width, std::mt19937& rng) {
+    const int size = map.width();
+    fill(map, 0, 0, size, size, true);
+    const int pitch = 2 * width;
+    const int n = std::max(1, (size - width) / pitch);
+    std::vector<uint8_t> visited(static_cast<size_t>(n) * n, 0);
+    std::vector<int> stack;
+    auto carveCell = [&](int c) {
+        const int cx = c % n, cy = c / n;
+        fill(map, width + cx * pitch, width + cy * pitch, width + cx * pitch + width,
+             width + cy * pitch + width, false);
+    };
+    stack.push_back(0);
+    visited[0] = 1;
+    carveCell(0);
+    while (!stack.empty()) {
+        const int c = stack.back();
+        const int cx = c % n, cy = c / n;
+        int next[4], count = 0;
+        if (cx > 0 && !visited[c - 1]) next[count++] = c - 1;
+        if (cx + 1 < n && !visited[c + 1]) next[count++] = c + 1;
+        if (cy > 0 && !visited[c - n]) next[count++] = c - n;
+        if (cy + 1 < n && !visited[c + n]) next[count++] = c + n;
+        if (count == 0) {
+            stack.pop_back();
+            continue;
+        }
+        const int d = next[rng() % count];
+        visited[d] = 1;
+        carveCell(d);
+        // 打通两格之间的墙
+        const int dx = d % n, dy = d / n;
+        const int wx = width + std::min(cx, dx) * pitch + (dx != cx ? width : 0);
+        const int wy = width + std::min(cy, dy) * pitch + (dy != cy ? width : 0);
+        fill(map, wx, wy, wx + width, wy + width, false);
+        stack.push_back(d);
+    }
+}
+
+void makeRandom(GridMap& map, double density, std::mt19937& rng) {
+    std::bernoulli_distribution blocked(density);
+    for (int y = 0; y < map.height(); y++)
+        for (int x = 0; x < map.width(); x++)
+            if (blocked(rng)) map.setObstacle(x, y, true);
+}
+
+// room x room的房间,墙厚1,每面墙大多开一扇门
+void makeRooms(GridMap& map, int room, std::mt19937& rng) {
+    const int size = map.width();
+    const int door = std::max(1, room / 8);
+    for (int w = room; w < size; w += room + 1) {
+        fill(map, w, 0, w + 1, size, true);
+        fill(map, 0, w, size, w + 1, true);
+    }
+    std::uniform_real_distribution<double> unit(0, 1);
+    for (int y0 = 0; y0 < size; y0 += room + 1)
+        for (int x0 = 0; x0 < size; x0 += room + 1) {
+            // 右墙与下墙各一扇门
+            if (x0 + room < size && unit(rng) < 0.8) {
+                const int y = y0 + static_cast<int>(rng() % std::max(1, room - door));
+                fill(map, x0 + room, y, x0 + room + 1, y + door, false);
+            }
+            if (y0 + room < size && unit(rng) < 0.8) {
+                const int x = x0 + static_cast<int>(rng() % std::max(1, room - door));
+                fill(map, x, y0 + room, x + door, y0 + room + 1, false);
+            }
+        }
+}
+
+// 开阔地: 零星的矩形障碍,约占1%面积
+void makeOpen(GridMap& map, std::mt19937& rng) {
+    const int size = map.width();
+    const int maxSide = std::max(2, size / 50);
+    const double target = 0.01 * size * size;
+    double covered = 0;
+    while (covered < target) {
+        const int w = 1 + static_cast<int>(rng() % maxSide);
+        const int h = 1 + static_cast<int>(rng() % maxSide);
+        const int x = static_cast<int>(rng() % size), y = static_cast<int>(rng() % size);
+        fill(map, x, y, x + w, y + h, true);
+        covered += static_cast<double>(w) * h;
+    }
+}
+
+bool generate(const std::string& kind, int size, GridMap& map, std::mt19937& rng) {
+    map.resize(size, size);
+    if (kind == "maze") makeMaze(map, std::max(1, size / 1024), rng);
+    else if (kind == "random") makeRandom(map, 0.25, rng);
+    else if (kind == "rooms") makeRooms(map, std::max(8, size / 32), rng);
+    else if (kind == "open") makeOpen(map, rng);
+    else return false;
+    return true;
+}
+
+// ---- 查询 ----
+
+// 从随机空地出发广度优先标记连通域,取覆盖至少一半空地的那个(最多试10次)
+std::vector<uint64_t> largestComponent(const GridMap& map, std::mt19937& rng, size_t* count) {
+    const size_t cells = static_cast<size_t>(map.width()) * map.height();
+    const size_t free = cells - map.obstacleCount();
+    std::vector<uint64_t> best;
+    size_t bestCount = 0;
+    for (int attempt = 0; attempt < 10 && bestCount * 2 < free; attempt++) {
+        int x, y;
+        do {
+            x = static_cast<int>(rng() % map.width());
+            y = static_cast<int>(rng() % map.height());
+        } while (map.isObstacle(x, y) && free > 0);
+        std::vector<uint64_t> seen((cells + 63) / 64, 0);
+        std::deque<uint32_t> queue;
+        auto visit = [&](int vx, int vy) {
+            const size_t i = static_cast<size_t>(vy) * map.width() + vx;
+            if (map.isObstacle(vx, vy) || (seen[i >> 6] >> (i & 63) & 1)) return;
+            seen[i >> 6] |= uint64_t(1) << (i & 63);
+            queue.push_back(static_cast<uint32_t>(i));
+        };
+        visit(x, y);
+        size_t reached = 0;
+        while (!queue.empty()) {
+            const uint32_t i = queue.front();
+            queue.pop_front();
+            reached++;
+            const int cx = static_cast<int>(i % map.width()), cy = static_cast<int>(i / map.width());
+            visit(cx + 1, cy);
+            visit(cx - 1, cy);
+            visit(cx, cy + 1);
+            visit(cx, cy - 1);
+        }
+        if (reached > bestCount) {
+            bestCount = reached;
+            best.swap(seen);
+        }
+    }
+    *count = bestCount;
+    return best;
+}
+
+std::vector<Query> makeQueries(const GridMap& map, int count, std::mt19937& rng) {
+    size_t reachable = 0;
+    const std::vector<uint64_t> component = largestComponent(map, rng, &reachable);
+    std::vector<Query> queries;
+    if (reachable < 2) return queries;
+    auto pick = [&](int* x, int* y) {
+        for (;;) {
+            *x = static_cast<int>(rng() % map.width());
+            *y = static_cast<int>(rng() % map.height());
+            const size_t i = static_cast<size_t>(*y) * map.width() + *x;
+            if (component[i >> 6] >> (i & 63) & 1) return;
+        }
+    };
+    while (static_cast<int>(queries.size()) < count) {
+        Query q;
+        pick(&q.sx, &q.sy);
+        pick(&q.gx, &q.gy);
+        q.cost = -1;
+        queries.push_back(q);
+    }
+    return queries;
+}
+
+bool saveQueries(const std::string& path, const std::vector<Query>& queries) {
+    FILE* fp = std::fopen(path.c_str(), "w");
+    if (!fp) return false;
+    for (const Query& q : queries)
+        std::fprintf(fp, "%d %d %d %d %.9f\n", q.sx, q.sy, q.gx, q.gy, q.cost);
+    return std::fclose(fp) == 0;
+}
+
+bool loadQueries(const std::string& path, std::vector<Query>* queries) {
+    std::ifstream in(path);
+    if (!in) return false;
+    Query q;
+    while (in >> q.sx >> q.sy >> q.gx >> q.gy) {
+        if (!(in >> q.cost)) {
+            q.cost = -1;
+            in.clear();
+        }
+        queries->push_back(q);
+    }
+    return true;
+}
+
+// ---- 规划与统计 ----
+
+// 路径相邻两格八(或四)邻接、不穿拐角、不经障碍,两端与查询一致
+bool validPath(const GridMap& map, const Query& q, const std::vector<std::pair<int, int>>& path,
+               double* cost) {
+    *cost = 0;
+    if (path.front() != std::make_pair(q.sx, q.sy) || path.back() != std::make_pair(q.gx, q.gy))
+        return false;
+    for (size_t i = 0; i < path.size(); i++) {
+        if (map.isObstacle(path[i].first, path[i].second)) return false;
+        if (i == 0) continue;
+        const int dx = path[i].first - path[i - 1].first;
+        const int dy = path[i].second - path[i - 1].second;
+        if (std::abs(dx) > 1 || std::abs(dy) > 1 || (dx == 0 && dy == 0)) return false;
+        if (dx != 0 && dy != 0) {
+            if (map.isObstacle(path[i - 1].first + dx, path[i - 1].second) ||
+                map.isObstacle(path[i - 1].first, path[i - 1].second + dy))
+                return false;
+            *cost += std::sqrt(2.0);
+        } else {
+            *cost += 1;
+        }
+    }
+    return true;
+}
+
+double percentile(std::vector<double> values, double p) {
+    if (values.empty()) return 0;
+    std::sort(values.begin(), values.end());
+    const size_t rank = static_cast<size_t>(std::ceil(p * values.size()));
+    return values[std::min(values.size() - 1, rank > 0 ? rank - 1 : 0)];
+}
+
+struct Result {
+    std::vector<double> seconds;
+    double expanded = 0;
+    long peakKb = 0;
+    int found = 0;
+    double worstRatio = 1;
+    bool valid = true;
+};
+
+template <typename Planner, typename Plan>
+Result runPlanner(const GridMap& map, std::vector<Query>& queries, bool isReference, Plan plan) {
+    Result result;
+    const long baseKb = statusKb("VmRSS");
+    resetPeakRss();
+    {
+        Planner planner(map);
+        for (Query& q : queries) {
+            auto start = std::chrono::steady_clock::now();
+            const std::vector<std::pair<int, int>> path = plan(planner, q);
+            result.seconds.push_back(secondsSince(start));
+            result.expanded += planner.stats().expanded;
+            if (path.empty()) {
+                // 查询都取自同一连通域,必须有路径
+                result.valid = false;
+                continue;
+            }
+            result.found++;
+            double cost = 0;
+            if (!validPath(map, q, path, &cost)) result.valid = false;
+            if (q.cost < 0 && isReference) q.cost = cost;
+            if (q.cost > 0) result.worstRatio = std::max(result.worstRatio, cost / q.cost);
+            // 比最优还短说明参考值错了
+            if (q.cost >= 0 && cost < q.cost * (1 - 1e-6)) result.valid = false;
+        }
+        result.peakKb = statusKb("VmHWM") - baseKb;
+    }
+    result.expanded /= std::max<size_t>(1, queries.size());
+    return result;
+}
+
+void report(const std::string& scenario, int size, const char* name, const Result& r,
+            size_t queries) {
+    std::printf("%-8s %6d %-6s %5d/%-4zu %9.3f %9.3f %9.3f %9.3f %12.0f %9.1f %10.7f  %s\n",
+                scenario.c_str(), size, name, r.found, queries, percentile(r.seconds, 0.5) * 1e3,
+                percentile(r.seconds, 0.9) * 1e3, percentile(r.seconds, 0.99) * 1e3,
+                percentile(r.seconds, 1.0) * 1e3, r.expanded, r.peakKb / 1024.0, r.worstRatio,
+                r.valid ? "ok" : "FAILED");
+    std::fflush(stdout);
+}
+
+bool runScenario(const std::string& scenario, const GridMap& map, std::vector<Query>& queries,
+                 const std::vector<std::string>& planners) {
+    bool ok = true;
+    // A*先跑,给没有代价的查询定下最优值
+    std::vector<std::string> order(planners);
+    std::stable_sort(order.begin(), order.end(), [](const std::string& a, const std::string& b) {
+        return a == "astar" && b != "astar";
+    });
+    for (const std::string& name : order) {
+        Result r;
+        if (name == "astar" || name == "jps") {
+            const SearchMode mode = name == "jps" ? SearchMode::JumpPoint : SearchMode::AStar;
+            r = runPlanner<AStar>(map, queries, name == "astar", [&](AStar& p, const Query& q) {
+                p.setSearchMode(mode);
+                return p.findPath(q.sx, q.sy, q.gx, q.gy);
+            });
+        } else if (name == "dstar") {
+            r = runPlanner<DStarLite>(map, queries, false, [](DStarLite& p, const Query& q) {
+                return p.findPath(q.sx, q.sy, q.gx, q.gy);
+            });
+        } else {
+            std::fprintf(stderr, "unknown planner %s\n", name.c_str());
+            return false;
+        }
+        report(scenario, map.width(), name.c_str(), r, queries.size());
+        ok = ok && r.valid;
+    }
+    return ok;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> sizes = {"100", "1000", "4000"};
+    std::vector<std::string> kinds = {"maze", "random", "rooms", "open"};
+    std::vector<std::string> planners = {"astar", "jps", "dstar"};
+    int queryCount = 10;
+    std::string saveDir, mapPath, queryPath;
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : "";
+        if (arg == "--sizes") sizes = split(value), i++;
+        else if (arg == "--kinds") kinds = split(value), i++;
+        else if (arg == "--planners") planners = split(value), i++;
+        else if (arg == "--queries") queryCount = std::atoi(value), i++;
+        else if (arg == "--save") saveDir = value, i++;
+        else if (arg == "--map") mapPath = value, i++;
+        else if (arg == "--query-file") queryPath = value, i++;
+        else {
+            std::fprintf(stderr, "unknown option %s\n", arg.c_str());
+            return 2;
+        }
+    }
+
+    std::printf("%-8s %6s %-6s %10s %9s %9s %9s %9s %12s %9s %10s\n", "scenario", "size",
+                "plan", "found", "p50 ms", "p90 ms", "p99 ms", "max ms", "expanded", "peak MB",
+                "cost/opt");
+    bool ok = true;
+    if (!mapPath.empty()) {
+        GridMap map;
+        if (!map.load(mapPath)) {
+            std::fprintf(stderr, "%s\n", map.errorString().c_str());
+            return 1;
+        }
+        std::vector<Query> queries;
+        if (!queryPath.empty() && !loadQueries(queryPath, &queries)) {
+            std::fprintf(stderr, "cannot read %s\n", queryPath.c_str());
+            return 1;
+        }
+        std::mt19937 rng(47);
+        if (queries.empty()) queries = makeQueries(map, queryCount, rng);
+        ok = runScenario("file", map, queries, planners);
+        return ok ? 0 : 1;
+    }
+
+    for (const std::string& sizeText : sizes) {
+        const int size = std::atoi(sizeText.c_str());
+        for (const std::string& kind : kinds) {
+            // 每个场景独立的固定种子,改动其他场景不影响它的地图与查询
+            std::mt19937 rng(static_cast<uint32_t>(std::hash<std::string>()(kind) + size));
+            GridMap map;
+            auto start = std::chrono::steady_clock::now();
+            if (!generate(kind, size, map, rng)) {
+                std::fprintf(stderr, "unknown scenario %s\n", kind.c_str());
+                return 2;
+            }
+            std::vector<Query> queries = makeQueries(map, queryCount, rng);
+            const double generateSeconds = secondsSince(start);
+            ok = runScenario(kind, map, queries, planners) && ok;
+            if (!saveDir.empty()) {
+                const std::string base = saveDir + "/" + kind + "_" + sizeText;
+                if (!map.save(base + ".txt") || !saveQueries(base + ".queries.txt", queries)) {
+                    std::fprintf(stderr, "cannot write %s\n", base.c_str());
+                    ok = false;
+                }
+            }
+            std::printf("         (%s %d: %.1f%% blocked, generated in %.2f s)\n", kind.c_str(),
+                        size, 100.0 * map.obstacleCount() / (double(size) * size),
+                        generateSeconds);
+        }
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,140 @@
+// D* Lite增量重规划与完整重规划的耗时对比
+//
+// 边长为size、障碍率20%的随机地图,起点在左上角、终点在右下角.
+// 机器人每轮沿当前路径前进几格,随后地图上有rate个格子翻转(障碍<->空地),
+// 再分别用D* Lite(moveStart + replan)与A*、JPS从头规划.变化分两种:
+//   local  翻转的格子在机器人周围半径radius内(传感器新看到的),变化率到100为止
+//   global 翻转的格子在整幅地图上均匀分布
+// 输出每种变化率下三者的平均/最大耗时,以及D* Lite相对A*的加速比;
+// 每轮核对三者的路径代价一致;机器人被围住(无路径)时该变化率提前结束,rounds为实际轮数.
+//
+// 用法: replan_bench [边长] [每种变化率的轮数] [前进格数]   (默认 1000 30 5)
+
+#include "a_star.h"
+#include "d_star_lite.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace {
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+        .count();
+}
+
+struct Timing {
+    double total = 0;
+    double worst = 0;
+    void add(double seconds) {
+        total += seconds;
+        worst = std::max(worst, seconds);
+    }
+};
+
+bool sameCost(double a, double b) {
+    return std::fabs(a - b) <= 1e-6 * std::max(1.0, std::fabs(a));
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    const int size = argc > 1 ? std::atoi(argv[1]) : 1000;
+    const int rounds = argc > 2 ? std::atoi(argv[2]) : 30;
+    const int advance = argc > 3 ? std::atoi(argv[3]) : 5;
+    const int radius = 20;
+
+    GridMap base(size, size);
+    std::mt19937 rng(46);
+    std::bernoulli_distribution blocked(0.2);
+    for (int y = 0; y < size; y++)
+        for (int x = 0; x < size; x++)
+            if (blocked(rng)) base.setObstacle(x, y, true);
+    // 起终点附近留空
+    for (int d = 0; d < 3; d++)
+        for (int e = 0; e < 3; e++) {
+            base.setObstacle(d, e, false);
+            base.setObstacle(size - 1 - d, size - 1 - e, false);
+        }
+    const int goalX = size - 1, goalY = size - 1;
+
+    std::printf("%-7s %6s %6s %10s %10s %10s %10s %10s %10s %9s %7s\n", "changes", "rate",
+                "rounds", "d* ms", "d* max", "astar ms", "astar max", "jps ms", "jps max",
+                "speedup", "check");
+    bool ok = true;
+    for (int local = 1; local >= 0; local--) {
+        for (int rate : {1, 10, 100, 1000, 10000}) {
+            // 半径20的窗口只有1681格,再多的局部翻转等于把机器人周围重新随机一遍
+            if (local && rate > 100) continue;
+            DStarLite dstar(base);
+            AStar astar(base);
+            int rx = 0, ry = 0;
+            auto start = std::chrono::steady_clock::now();
+            std::vector<std::pair<int, int>> path = dstar.findPath(rx, ry, goalX, goalY);
+            const double initial = secondsSince(start);
+
+            Timing timing[3];
+            int done = 0;
+            bool agree = true;
+            for (int round = 0; round < rounds && path.size() > 1; round++) {
+                // 沿路径前进
+                const size_t step = std::min<size_t>(advance, path.size() - 1);
+                rx = path[step].first;
+                ry = path[step].second;
+                // 翻转rate个格子,不动机器人与终点所在格子
+                for (int k = 0; k < rate; k++) {
+                    int x, y;
+                    if (local) {
+                        x = rx + static_cast<int>(rng() % (2 * radius + 1)) - radius;
+                        y = ry + static_cast<int>(rng() % (2 * radius + 1)) - radius;
+                    } else {
+                        x = static_cast<int>(rng() % size);
+                        y = static_cast<int>(rng() % size);
+                    }
+                    if (!base.isValid(x, y) || (x == rx && y == ry) || (x == goalX && y == goalY))
+                        continue;
+                    const bool obstacle = !astar.isObstacle(x, y);
+                    dstar.setObstacle(x, y, obstacle);
+                    astar.setObstacle(x, y, obstacle);
+                }
+
+                start = std::chrono::steady_clock::now();
+                dstar.moveStart(rx, ry);
+                path = dstar.replan();
+                timing[0].add(secondsSince(start));
+                const double dstarCost = dstar.stats().cost;
+
+                double cost[2];
+                for (int mode = 0; mode < 2; mode++) {
+                    astar.setSearchMode(mode ? SearchMode::JumpPoint : SearchMode::AStar);
+                    start = std::chrono::steady_clock::now();
+                    astar.findPath(rx, ry, goalX, goalY);
+                    timing[1 + mode].add(secondsSince(start));
+                    cost[mode] = astar.stats().cost;
+                }
+                if (!sameCost(dstarCost, cost[0]) || !sameCost(cost[0], cost[1])) {
+                    std::fprintf(stderr, "round %d at (%d,%d): d* %.6f astar %.6f jps %.6f\n",
+                                 round, rx, ry, dstarCost, cost[0], cost[1]);
+                    agree = false;
+                }
+                done++;
+            }
+            ok = ok && agree;
+            const double n = done > 0 ? done : 1;
+            std::printf("%-7s %6d %6d %10.3f %10.3f %10.3f %10.3f %10.3f %10.3f %8.1fx %7s\n",
+                        local ? "local" : "global", rate, done, timing[0].total / n * 1e3,
+                        timing[0].worst * 1e3, timing[1].total / n * 1e3, timing[1].worst * 1e3,
+                        timing[2].total / n * 1e3, timing[2].worst * 1e3,
+                        timing[1].total / std::max(timing[0].total, 1e-12),
+                        agree ? "ok" : "FAILED");
+            if (rate == 1 && local)
+                std::printf("        (initial D* Lite plan %.1f ms)\n", initial * 1e3);
+        }
+    }
+    return ok ? 0 : 1;
+}
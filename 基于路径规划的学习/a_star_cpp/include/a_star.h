@@ -0,0 +1,121 @@
+#ifndef A_STAR_H
+#define A_STAR_H
+
+#include "grid_map.h"
+#include "indexed_heap.h"
+#include "lazy_array.h"
+#include "tile_layout.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// 搜索方式
+enum class SearchMode {
+    AStar,      // 逐格扩展
+    JumpPoint,  // 跳点搜索(JPS),只在8连通时有效,4连通时退回AStar
+};
+
+// 一次查询的统计
+struct SearchStats {
+    size_t expanded = 0;  // 出堆(关闭)的节点数
+    size_t pushed = 0;    // 入堆次数
+    size_t touched = 0;   // 本次初始化过状态的格子数
+    double cost = -1;     // 路径代价,无路径为-1
+};
+
+// 栅格A*规划器
+//
+// 地图是位压缩的GridMap;g值、父节点、堆位置存放在一个按16x16分块的连续数组里,
+// 数组只分配一次,每次查询只清理上次访问过的格子;开集是带改键的4叉索引堆.
+// g用double累加(float在上万步后误差可达0.1),堆键用float的f与g,
+// 只差舍入误差的f视为相等,再按g大者优先,空旷地图上不会在等f区域里铺开.
+// 8连通时直行代价1,斜行代价sqrt(2),不允许穿过障碍的拐角,启发式为八方向距离;
+// 4连通时启发式为曼哈顿距离.
+class AStar {
+public:
+    AStar(int width, int height);
+    explicit AStar(const GridMap& map);
+
+    // 返回从起点到终点(含两端)的格子坐标序列,无路径时为空
+    std::vector<std::pair<int, int>> findPath(int startX, int startY, int goalX, int goalY);
+
+    void setObstacle(int x, int y, bool isObstacle);
+    bool isValid(int x, int y) const { return map_.isValid(x, y); }
+    bool isObstacle(int x, int y) const { return map_.isObstacle(x, y); }
+
+    // 直接修改地图(例如load);尺寸变化在下次查询时生效
+    GridMap& map() { return map_; }
+    const GridMap& map() const { return map_; }
+
+    void setDiagonal(bool diagonal) { diagonal_ = diagonal; }
+    bool diagonal() const { return diagonal_; }
+    void setSearchMode(SearchMode mode) { mode_ = mode; }
+    SearchMode searchMode() const { return mode_; }
+
+    const SearchStats& stats() const { return stats_; }
+
+private:
+    // 每个格子的搜索状态,16字节,一个16x16分块正好一页.
+    // 全0(parent为0,即边框角上的格子,不可能是父节点)表示本次查询未访问.
+    // 堆与parent里的节点都用状态数组下标(TileLayout)表示
+    struct Cell {
+        double g;
+        uint32_t parent;     // 起点的父节点是它自己
+        uint32_t heapIndex;  // 堆中位置;kNone不在堆中,kClosed已关闭
+    };
+    struct HeapPosition {
+        Cell* cells;
+        uint32_t& operator()(uint32_t node) { return cells[node].heapIndex; }
+    };
+    typedef IndexedHeap<HeapPosition> Heap;
+
+    static const uint32_t kNone = 0xFFFFFFFFu;
+    static const uint32_t kClosed = 0xFFFFFFFEu;
+
+    bool prepare();
+    Cell& touch(uint32_t node) {
+        Cell& c = cells_[node];
+        if (c.parent == 0) {
+            c.g = kInfinity;
+            c.parent = kNone;
+            c.heapIndex = kNone;
+            if (touched_.size() < touchedLimit_) touched_.push_back(node);
+            else touchedOverflow_ = true;
+            stats_.touched++;
+        }
+        return c;
+    }
+    // 以下坐标都是含边框的坐标(地图坐标 + 1)
+    double heuristic(int x, int y) const;
+    void relax(uint32_t from, int x, int y, double cost);
+    void expandNeighbours(uint32_t node);
+    void expandJumpPoints(uint32_t node);
+    uint32_t jump(int x, int y, int dx, int dy) const;
+    uint32_t jumpHorizontal(uint32_t id, int dx) const;
+    uint32_t jumpVertical(uint32_t id, int dy) const;
+    std::vector<std::pair<int, int>> reconstruct() const;
+
+    static const double kInfinity;
+
+    GridMap map_;
+    bool diagonal_ = true;
+    SearchMode mode_ = SearchMode::AStar;
+
+    TileLayout layout_;
+    LazyArray<Cell> cells_;
+    Heap heap_;
+    // 本次查询访问过的格子,下次查询前逐个清零;超过上限时整体清零
+    std::vector<uint32_t> touched_;
+    size_t touchedLimit_ = 0;
+    bool touchedOverflow_ = false;
+    uint32_t start_ = 0;  // 状态下标
+    uint32_t goal_ = 0;
+    uint32_t goalId_ = 0;  // 地图编号
+    int goalX_ = 0;
+    int goalY_ = 0;
+    SearchStats stats_;
+};
+
+#endif
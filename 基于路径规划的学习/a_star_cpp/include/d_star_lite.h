@@ -0,0 +1,121 @@
+#ifndef D_STAR_LITE_H
+#define D_STAR_LITE_H
+
+#include "a_star.h"
+#include "grid_map.h"
+#include "indexed_heap.h"
+#include "lazy_array.h"
+#include "tile_layout.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// D* Lite增量规划器(Koenig & Likhachev 2002的优化版本)
+//
+// 从终点向起点搜索,保存每个格子的g与rhs;地图变化后只修复受影响的部分,
+// 机器人移动只累加km,不重排开集.移动代价与AStar相同
+// (8连通直行1、斜行sqrt(2)、不穿拐角;或4连通).
+// 内部用64位定点整数(直行2^24,斜行round(sqrt(2) * 2^24))累加代价:
+// 浮点键只差一两个ulp就会让本该先处理的格子排到起点之后,留下过期的g,
+// 沿g回溯路径时绕圈.定点数下键的比较与 rhs == c + g 的判断都是精确的;
+// 与真实代价的相对误差在1e-8以内,stats().cost按真实代价给出.
+//
+// 典型用法:
+//   DStarLite planner(w, h);
+//   planner.findPath(sx, sy, gx, gy);        // 首次完整规划
+//   planner.setObstacle(x, y, true); ...     // 传感器发现的变化,可以攒一批
+//   planner.moveStart(rx, ry);               // 机器人当前位置
+//   path = planner.replan();                 // 只修复受影响的部分
+class DStarLite {
+public:
+    DStarLite(int width, int height);
+    explicit DStarLite(const GridMap& map);
+
+    // 终点变化(或首次调用)时重新初始化,否则等价于moveStart + replan
+    std::vector<std::pair<int, int>> findPath(int startX, int startY, int goalX, int goalY);
+
+    // 修改地图;变化先记下来,在下一次replan时一并处理
+    void setObstacle(int x, int y, bool isObstacle);
+    bool isValid(int x, int y) const { return map_.isValid(x, y); }
+    bool isObstacle(int x, int y) const { return map_.isObstacle(x, y); }
+    const GridMap& map() const { return map_; }
+
+    // 只能在findPath初始化之前切换
+    void setDiagonal(bool diagonal);
+    bool diagonal() const { return diagonal_; }
+
+    // 机器人移动到(x, y)
+    void moveStart(int x, int y);
+    // 处理挂起的地图变化,修复最短路并返回从当前起点到终点的路径
+    std::vector<std::pair<int, int>> replan();
+
+    size_t pendingChanges() const { return changes_.size(); }
+    // 上一次findPath/replan的统计;touched为因地图变化重算rhs的格子数
+    const SearchStats& stats() const { return stats_; }
+
+private:
+    typedef int64_t Cost;
+    struct Key {
+        Cost k1;
+        Cost k2;
+        bool operator<(const Key& other) const {
+            return k1 < other.k1 || (k1 == other.k1 && k2 < other.k2);
+        }
+    };
+    // 每个格子24字节.flags为0表示从未访问(g = rhs = 无穷)
+    struct Cell {
+        Cost g;
+        Cost rhs;
+        uint32_t heapIndex;
+        uint32_t flags;
+    };
+    struct HeapPosition {
+        Cell* cells;
+        uint32_t& operator()(uint32_t node) { return cells[node].heapIndex; }
+    };
+    typedef IndexedHeap<HeapPosition, Key> Heap;
+
+    static const uint32_t kNone = 0xFFFFFFFFu;
+    static const Cost kInfinity = Cost(1) << 62;
+
+    Cell& cell(uint32_t node) {
+        Cell& c = cells_[node];
+        if (c.flags == 0) {
+            c.g = kInfinity;
+            c.rhs = kInfinity;
+            c.heapIndex = kNone;
+            c.flags = 1;
+        }
+        return c;
+    }
+    void initialize(int startX, int startY, int goalX, int goalY);
+    // 可走的后继(对无向栅格也是前驱)及代价,返回个数
+    int neighbours(uint32_t node, uint32_t* nodes, Cost* costs) const;
+    // 八方向距离或曼哈顿距离,作启发式与km增量
+    Cost distance(uint32_t a, uint32_t b) const;
+    Key calculateKey(uint32_t node);
+    void updateVertex(uint32_t node);
+    Cost bestRhs(uint32_t node);
+    void applyChanges();
+    void computeShortestPath();
+    std::vector<std::pair<int, int>> extractPath();
+
+    GridMap map_;
+    bool diagonal_ = true;
+    bool initialized_ = false;
+
+    TileLayout layout_;
+    LazyArray<Cell> cells_;
+    Heap heap_;
+    std::vector<uint32_t> changes_;  // 变化过的格子(状态下标)
+
+    uint32_t start_ = 0;
+    uint32_t last_ = 0;  // 上次累加km时的起点
+    uint32_t goal_ = 0;
+    Cost km_ = 0;
+    SearchStats stats_;
+};
+
+#endif
@@ -0,0 +1,112 @@
+#ifndef GRID_MAP_H
+#define GRID_MAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 按行连续存放的位数组,1为障碍
+// 前后各留64位填充(也是障碍),window()可以从任意位置一次取出连续64位.
+class BitPlane {
+public:
+    // lines行,每行stride位,全部置为障碍
+    void reset(uint32_t stride, uint32_t lines);
+    // 把第line行的[begin, end)清为空地
+    void clearRange(uint32_t line, uint32_t begin, uint32_t end);
+
+    uint32_t stride() const { return stride_; }
+
+    bool test(uint32_t i) const {
+        const uint64_t bit = i + kPadBits;
+        return (bits_[bit >> 6] >> (bit & 63)) & 1;
+    }
+    void set(uint32_t i, bool value) {
+        const uint64_t bit = i + kPadBits;
+        const uint64_t mask = uint64_t(1) << (bit & 63);
+        if (value) bits_[bit >> 6] |= mask;
+        else bits_[bit >> 6] &= ~mask;
+    }
+    // 第i位起连续64位,第k位为i + k;i可以为负(-64起)
+    uint64_t window(int64_t i) const {
+        const uint64_t bit = static_cast<uint64_t>(i + kPadBits);
+        const uint64_t* w = bits_.data() + (bit >> 6);
+        const unsigned shift = bit & 63;
+        return shift ? (w[0] >> shift) | (w[1] << (64 - shift)) : w[0];
+    }
+
+private:
+    static const int kPadBits = 64;
+
+    std::vector<uint64_t> bits_;
+    uint32_t stride_ = 0;
+};
+
+// 占据栅格地图
+//
+// 每个格子1位,地图四周加一圈障碍边框.
+// 格子编号id = (y + 1) * stride + (x + 1),相邻格子的编号差为±1与±stride,
+// 搜索时不必做越界判断.
+// 另存一份转置(按列连续)的位平面,竖直方向也能按64位一次扫描;
+// 列编号columnId = (x + 1) * (height + 2) + (y + 1).
+class GridMap {
+public:
+    GridMap() = default;
+    GridMap(int width, int height);
+
+    // 重新分配为width x height的空地图;过大(编号超过32位)时变为0 x 0
+    void resize(int width, int height);
+
+    int width() const { return width_; }
+    int height() const { return height_; }
+    int stride() const { return stride_; }
+    // 编号空间大小(含边框)
+    uint32_t cellCount() const { return cellCount_; }
+
+    bool isValid(int x, int y) const {
+        return x >= 0 && x < width_ && y >= 0 && y < height_;
+    }
+    // 越界视为障碍
+    bool isObstacle(int x, int y) const { return !isValid(x, y) || blocked(id(x, y)); }
+    void setObstacle(int x, int y, bool obstacle);
+
+    uint32_t id(int x, int y) const {
+        return static_cast<uint32_t>(y + 1) * stride_ + static_cast<uint32_t>(x + 1);
+    }
+    int xOf(uint32_t id) const { return static_cast<int>(id % stride_) - 1; }
+    int yOf(uint32_t id) const { return static_cast<int>(id / stride_) - 1; }
+    // 行编号与列编号互换
+    uint32_t columnId(uint32_t id) const {
+        return (id % stride_) * columns_.stride() + id / stride_;
+    }
+    uint32_t rowId(uint32_t columnId) const {
+        return (columnId % columns_.stride()) * stride_ + columnId / columns_.stride();
+    }
+
+    bool blocked(uint32_t id) const { return rows_.test(id); }
+    const BitPlane& rows() const { return rows_; }
+    const BitPlane& columns() const { return columns_; }
+
+    // 障碍格子数(不含边框)
+    size_t obstacleCount() const;
+
+    // 读写地图文件.支持两种格式:
+    //   map.txt: 首行 "宽 高",之后每行一排格子,'#' '1' '@' 'T' 'O' 'W' 为障碍,其余为空地;
+    //            没有首行时由行数与最长行推出尺寸
+    //   MovingAI .map: "type octile" / "height H" / "width W" / "map" 头
+    // 保存总是写map.txt格式('.'空地,'#'障碍)
+    bool load(const std::string& path);
+    bool save(const std::string& path) const;
+    const std::string& errorString() const { return errorString_; }
+
+private:
+    int width_ = 0;
+    int height_ = 0;
+    int stride_ = 2;
+    uint32_t cellCount_ = 0;
+    BitPlane rows_;
+    BitPlane columns_;
+    mutable std::string errorString_;
+};
+
+#endif
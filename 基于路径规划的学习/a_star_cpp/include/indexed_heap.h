@@ -0,0 +1,117 @@
+#ifndef INDEXED_HEAP_H
+#define INDEXED_HEAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 4叉索引最小堆
+//
+// 元素是格子编号,键默认为64位无符号整数(调用方把浮点键按位拼进去,
+// 非负浮点数的位模式与数值同序),也可以是任何支持<的类型.
+// 每个元素在堆中的位置写回Position给出的位置表,
+// 因此可以O(log n)地改键和删除任意元素.
+// 4叉比2叉层数少一半,一个节点的4个孩子在同一条缓存行内.
+// Position: uint32_t& operator()(uint32_t id),不在堆中时为kNone
+template <typename Position, typename Key = uint64_t>
+class IndexedHeap {
+public:
+    static const uint32_t kNone = 0xFFFFFFFFu;
+
+    explicit IndexedHeap(Position position = Position()) : position_(position) {}
+
+    Position& position() { return position_; }
+
+    bool empty() const { return entries_.empty(); }
+    size_t size() const { return entries_.size(); }
+    uint32_t top() const { return entries_[0].id; }
+    const Key& topKey() const { return entries_[0].key; }
+
+    // 清空;不修改位置表(调用方通过其他方式判定元素是否已过期)
+    void clear() { entries_.clear(); }
+
+    bool contains(uint32_t id) { return position_(id) != kNone; }
+
+    void push(uint32_t id, const Key& key) {
+        entries_.push_back({key, id});
+        siftUp(entries_.size() - 1);
+    }
+
+    // 改键,变大变小都可以
+    void update(uint32_t id, const Key& key) {
+        const size_t i = position_(id);
+        const Key old = entries_[i].key;
+        entries_[i].key = key;
+        if (key < old) siftUp(i);
+        else siftDown(i);
+    }
+
+    uint32_t pop() {
+        const uint32_t id = entries_[0].id;
+        position_(id) = kNone;
+        const Entry last = entries_.back();
+        entries_.pop_back();
+        if (!entries_.empty()) {
+            entries_[0] = last;
+            siftDown(0);
+        }
+        return id;
+    }
+
+    void remove(uint32_t id) {
+        const size_t i = position_(id);
+        position_(id) = kNone;
+        const Entry last = entries_.back();
+        entries_.pop_back();
+        if (i == entries_.size()) return;
+        entries_[i] = last;
+        if (i > 0 && last.key < entries_[(i - 1) / 4].key) siftUp(i);
+        else siftDown(i);
+    }
+
+private:
+    struct Entry {
+        Key key;
+        uint32_t id;
+    };
+
+    void siftUp(size_t i) {
+        const Entry e = entries_[i];
+        while (i > 0) {
+            const size_t parent = (i - 1) / 4;
+            if (!(e.key < entries_[parent].key)) break;
+            entries_[i] = entries_[parent];
+            position_(entries_[i].id) = static_cast<uint32_t>(i);
+            i = parent;
+        }
+        entries_[i] = e;
+        position_(e.id) = static_cast<uint32_t>(i);
+    }
+
+    void siftDown(size_t i) {
+        const Entry e = entries_[i];
+        const size_t n = entries_.size();
+        while (true) {
+            const size_t first = 4 * i + 1;
+            if (first >= n) break;
+            size_t best = first;
+            const size_t last = first + 4 < n ? first + 4 : n;
+            for (size_t c = first + 1; c < last; c++)
+                if (entries_[c].key < entries_[best].key) best = c;
+            if (!(entries_[best].key < e.key)) break;
+            entries_[i] = entries_[best];
+            position_(entries_[i].id) = static_cast<uint32_t>(i);
+            i = best;
+        }
+        entries_[i] = e;
+        position_(e.id) = static_cast<uint32_t>(i);
+    }
+
+    std::vector<Entry> entries_;
+    Position position_;
+};
+
+template <typename Position, typename Key>
+const uint32_t IndexedHeap<Position, Key>::kNone;
+
+#endif
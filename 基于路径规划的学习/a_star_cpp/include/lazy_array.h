@@ -0,0 +1,55 @@
+#ifndef LAZY_ARRAY_H
+#define LAZY_ARRAY_H
+
+#include <cstddef>
+#include <new>
+
+#include <sys/mman.h>
+
+// 按格子编号索引的大数组,用匿名映射分配
+// 映射时内容为0且不占物理内存,只有搜索实际访问过的页才会分配;
+// 1亿个格子的状态数组也只在虚拟地址空间里占位.
+// T必须是以全0为有效初值的平凡类型.
+template <typename T>
+class LazyArray {
+public:
+    LazyArray() = default;
+    ~LazyArray() { release(); }
+
+    LazyArray(const LazyArray&) = delete;
+    LazyArray& operator=(const LazyArray&) = delete;
+
+    // 重新分配为n个元素(全0);n不变时保留内容
+    void resize(size_t n) {
+        if (n == size_) return;
+        release();
+        if (n == 0) return;
+        void* p = mmap(nullptr, n * sizeof(T), PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (p == MAP_FAILED) throw std::bad_alloc();
+        data_ = static_cast<T*>(p);
+        size_ = n;
+    }
+
+    // 全部清零并归还物理页
+    void clear() {
+        if (data_) madvise(data_, size_ * sizeof(T), MADV_DONTNEED);
+    }
+
+    size_t size() const { return size_; }
+    T* data() { return data_; }
+    T& operator[](size_t i) { return data_[i]; }
+    const T& operator[](size_t i) const { return data_[i]; }
+
+private:
+    void release() {
+        if (data_) munmap(data_, size_ * sizeof(T));
+        data_ = nullptr;
+        size_ = 0;
+    }
+
+    T* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+#endif
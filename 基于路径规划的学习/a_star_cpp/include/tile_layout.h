@@ -0,0 +1,51 @@
+#ifndef TILE_LAYOUT_H
+#define TILE_LAYOUT_H
+
+#include <cstdint>
+
+// 搜索状态数组的分块布局
+//
+// 格子(含边框的坐标x, y)按16x16分块存放,块内行优先,块按行排列,
+// 每行的块数取2的幂,下标与坐标互换只需移位.
+// 16字节的状态恰好一块一页: 搜索在二维上扩展时,3x3邻域基本落在同一页内,
+// 初次访问的缺页与TLB缺失比按行存放少一个数量级.
+// 每行块数补齐到2的幂只浪费虚拟地址,不占物理内存.
+class TileLayout {
+public:
+    // 返回false表示下标超出32位
+    bool reset(int paddedWidth, int paddedHeight) {
+        int shift = 0;
+        while ((1 << shift) * 16 < paddedWidth) shift++;
+        const uint64_t rows = (static_cast<uint64_t>(paddedHeight) + 15) / 16;
+        rowShift_ = shift + 8;
+        columnMask_ = (1u << shift) - 1;
+        const uint64_t size = rows << rowShift_;
+        if (size >= 0xFFFFFFFEull) {
+            size_ = 0;
+            return false;
+        }
+        size_ = static_cast<uint32_t>(size);
+        return true;
+    }
+
+    uint32_t size() const { return size_; }
+
+    uint32_t index(int x, int y) const {
+        return (static_cast<uint32_t>(y >> 4) << rowShift_) |
+               (static_cast<uint32_t>(x >> 4) << 8) | (static_cast<uint32_t>(y & 15) << 4) |
+               static_cast<uint32_t>(x & 15);
+    }
+    int x(uint32_t index) const {
+        return static_cast<int>((((index >> 8) & columnMask_) << 4) | (index & 15));
+    }
+    int y(uint32_t index) const {
+        return static_cast<int>(((index >> rowShift_) << 4) | ((index >> 4) & 15));
+    }
+
+private:
+    int rowShift_ = 8;
+    uint32_t columnMask_ = 0;
+    uint32_t size_ = 0;
+};
+
+#endif
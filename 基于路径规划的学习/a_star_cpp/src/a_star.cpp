@@ -0,0 +1,292 @@
+#include "a_star.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+const double AStar::kInfinity = std::numeric_limits<double>::infinity();
+const uint32_t AStar::kNone;
+const uint32_t AStar::kClosed;
+
+namespace {
+
+const double kSqrt2 = 1.4142135623730951;
+
+// 非负浮点数的位模式与数值同序
+uint32_t floatBits(float f) {
+    uint32_t bits;
+    std::memcpy(&bits, &f, sizeof(bits));
+    return bits;
+}
+
+// 先比f,f相同时g大(离终点近)的优先
+uint64_t heapKey(double f, double g) {
+    return (static_cast<uint64_t>(floatBits(static_cast<float>(f))) << 32) |
+           (0xFFFFFFFFu - floatBits(static_cast<float>(g)));
+}
+
+// 两点间不经障碍的八方向距离
+double octile(int dx, int dy) {
+    dx = std::abs(dx);
+    dy = std::abs(dy);
+    const int lo = std::min(dx, dy), hi = std::max(dx, dy);
+    return (hi - lo) + kSqrt2 * lo;
+}
+
+int sign(int v) {
+    return (v > 0) - (v < 0);
+}
+
+// 沿位平面的一行从c向dir(±1)扫描,c是第一个要检查的格子.
+// 返回第一个有强迫邻居的格子或终点;先碰到障碍返回kNone.
+// 强迫邻居: 相邻行该格为空地而其身后一格是障碍.每次处理63个格子.
+uint32_t scanLine(const BitPlane& plane, uint32_t c, int dir, uint32_t goal, uint32_t none) {
+    const int64_t s = plane.stride();
+    if (dir > 0) {
+        for (;;) {
+            const uint64_t o = plane.window(c);
+            const int blockedAt = o ? __builtin_ctzll(o) : 64;
+            if (blockedAt == 0) return none;
+            const int limit = blockedAt < 63 ? blockedAt : 63;
+            // 第k位: 格子c + k的相邻行空地、身后为障碍
+            const uint64_t up = plane.window(c - s - 1);
+            const uint64_t down = plane.window(c + s - 1);
+            uint64_t mask = (up & ~(up >> 1)) | (down & ~(down >> 1));
+            mask &= (uint64_t(1) << limit) - 1;
+            const uint32_t toGoal = goal - c;
+            if (toGoal < static_cast<uint32_t>(limit)) mask |= uint64_t(1) << toGoal;
+            if (mask) return c + __builtin_ctzll(mask);
+            if (blockedAt < 64) return none;
+            c += 63;
+        }
+    }
+    for (;;) {
+        // 第63 - k位对应格子c - k
+        const uint64_t o = plane.window(int64_t(c) - 63);
+        const int blockedAt = o ? __builtin_clzll(o) : 64;
+        if (blockedAt == 0) return none;
+        const int limit = blockedAt < 63 ? blockedAt : 63;
+        const uint64_t up = plane.window(int64_t(c) - s + 1 - 63);
+        const uint64_t down = plane.window(int64_t(c) + s + 1 - 63);
+        uint64_t mask = (up & ~(up << 1)) | (down & ~(down << 1));
+        mask &= ~uint64_t(0) << (64 - limit);
+        const uint32_t toGoal = c - goal;
+        if (toGoal < static_cast<uint32_t>(limit)) mask |= uint64_t(1) << (63 - toGoal);
+        if (mask) return c - __builtin_clzll(mask);
+        if (blockedAt < 64) return none;
+        c -= 63;
+    }
+}
+
+}  // namespace
+
+AStar::AStar(int width, int height) : map_(width, height) {}
+
+AStar::AStar(const GridMap& map) : map_(map) {}
+
+void AStar::setObstacle(int x, int y, bool isObstacle) {
+    map_.setObstacle(x, y, isObstacle);
+}
+
+bool AStar::prepare() {
+    stats_ = SearchStats();
+    heap_.clear();
+    TileLayout layout;
+    if (!layout.reset(map_.stride(), map_.height() + 2)) return false;
+    if (cells_.size() != layout.size() || layout.index(map_.stride() - 1, 1) !=
+                                             layout_.index(map_.stride() - 1, 1)) {
+        layout_ = layout;
+        cells_.resize(layout.size());
+        cells_.clear();
+        touchedLimit_ = layout.size() / 16;
+    } else if (touchedOverflow_) {
+        // 上次访问的格子太多,没有记全
+        cells_.clear();
+    } else {
+        for (uint32_t node : touched_) cells_[node].parent = 0;
+    }
+    touched_.clear();
+    touchedOverflow_ = false;
+    heap_.position().cells = cells_.data();
+    return true;
+}
+
+double AStar::heuristic(int x, int y) const {
+    const int dx = x - goalX_, dy = y - goalY_;
+    if (diagonal_) return octile(dx, dy);
+    return std::abs(dx) + std::abs(dy);
+}
+
+void AStar::relax(uint32_t from, int x, int y, double cost) {
+    const uint32_t to = layout_.index(x, y);
+    Cell& c = touch(to);
+    if (c.heapIndex == kClosed) return;
+    const double g = cells_[from].g + cost;
+    if (!(g < c.g)) return;
+    c.g = g;
+    c.parent = from;
+    const uint64_t key = heapKey(g + heuristic(x, y), g);
+    if (c.heapIndex == kNone) {
+        heap_.push(to, key);
+        stats_.pushed++;
+    } else {
+        heap_.update(to, key);
+    }
+}
+
+void AStar::expandNeighbours(uint32_t node) {
+    const int x = layout_.x(node), y = layout_.y(node);
+    const uint32_t s = map_.stride();
+    const uint32_t id = y * s + x;
+    const bool e = !map_.blocked(id + 1), w = !map_.blocked(id - 1);
+    const bool n = !map_.blocked(id - s), so = !map_.blocked(id + s);
+    if (e) relax(node, x + 1, y, 1.0);
+    if (w) relax(node, x - 1, y, 1.0);
+    if (n) relax(node, x, y - 1, 1.0);
+    if (so) relax(node, x, y + 1, 1.0);
+    if (!diagonal_) return;
+    // 斜行要求两侧直行格子都可走
+    if (n && e && !map_.blocked(id - s + 1)) relax(node, x + 1, y - 1, kSqrt2);
+    if (n && w && !map_.blocked(id - s - 1)) relax(node, x - 1, y - 1, kSqrt2);
+    if (so && e && !map_.blocked(id + s + 1)) relax(node, x + 1, y + 1, kSqrt2);
+    if (so && w && !map_.blocked(id + s - 1)) relax(node, x - 1, y + 1, kSqrt2);
+}
+
+uint32_t AStar::jumpHorizontal(uint32_t id, int dx) const {
+    return scanLine(map_.rows(), id, dx, goalId_, kNone);
+}
+
+uint32_t AStar::jumpVertical(uint32_t id, int dy) const {
+    const uint32_t found =
+        scanLine(map_.columns(), map_.columnId(id), dy, map_.columnId(goalId_), kNone);
+    return found == kNone ? kNone : map_.rowId(found);
+}
+
+// 从(x, y)出发沿(dx, dy)跳跃,返回跳点的地图编号或kNone.调用方已检查第一步不穿拐角
+uint32_t AStar::jump(int x, int y, int dx, int dy) const {
+    const int s = map_.stride();
+    const uint32_t id = y * s + x;
+    if (dy == 0) return jumpHorizontal(id + dx, dx);
+    if (dx == 0) return jumpVertical(id + dy * s, dy);
+    const int step = dx + dy * s;
+    uint32_t c = id + step;
+    for (;;) {
+        if (map_.blocked(c)) return kNone;
+        if (c == goalId_) return c;
+        // 斜行途中任一直行方向能到跳点,当前格子就是跳点
+        if (jumpHorizontal(c + dx, dx) != kNone || jumpVertical(c + dy * s, dy) != kNone)
+            return c;
+        if (map_.blocked(c + dx) || map_.blocked(c + dy * s)) return kNone;
+        c += step;
+    }
+}
+
+void AStar::expandJumpPoints(uint32_t node) {
+    const int x = layout_.x(node), y = layout_.y(node);
+    const int s = map_.stride();
+    const uint32_t id = y * s + x;
+    int dirs[8][2];
+    int count = 0;
+    auto add = [&](int dx, int dy) {
+        dirs[count][0] = dx;
+        dirs[count][1] = dy;
+        count++;
+    };
+    auto open = [&](int dx, int dy) { return !map_.blocked(id + dx + dy * s); };
+
+    const uint32_t parent = cells_[node].parent;
+    if (parent == node) {
+        for (int dy = -1; dy <= 1; dy++)
+            for (int dx = -1; dx <= 1; dx++) {
+                if (dx == 0 && dy == 0) continue;
+                if (dx != 0 && dy != 0 && !(open(dx, 0) && open(0, dy))) continue;
+                if (open(dx, dy)) add(dx, dy);
+            }
+    } else {
+        // 按来向剪枝
+        const int dx = sign(x - layout_.x(parent));
+        const int dy = sign(y - layout_.y(parent));
+        if (dx != 0 && dy != 0) {
+            const bool h = open(dx, 0), v = open(0, dy);
+            if (v) add(0, dy);
+            if (h) add(dx, 0);
+            if (h && v && open(dx, dy)) add(dx, dy);
+        } else if (dx != 0) {
+            const bool next = open(dx, 0), top = open(0, 1), bottom = open(0, -1);
+            if (next) {
+                add(dx, 0);
+                if (top && open(dx, 1)) add(dx, 1);
+                if (bottom && open(dx, -1)) add(dx, -1);
+            }
+            if (top) add(0, 1);
+            if (bottom) add(0, -1);
+        } else {
+            const bool next = open(0, dy), right = open(1, 0), left = open(-1, 0);
+            if (next) {
+                add(0, dy);
+                if (right && open(1, dy)) add(1, dy);
+                if (left && open(-1, dy)) add(-1, dy);
+            }
+            if (right) add(1, 0);
+            if (left) add(-1, 0);
+        }
+    }
+
+    for (int i = 0; i < count; i++) {
+        const uint32_t target = jump(x, y, dirs[i][0], dirs[i][1]);
+        if (target == kNone) continue;
+        const int tx = static_cast<int>(target % s), ty = static_cast<int>(target / s);
+        relax(node, tx, ty, octile(tx - x, ty - y));
+    }
+}
+
+std::vector<std::pair<int, int>> AStar::findPath(int startX, int startY, int goalX, int goalY) {
+    if (!prepare()) return {};
+    if (map_.isObstacle(startX, startY) || map_.isObstacle(goalX, goalY)) return {};
+
+    goalX_ = goalX + 1;
+    goalY_ = goalY + 1;
+    goalId_ = map_.id(goalX, goalY);
+    goal_ = layout_.index(goalX_, goalY_);
+    start_ = layout_.index(startX + 1, startY + 1);
+    const bool jumping = mode_ == SearchMode::JumpPoint && diagonal_;
+
+    Cell& start = touch(start_);
+    start.g = 0;
+    start.parent = start_;
+    heap_.push(start_, heapKey(heuristic(startX + 1, startY + 1), 0));
+    stats_.pushed++;
+    while (!heap_.empty()) {
+        const uint32_t node = heap_.pop();
+        cells_[node].heapIndex = kClosed;
+        stats_.expanded++;
+        if (node == goal_) {
+            stats_.cost = cells_[node].g;
+            return reconstruct();
+        }
+        if (jumping) expandJumpPoints(node);
+        else expandNeighbours(node);
+    }
+    return {};
+}
+
+// 沿父节点回溯;跳点之间是直线或45度斜线,逐格补齐
+std::vector<std::pair<int, int>> AStar::reconstruct() const {
+    std::vector<std::pair<int, int>> path;
+    uint32_t node = goal_;
+    int x = layout_.x(node), y = layout_.y(node);
+    path.push_back({x - 1, y - 1});
+    while (node != start_) {
+        node = cells_[node].parent;
+        const int px = layout_.x(node), py = layout_.y(node);
+        const int dx = sign(px - x), dy = sign(py - y);
+        while (x != px || y != py) {
+            x += dx;
+            y += dy;
+            path.push_back({x - 1, y - 1});
+        }
+    }
+    std::reverse(path.begin(), path.end());
+    return path;
+}
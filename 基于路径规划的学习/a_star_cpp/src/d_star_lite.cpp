@@ -0,0 +1,251 @@
+#include "d_star_lite.h"
+
+#include <algorithm>
+#include <cmath>
+
+const uint32_t DStarLite::kNone;
+const DStarLite::Cost DStarLite::kInfinity;
+
+namespace {
+
+const double kSqrt2 = 1.4142135623730951;
+const int64_t kStraight = int64_t(1) << 24;
+const int64_t kDiagonal = 23726566;  // round(sqrt(2) * 2^24)
+
+// 定点的八方向距离;kStraight <= kDiagonal <= 2 * kStraight,满足三角不等式
+int64_t octile(int dx, int dy) {
+    dx = std::abs(dx);
+    dy = std::abs(dy);
+    const int lo = std::min(dx, dy), hi = std::max(dx, dy);
+    return (hi - lo) * kStraight + lo * kDiagonal;
+}
+
+}  // namespace
+
+DStarLite::DStarLite(int width, int height) : map_(width, height) {}
+
+DStarLite::DStarLite(const GridMap& map) : map_(map) {}
+
+void DStarLite::setDiagonal(bool diagonal) {
+    if (diagonal == diagonal_) return;
+    diagonal_ = diagonal;
+    // 代价变了,下次findPath重新初始化
+    initialized_ = false;
+}
+
+void DStarLite::setObstacle(int x, int y, bool isObstacle) {
+    if (!map_.isValid(x, y) || map_.isObstacle(x, y) == isObstacle) return;
+    map_.setObstacle(x, y, isObstacle);
+    if (initialized_) changes_.push_back(layout_.index(x + 1, y + 1));
+}
+
+void DStarLite::moveStart(int x, int y) {
+    if (initialized_ && map_.isValid(x, y)) start_ = layout_.index(x + 1, y + 1);
+}
+
+void DStarLite::initialize(int startX, int startY, int goalX, int goalY) {
+    initialized_ = layout_.reset(map_.stride(), map_.height() + 2);
+    if (!initialized_) return;
+    cells_.resize(layout_.size());
+    cells_.clear();
+    heap_.clear();
+    heap_.position().cells = cells_.data();
+    changes_.clear();
+    km_ = 0;
+    start_ = last_ = layout_.index(startX + 1, startY + 1);
+    goal_ = layout_.index(goalX + 1, goalY + 1);
+    cell(goal_).rhs = 0;
+    heap_.push(goal_, calculateKey(goal_));
+}
+
+int DStarLite::neighbours(uint32_t node, uint32_t* nodes, Cost* costs) const {
+    const int x = layout_.x(node), y = layout_.y(node);
+    const uint32_t s = map_.stride();
+    const uint32_t id = y * s + x;
+    if (map_.blocked(id)) return 0;
+    const bool e = !map_.blocked(id + 1), w = !map_.blocked(id - 1);
+    const bool n = !map_.blocked(id - s), so = !map_.blocked(id + s);
+    int count = 0;
+    auto add = [&](int nx, int ny, Cost cost) {
+        nodes[count] = layout_.index(nx, ny);
+        costs[count] = cost;
+        count++;
+    };
+    if (e) add(x + 1, y, kStraight);
+    if (w) add(x - 1, y, kStraight);
+    if (n) add(x, y - 1, kStraight);
+    if (so) add(x, y + 1, kStraight);
+    if (!diagonal_) return count;
+    if (n && e && !map_.blocked(id - s + 1)) add(x + 1, y - 1, kDiagonal);
+    if (n && w && !map_.blocked(id - s - 1)) add(x - 1, y - 1, kDiagonal);
+    if (so && e && !map_.blocked(id + s + 1)) add(x + 1, y + 1, kDiagonal);
+    if (so && w && !map_.blocked(id + s - 1)) add(x - 1, y + 1, kDiagonal);
+    return count;
+}
+
+DStarLite::Cost DStarLite::distance(uint32_t a, uint32_t b) const {
+    const int dx = layout_.x(a) - layout_.x(b);
+    const int dy = layout_.y(a) - layout_.y(b);
+    if (diagonal_) return octile(dx, dy);
+    return (std::abs(dx) + std::abs(dy)) * kStraight;
+}
+
+DStarLite::Key DStarLite::calculateKey(uint32_t node) {
+    const Cell& c = cell(node);
+    const Cost m = std::min(c.g, c.rhs);
+    return {m + distance(node, start_) + km_, m};
+}
+
+void DStarLite::updateVertex(uint32_t node) {
+    Cell& c = cell(node);
+    const bool queued = c.heapIndex != kNone;
+    if (c.g != c.rhs) {
+        if (queued) {
+            heap_.update(node, calculateKey(node));
+        } else {
+            heap_.push(node, calculateKey(node));
+            stats_.pushed++;
+        }
+    } else if (queued) {
+        heap_.remove(node);
+    }
+}
+
+DStarLite::Cost DStarLite::bestRhs(uint32_t node) {
+    uint32_t nodes[8];
+    Cost costs[8];
+    const int count = neighbours(node, nodes, costs);
+    Cost best = kInfinity;
+    for (int i = 0; i < count; i++) best = std::min(best, costs[i] + cell(nodes[i]).g);
+    return best;
+}
+
+// 变化格子本身及其8邻域的出边代价都可能改变(斜行受两侧格子影响),重算它们的rhs
+void DStarLite::applyChanges() {
+    if (changes_.empty()) return;
+    std::vector<uint32_t> affected;
+    affected.reserve(changes_.size() * 9);
+    for (uint32_t node : changes_) {
+        const int x = layout_.x(node), y = layout_.y(node);
+        for (int dy = -1; dy <= 1; dy++)
+            for (int dx = -1; dx <= 1; dx++) {
+                const int nx = x + dx, ny = y + dy;
+                // 边框格子不会是任何格子的后继
+                if (nx < 1 || ny < 1 || nx > map_.width() || ny > map_.height()) continue;
+                affected.push_back(layout_.index(nx, ny));
+            }
+    }
+    changes_.clear();
+    std::sort(affected.begin(), affected.end());
+    affected.erase(std::unique(affected.begin(), affected.end()), affected.end());
+    for (uint32_t node : affected) {
+        if (node != goal_) cell(node).rhs = bestRhs(node);
+        updateVertex(node);
+    }
+    stats_.touched = affected.size();
+}
+
+void DStarLite::computeShortestPath() {
+    uint32_t nodes[8];
+    Cost costs[8];
+    while (!heap_.empty()) {
+        const Cell& start = cell(start_);
+        if (!(heap_.topKey() < calculateKey(start_)) && !(start.rhs > start.g)) break;
+
+        const uint32_t u = heap_.top();
+        const Key oldKey = heap_.topKey();
+        const Key newKey = calculateKey(u);
+        stats_.expanded++;
+        Cell& cu = cell(u);
+        if (oldKey < newKey) {
+            heap_.update(u, newKey);
+        } else if (cu.g > cu.rhs) {
+            // 过一致: g降到rhs,邻居可能经u变短
+            cu.g = cu.rhs;
+            heap_.remove(u);
+            const int count = neighbours(u, nodes, costs);
+            for (int i = 0; i < count; i++) {
+                const uint32_t s = nodes[i];
+                if (s != goal_) {
+                    Cell& cs = cell(s);
+                    cs.rhs = std::min(cs.rhs, costs[i] + cu.g);
+                }
+                updateVertex(s);
+            }
+        } else {
+            // 欠一致: g置为无穷,原先经u的邻居重算rhs
+            const Cost oldG = cu.g;
+            cu.g = kInfinity;
+            const int count = neighbours(u, nodes, costs);
+            for (int i = 0; i < count; i++) {
+                const uint32_t s = nodes[i];
+                if (s != goal_ && cell(s).rhs == costs[i] + oldG) cell(s).rhs = bestRhs(s);
+                updateVertex(s);
+            }
+            if (u != goal_) cu.rhs = bestRhs(u);
+            updateVertex(u);
+        }
+    }
+}
+
+// 从起点沿 c + g 最小的邻居走到终点.
+// 搜索结束时起点可能仍是过一致的(g为无穷),但rhs(起点)已是最短距离
+std::vector<std::pair<int, int>> DStarLite::extractPath() {
+    std::vector<std::pair<int, int>> path;
+    const int sx = layout_.x(start_) - 1, sy = layout_.y(start_) - 1;
+    const int gx = layout_.x(goal_) - 1, gy = layout_.y(goal_) - 1;
+    if (map_.isObstacle(sx, sy) || map_.isObstacle(gx, gy) || cell(start_).rhs >= kInfinity)
+        return path;
+
+    uint32_t nodes[8];
+    Cost costs[8];
+    uint32_t node = start_;
+    double cost = 0;
+    path.push_back({sx, sy});
+    const size_t limit = static_cast<size_t>(map_.width()) * map_.height();
+    while (node != goal_) {
+        const int count = neighbours(node, nodes, costs);
+        int best = -1;
+        Cost bestValue = kInfinity;
+        for (int i = 0; i < count; i++) {
+            const Cost value = costs[i] + cell(nodes[i]).g;
+            if (value < bestValue) {
+                bestValue = value;
+                best = i;
+            }
+        }
+        if (best < 0 || path.size() > limit) return {};
+        node = nodes[best];
+        cost += costs[best] == kStraight ? 1.0 : kSqrt2;
+        path.push_back({layout_.x(node) - 1, layout_.y(node) - 1});
+    }
+    stats_.cost = cost;
+    return path;
+}
+
+std::vector<std::pair<int, int>> DStarLite::replan() {
+    stats_ = SearchStats();
+    if (!initialized_) return {};
+    // 起点移动后堆中的键都偏大了同一个上界,累加到km而不重排
+    km_ += distance(last_, start_);
+    last_ = start_;
+    applyChanges();
+    // 起点或终点被占时rhs(起点)恒为无穷,搜索会铺满整个连通域,直接返回
+    if (map_.blocked(map_.id(layout_.x(start_) - 1, layout_.y(start_) - 1)) ||
+        map_.blocked(map_.id(layout_.x(goal_) - 1, layout_.y(goal_) - 1)))
+        return {};
+    computeShortestPath();
+    return extractPath();
+}
+
+std::vector<std::pair<int, int>> DStarLite::findPath(int startX, int startY, int goalX,
+                                                     int goalY) {
+    if (!map_.isValid(startX, startY) || !map_.isValid(goalX, goalY)) return {};
+    if (!initialized_ || layout_.index(goalX + 1, goalY + 1) != goal_) {
+        initialize(startX, startY, goalX, goalY);
+        if (!initialized_) return {};
+    } else {
+        start_ = layout_.index(startX + 1, startY + 1);
+    }
+    return replan();
+}
@@ -0,0 +1,169 @@
+#include "grid_map.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+void BitPlane::reset(uint32_t stride, uint32_t lines) {
+    stride_ = stride;
+    const uint64_t bits = static_cast<uint64_t>(stride) * lines;
+    bits_.assign((kPadBits + bits + 128) / 64 + 1, ~uint64_t(0));
+}
+
+void BitPlane::clearRange(uint32_t line, uint32_t begin, uint32_t end) {
+    uint64_t bit = static_cast<uint64_t>(line) * stride_ + begin + kPadBits;
+    const uint64_t last = bit + (end - begin);
+    while (bit < last && (bit & 63)) {
+        bits_[bit >> 6] &= ~(uint64_t(1) << (bit & 63));
+        bit++;
+    }
+    for (; bit + 64 <= last; bit += 64) bits_[bit >> 6] = 0;
+    for (; bit < last; bit++) bits_[bit >> 6] &= ~(uint64_t(1) << (bit & 63));
+}
+
+GridMap::GridMap(int width, int height) {
+    resize(width, height);
+}
+
+void GridMap::resize(int width, int height) {
+    width = width > 0 ? width : 0;
+    height = height > 0 ? height : 0;
+    const uint64_t cells = (static_cast<uint64_t>(width) + 2) * (static_cast<uint64_t>(height) + 2);
+    if (cells >= 0xFFFFFFFFull) width = height = 0;
+
+    width_ = width;
+    height_ = height;
+    stride_ = width_ + 2;
+    cellCount_ = static_cast<uint32_t>(stride_) * (height_ + 2);
+
+    // 先全部置为障碍,再清出内部
+    rows_.reset(stride_, height_ + 2);
+    for (int y = 1; y <= height_; y++) rows_.clearRange(y, 1, width_ + 1);
+    columns_.reset(height_ + 2, stride_);
+    for (int x = 1; x <= width_; x++) columns_.clearRange(x, 1, height_ + 1);
+}
+
+void GridMap::setObstacle(int x, int y, bool obstacle) {
+    if (!isValid(x, y)) return;
+    rows_.set(id(x, y), obstacle);
+    columns_.set(static_cast<uint32_t>(x + 1) * (height_ + 2) + (y + 1), obstacle);
+}
+
+size_t GridMap::obstacleCount() const {
+    size_t count = 0;
+    for (int y = 0; y < height_; y++)
+        for (int x = 0; x < width_; x++) count += blocked(id(x, y));
+    return count;
+}
+
+namespace {
+
+bool isObstacleChar(char c) {
+    return c == '#' || c == '1' || c == '@' || c == 'T' || c == 'O' || c == 'W';
+}
+
+void trimLineEnd(std::string& line) {
+    while (!line.empty() && (line.back() == '\r' || line.back() == '\n')) line.pop_back();
+}
+
+}  // namespace
+
+bool GridMap::load(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        errorString_ = "cannot open " + path;
+        return false;
+    }
+
+    std::string line;
+    std::vector<std::string> rows;
+    int width = -1, height = -1;
+    if (!std::getline(in, line)) {
+        errorString_ = "empty map file " + path;
+        return false;
+    }
+    trimLineEnd(line);
+
+    if (line.compare(0, 4, "type") == 0) {
+        // MovingAI: height/width 行,直到 "map"
+        while (std::getline(in, line)) {
+            trimLineEnd(line);
+            if (line == "map") break;
+            std::istringstream fields(line);
+            std::string key;
+            int value = 0;
+            fields >> key >> value;
+            if (key == "height") height = value;
+            else if (key == "width") width = value;
+        }
+        if (width <= 0 || height <= 0) {
+            errorString_ = "bad MovingAI header in " + path;
+            return false;
+        }
+    } else {
+        // "宽 高" 首行可选
+        std::istringstream fields(line);
+        int w = 0, h = 0;
+        std::string rest;
+        if (fields >> w >> h && !(fields >> rest) && w > 0 && h > 0) {
+            width = w;
+            height = h;
+        } else {
+            rows.push_back(line);
+        }
+    }
+
+    while (std::getline(in, line)) {
+        trimLineEnd(line);
+        if (line.empty() && height < 0) continue;
+        rows.push_back(line);
+        if (height > 0 && static_cast<int>(rows.size()) == height) break;
+    }
+    if (height < 0) {
+        height = static_cast<int>(rows.size());
+        width = 0;
+        for (const std::string& row : rows)
+            width = std::max(width, static_cast<int>(row.size()));
+    }
+    if (width <= 0 || height <= 0) {
+        errorString_ = "no map rows in " + path;
+        return false;
+    }
+    if (static_cast<int>(rows.size()) < height) {
+        errorString_ = "map " + path + " has " + std::to_string(rows.size()) +
+                       " rows, expected " + std::to_string(height);
+        return false;
+    }
+
+    resize(width, height);
+    if (width_ != width) {
+        errorString_ = "map " + path + " is too large";
+        return false;
+    }
+    for (int y = 0; y < height; y++) {
+        const std::string& row = rows[y];
+        const int n = std::min(width, static_cast<int>(row.size()));
+        for (int x = 0; x < n; x++)
+            if (isObstacleChar(row[x])) setObstacle(x, y, true);
+    }
+    errorString_.clear();
+    return true;
+}
+
+bool GridMap::save(const std::string& path) const {
+    FILE* fp = std::fopen(path.c_str(), "w");
+    if (!fp) {
+        errorString_ = "cannot write " + path;
+        return false;
+    }
+    std::fprintf(fp, "%d %d\n", width_, height_);
+    std::string row(width_ + 1, '\n');
+    for (int y = 0; y < height_; y++) {
+        for (int x = 0; x < width_; x++) row[x] = blocked(id(x, y)) ? '#' : '.';
+        std::fwrite(row.data(), 1, row.size(), fp);
+    }
+    const bool ok = std::fclose(fp) == 0;
+    if (!ok) errorString_ = "cannot write " + path;
+    return ok;
+}
@@ -0,0 +1,73 @@
+#include "a_star.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+// 用法: a_star_demo [地图文件 起点x 起点y 终点x 终点y] [--jps] [--four]
+// 不带地图时使用内置的10x10示例
+int main(int argc, char* argv[]) {
+    bool jps = false, four = false;
+    int positional = 0;
+    const char* args[5] = {};
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--jps") == 0) jps = true;
+        else if (std::strcmp(argv[i], "--four") == 0) four = true;
+        else if (positional < 5) args[positional++] = argv[i];
+    }
+
+    // 创建一个10x10的地图
+    AStar astar(10, 10);
+    int startX = 0, startY = 0, goalX = 9, goalY = 9;
+    if (positional == 0) {
+        // 设置一些障碍物
+        for (int i = 2; i < 8; i++) {
+            astar.setObstacle(i, 5, true);
+        }
+    } else {
+        if (!astar.map().load(args[0])) {
+            std::cerr << astar.map().errorString() << std::endl;
+            return 1;
+        }
+        startX = 0;
+        startY = 0;
+        goalX = astar.map().width() - 1;
+        goalY = astar.map().height() - 1;
+        if (positional == 5) {
+            startX = std::atoi(args[1]);
+            startY = std::atoi(args[2]);
+            goalX = std::atoi(args[3]);
+            goalY = std::atoi(args[4]);
+        }
+    }
+    astar.setDiagonal(!four);
+    astar.setSearchMode(jps ? SearchMode::JumpPoint : SearchMode::AStar);
+
+    // 寻找从起点到终点的路径
+    auto path = astar.findPath(startX, startY, goalX, goalY);
+
+    if (!path.empty()) {
+        std::cout << "找到路径！代价 " << astar.stats().cost << ", 扩展 "
+                  << astar.stats().expanded << " 个节点" << std::endl;
+        for (const auto& point : path) {
+            std::cout << "(" << point.first << ", " << point.second << ")" << std::endl;
+        }
+    } else {
+        std::cout << "未找到路径！" << std::endl;
+    }
+
+    // 小地图画出来: '#'障碍, '*'路径
+    const GridMap& map = astar.map();
+    if (map.width() <= 80 && map.height() <= 40) {
+        std::string canvas;
+        for (int y = 0; y < map.height(); y++) {
+            for (int x = 0; x < map.width(); x++) canvas += map.isObstacle(x, y) ? '#' : '.';
+            canvas += '\n';
+        }
+        for (const auto& point : path) canvas[point.second * (map.width() + 1) + point.first] = '*';
+        std::cout << canvas;
+    }
+
+    return 0;
+}